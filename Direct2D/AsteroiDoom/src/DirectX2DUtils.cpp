@@ -1,25 +1,31 @@
 #include "DirectX2DUtils.h"
 
+#include "utils/Random.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <memory>
 #include <stdexcept>
 #include <string>
 
 using namespace D2D1;
 
+namespace {
+	// The overlay averages and graphs about a second of frames.
+	const size_t ProfilerOverlayFrames = 60;
+} // namespace
+
 DirectX2DHelper::DirectX2DHelper() = default;
 
-DirectX2DHelper::DirectX2DHelper(HWND hwnd) :
+DirectX2DHelper::DirectX2DHelper(HWND hwnd, std::wstring_view commandLine) :
     hwnd(hwnd),
-    spaceship(std::make_shared<Spaceship>(
-        SpaceshipSize,
-        MovementData(),
-        SpaceshipBitmapSegment,
-        SpaceshipHitPoints,
-        ThrusterData(SpaceshipDeceleration, SpaceshipThrust, SpaceshipTorque),
-        SpaceshipGunOffset,
-        SpaceshipGunCooldown,
-        ProjectileBitmapSegment
-    )),
-    arena(ArenaWidth, ArenaHeight, SpawnAreaMargin, spaceship) {
+    game(
+        GameSprites{
+            SpaceshipBitmapSegment, ProjectileBitmapSegment, {AsteroidBitmapSegments[0], AsteroidBitmapSegments[1]}},
+        // Seeded once the command line says whether to replay.
+        0
+    ) {
 	if (CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED) != S_OK ||
 	    CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&WICFactory)) != S_OK ||
 	    D2D1CreateFactory(D2D1_FACTORY_TYPE_SINGLE_THREADED, &D2DFactory) != S_OK ||
@@ -36,16 +42,47 @@ DirectX2DHelper::DirectX2DHelper(HWND hwnd) :
 	new (&ProjectileBitmap) BitmapHelper(WICFactory, target, ProjectilePath);
 	new (&AsteroidBitmaps[0]) BitmapHelper(WICFactory, target, Asteroid20Path);
 	new (&AsteroidBitmaps[1]) BitmapHelper(WICFactory, target, Asteroid30Path);
+	drawSubmitter.reloadTarget(target);
+
+	// Objects collide where the opaque pixels of the sprites drawn touch.
+	auto collisionMasks = std::make_shared<CollisionMaskSet>();
+	collisionMasks->add(SpaceshipBitmapSegment, SpaceshipBitmap.copyPixels());
+	collisionMasks->add(ProjectileBitmapSegment, ProjectileBitmap.copyPixels());
+	for (int type = 0; type < 2; type++) {
+		collisionMasks->add(AsteroidBitmapSegments[type], AsteroidBitmaps[type].copyPixels());
+	}
+	game.setCollisionMasks(std::move(collisionMasks));
 
 	ScoreText =
 	    TextHelper(25, L"Courier New", {-ArenaWidth / 2, ArenaHeight / 2 - 50, ArenaWidth / 2, ArenaHeight / 2}, target);
 	HealthText =
 	    TextHelper(25, L"Courier New", {-ArenaWidth / 2, ArenaHeight / 2 - 25, ArenaWidth / 2, ArenaHeight / 2}, target);
-}
+	ProjectilesText =
+	    TextHelper(25, L"Courier New", {-ArenaWidth / 2, ArenaHeight / 2 - 75, ArenaWidth / 2, ArenaHeight / 2}, target);
+	ProfilerText = TextHelper(
+	    16, L"Courier New", {-ArenaWidth / 2 + 10, -ArenaHeight / 2 + 10, ArenaWidth / 2, ArenaHeight / 2}, target
+	);
 
-unsigned int DirectX2DHelper::randomAsteroidType() {
-	static std::uniform_int_distribution<std::mt19937::result_type> dist(0, numOfAsteroidTypes - 1);
-	return dist(rng);
+	const std::wstring_view recordOption = L"--record ", replayOption = L"--replay ";
+	if (commandLine.starts_with(replayOption)) {
+		std::ifstream file(std::filesystem::path(commandLine.substr(replayOption.size())), std::ios::binary);
+		if (!file) {
+			throw std::runtime_error("Failed to open input log.");
+		}
+		inputLog = InputLog(file);
+		if (inputLog.getStepMillis() != SimulationStepMillis) {
+			throw std::runtime_error("The input log was recorded with a different simulation step.");
+		}
+		replaying = true;
+		game.seed(inputLog.getSeed());
+	} else {
+		if (commandLine.starts_with(recordOption)) {
+			recordPath = commandLine.substr(recordOption.size());
+		}
+		uint64_t seed = Random::randomSeed();
+		game.seed(seed);
+		inputLog = InputLog(seed, SimulationStepMillis);
+	}
 }
 
 void DirectX2DHelper::reloadTarget(HWND newHwnd) {
@@ -67,9 +104,12 @@ void DirectX2DHelper::reloadTarget(HWND newHwnd) {
 	for (auto & asteroidBitmap : AsteroidBitmaps) {
 		asteroidBitmap.reloadBitmap(target);
 	}
+	drawSubmitter.reloadTarget(target);
 
 	ScoreText.reloadBrush(target);
 	HealthText.reloadBrush(target);
+	ProjectilesText.reloadBrush(target);
+	ProfilerText.reloadBrush(target);
 }
 
 void DirectX2DHelper::reloadTarget() {
@@ -77,15 +117,67 @@ void DirectX2DHelper::reloadTarget() {
 }
 
 void DirectX2DHelper::nextFrame() {
-	const static unsigned long long startTimestamp = GetTickCount64();
-	static unsigned long long previousTimestamp = startTimestamp;
-	static unsigned long long previousAsteroidSpawnTimestamp = startTimestamp;
-	unsigned long long timestamp = GetTickCount64();
-	unsigned long long timestampDiff = timestamp - previousTimestamp;
+	auto timestamp = std::chrono::steady_clock::now();
+	accumulatedMillis += std::chrono::duration<double, std::milli>(timestamp - previousTimestamp).count();
 	previousTimestamp = timestamp;
 
-	static unsigned long long score = 0;
-	static bool gameOver = false;
+// SIMULATION
+	if (!gameOver && !replaying && (GetAsyncKeyState(VK_BACK) & 0x8000) && !rewind.empty()) {
+		// Scrub through the last seconds a frame at a time, backwards, or forwards again while Shift is held too.
+		if (!rewinding) {
+			rewinding = true;
+			rewindPosition = rewind.size() - 1;
+		}
+		if (GetAsyncKeyState(VK_SHIFT) & 0x8000) {
+			rewindPosition = std::min<size_t>(rewindPosition + 1, rewind.size() - 1);
+		} else if (rewindPosition > 0) {
+			rewindPosition--;
+		}
+		restoreSnapshot(rewindPosition);
+		accumulatedMillis = 0;
+	} else if (!gameOver) {
+		if (rewinding) {
+			// Carry on from the rewound frame, forgetting what came after it.
+			rewinding = false;
+			rewind.truncate(rewindPosition + 1);
+			inputLog.truncate(tick);
+		}
+		unsigned long long firstTick = tick;
+		InputState polledInput = InputState::poll();
+		for (unsigned int steps = 0; accumulatedMillis >= SimulationStepMillis && !game.isOver(); steps++) {
+			if (steps == MaxSimulationStepsPerFrame) {
+				// Drop the backlog, so that a slow frame does not make the following ones even slower.
+				accumulatedMillis = std::fmod(accumulatedMillis, SimulationStepMillis);
+				break;
+			}
+			if (replaying && tick == inputLog.getTickCount()) {
+				DestroyWindow(hwnd);
+				return;
+			}
+			InputState input = replaying ? inputLog.at(tick) : polledInput;
+			if (!replaying) {
+				inputLog.record(input);
+			}
+			{
+				ASTEROIDOOM_PROFILE(profiler, ProfilePhase::Move);
+				game.move(SimulationStepMillis, input);
+			}
+			{
+				ASTEROIDOOM_PROFILE(profiler, ProfilePhase::Spawn);
+				game.spawn(input);
+			}
+			{
+				ASTEROIDOOM_PROFILE(profiler, ProfilePhase::Collisions);
+				game.checkCollisions();
+			}
+			ASTEROIDOOM_PROFILE_COLLISION_PAIRS(profiler, game.getArena().getCollisionPairCount());
+			tick++;
+			accumulatedMillis -= SimulationStepMillis;
+		}
+		if (!replaying && tick != firstTick) {
+			saveSnapshot();
+		}
+	}
 
 // DRAWING
 drawing:
@@ -93,64 +185,131 @@ drawing:
 	target->Clear(ColorF(ColorF::Black));
 
 	if (!gameOver) {
-		// Draw arena with logic handling
+		// Draw arena between the last two simulated states
 		target->SetTransform(ArenaTranslation);
 
-		arena.move(timestampDiff);
-		if (GetAsyncKeyState(VK_SPACE)) {
-			arena.addProjectile(spaceship->shoot(timestamp));
+		// The steps stop early when the game is over, which leaves more than a step accumulated.
+		double alpha = accumulatedMillis < SimulationStepMillis ? accumulatedMillis / SimulationStepMillis : 1;
+		{
+			ASTEROIDOOM_PROFILE(profiler, ProfilePhase::Draw);
+			drawCommands.clear();
+			game.draw(drawCommands, float(alpha));
+			drawCommands.sortByBitmap();
 		}
-		if (timestamp - previousAsteroidSpawnTimestamp > AsteroidSpawnDelay) {
-			unsigned int asteroidType = randomAsteroidType();
-			arena.spawnAsteroid(
-			    asteroidSizes[asteroidType],
-			    AsteroidBitmapSegments[asteroidType],
-			    asteroidHealth[asteroidType],
-			    asteroidHealth[asteroidType]
-			);
-			previousAsteroidSpawnTimestamp = timestamp;
+		{
+			ASTEROIDOOM_PROFILE(profiler, ProfilePhase::Submit);
+			drawSubmitter.submit(drawCommands);
 		}
-		arena.draw();
-		score += arena.checkCollisions();
-
-		// Write score and HP
-		std::wstring scoreTextContent = L"SCORE: ";
-		scoreTextContent += std::to_wstring(score);
-		std::wstring healthTextContent = L"HEALTH: ";
-		healthTextContent += std::to_wstring(spaceship->getHitPoints());
-		ScoreText.draw(scoreTextContent.c_str(), scoreTextContent.size());
-		HealthText.draw(healthTextContent.c_str(), healthTextContent.size());
-
-		// Handling game over
-		if (spaceship->destroyed()) {
-			gameOver = true;
-			wchar_t message[1024];
-			swprintf(message, 1024, L"Your score is %llu.", score);
-			int decision = MessageBox(target->GetHwnd(), message, L"Game over!", MB_RETRYCANCEL | MB_ICONEXCLAMATION);
-			if (decision == IDRETRY) {
-				score = 0;
-				spaceship = std::make_shared<Spaceship>(
-				    SpaceshipSize,
-				    MovementData(),
-				    SpaceshipBitmapSegment,
-				    SpaceshipHitPoints,
-				    ThrusterData(SpaceshipDeceleration, SpaceshipThrust, SpaceshipTorque),
-				    SpaceshipGunOffset,
-				    SpaceshipGunCooldown,
-				    ProjectileBitmapSegment
-				);
-				arena = Arena(ArenaWidth, ArenaHeight, SpawnAreaMargin, spaceship);
-				gameOver = false;
-			} else {
-				DestroyWindow(target->GetHwnd());
+		ASTEROIDOOM_PROFILE_DRAW_COMMANDS(profiler, drawCommands.size());
+
+		ASTEROIDOOM_PROFILE(profiler, ProfilePhase::Text);
+		// Write score, HP and projectile counts, laid out again only when they change
+		hud.update(game);
+		ScoreText.draw(hud.getScore());
+		HealthText.draw(hud.getHealth());
+		ProjectilesText.draw(hud.getProjectiles());
+
+		if (showProfiler) {
+			wchar_t overlay[1024];
+			size_t length = formatProfilerOverlay(profiler, ProfilerOverlayFrames, overlay, 1024);
+			// As many layouts as texts formatted shows that layouts are only built when the HUD changes.
+			unsigned long long layouts =
+			    ScoreText.getLayoutCount() + HealthText.getLayoutCount() + ProjectilesText.getLayoutCount();
+			int written = swprintf(
+			    overlay + length,
+			    1024 - length,
+			    L"\nHUD %llu TEXTS FORMATTED, %llu LAYOUTS BUILT\nSPRITES SUBMITTED %ls (F4)",
+			    hud.getFormatCount(),
+			    layouts,
+			    drawSubmitter.usesSpriteBatch() ? L"IN BATCHES" : L"ONE BY ONE"
+			);
+			if (written > 0) {
+				length += size_t(written);
 			}
+			ProfilerText.draw(overlay, (unsigned int)length, ColorF(ColorF::Yellow));
 		}
 	}
 
-	if (target->EndDraw() == D2DERR_RECREATE_TARGET) {
+	HRESULT presented;
+	{
+		ASTEROIDOOM_PROFILE(profiler, ProfilePhase::Present);
+		presented = target->EndDraw();
+	}
+	if (presented == D2DERR_RECREATE_TARGET) {
 		reloadTarget();
 		goto drawing;
 	}
+	ASTEROIDOOM_PROFILE_END_FRAME(profiler);
+
+	// Handling game over
+	if (!gameOver && game.isOver() && replaying) {
+		// The recorded session went on, so the player must have retried.
+		game.reset();
+	} else if (!gameOver && game.isOver()) {
+		gameOver = true;
+		wchar_t message[1024];
+		swprintf(message, 1024, L"Your score is %llu.", game.getScore());
+		int decision = MessageBox(target->GetHwnd(), message, L"Game over!", MB_RETRYCANCEL | MB_ICONEXCLAMATION);
+		if (decision == IDRETRY) {
+			game.reset();
+			rewind.clear();
+			gameOver = false;
+			// Do not simulate the time spent in the message box.
+			previousTimestamp = std::chrono::steady_clock::now();
+			accumulatedMillis = 0;
+		} else {
+			DestroyWindow(target->GetHwnd());
+		}
+	}
+}
+
+void DirectX2DHelper::saveSnapshot() {
+	SnapshotWriter writer(snapshot);
+	game.save(writer);
+	writer.write(tick);
+	rewind.push(snapshot);
+}
+
+void DirectX2DHelper::restoreSnapshot(size_t index) {
+	SnapshotReader reader(rewind.at(index));
+	game.restore(reader);
+	reader.read(tick);
+}
+
+void DirectX2DHelper::saveRecording() const {
+	if (recordPath.empty()) {
+		return;
+	}
+	std::ofstream file(recordPath, std::ios::binary);
+	inputLog.write(file);
+	if (!file) {
+		throw std::runtime_error("Failed to write input log.");
+	}
+}
+
+void DirectX2DHelper::toggleProfilerOverlay() {
+#if defined(ASTEROIDOOM_PROFILER)
+	showProfiler = !showProfiler;
+	InvalidateRect(hwnd, nullptr, false);
+#endif
+}
+
+void DirectX2DHelper::toggleSpriteBatch() {
+#if defined(ASTEROIDOOM_PROFILER)
+	spriteBatchEnabled = !spriteBatchEnabled;
+	drawSubmitter.setSpriteBatchEnabled(spriteBatchEnabled);
+	InvalidateRect(hwnd, nullptr, false);
+#endif
+}
+
+void DirectX2DHelper::saveProfile() const {
+#if defined(ASTEROIDOOM_PROFILER)
+	std::ofstream file{std::filesystem::path(ProfilePath)};
+	profiler.writeCsv(file);
+	if (!file) {
+		throw std::runtime_error("Failed to write profile.");
+	}
+#endif
 }
 
 DirectX2DHelper::~DirectX2DHelper() {
@@ -2,15 +2,21 @@
 
 #define WIN32_LEAN_AND_MEAN
 
-#include "collidable/Arena.h"
+#include "Game.h"
+#include "Hud.h"
 #include "utils/AsteroiDoomConstants.h"
+#include "utils/InputLog.h"
+#include "utils/Profiler.h"
+#include "utils/RewindBuffer.h"
 #include "utils/TextUtils.h"
 
+#include <chrono>
 #include <d2d1_3.h>
-#include <memory>
+#include <filesystem>
 #include <numbers>
+#include <string_view>
+#include <vector>
 #include <wincodec.h>
-#include <random>
 
 class DirectX2DHelper {
 	HWND hwnd{};
@@ -24,26 +30,55 @@ class DirectX2DHelper {
 	BitmapHelper AsteroidBitmaps[2]{};
 	const BitmapSegment SpaceshipBitmapSegment{&SpaceshipBitmap, {0, 0, 60, 60}};
 	const BitmapSegment ProjectileBitmapSegment{&ProjectileBitmap, {0, 0, 10, 10}};
-	static const unsigned int numOfAsteroidTypes = 2;
-	const BitmapSegment AsteroidBitmapSegments[numOfAsteroidTypes]{
+	const BitmapSegment AsteroidBitmapSegments[2]{
 	    {&AsteroidBitmaps[0], {0, 0, 40, 40}}, {&AsteroidBitmaps[1], {0, 0, 60, 60}}};
-	static constexpr float asteroidSizes[numOfAsteroidTypes]{20, 30};
-	static constexpr unsigned int asteroidHealth[numOfAsteroidTypes]{50, 150};
 
 	TextHelper ScoreText{};
 	TextHelper HealthText{};
+	TextHelper ProjectilesText{};
+	Hud hud{};
 
-	std::shared_ptr<Spaceship> spaceship{};
+	Game game{};
 
-	Arena arena;
+	// The sprites of the frame, recorded and sorted by bitmap before they are submitted.
+	DrawCommandList drawCommands{};
+	TargetDrawSubmitter drawSubmitter{};
 
-	std::mt19937 rng{std::random_device{}()};
+	std::chrono::steady_clock::time_point previousTimestamp{std::chrono::steady_clock::now()};
+	// Real time not simulated yet, less than a step unless the simulation is catching up.
+	double accumulatedMillis{};
+
+	// The input of every step so far, or of every step to come when replaying.
+	InputLog inputLog{};
+	bool replaying{};
+	unsigned long long tick{};
+	std::filesystem::path recordPath{};
+	bool gameOver{};
+
+	// Snapshots of recent frames, and while Backspace is held, the one shown.
+	RewindBuffer rewind{RewindKeyframes, RewindDeltasPerKeyframe};
+	std::vector<uint8_t> snapshot{};
+	size_t rewindPosition{};
+	bool rewinding{};
+
+	void saveSnapshot();
+
+	void restoreSnapshot(size_t index);
+
+	// Phase times of recent frames, recorded only when built with ASTEROIDOOM_PROFILER.
+	Profiler profiler{};
+	TextHelper ProfilerText{};
+	bool showProfiler{};
+	bool spriteBatchEnabled{true};
 
-	unsigned int randomAsteroidType();
 public:
 	DirectX2DHelper();
 
-	explicit DirectX2DHelper(HWND hwnd);
+	/**
+	 * @param commandLine either empty, "--record LOG" to save the input of the session to the given file on exit,
+	 * or "--replay LOG" to play a recorded session again
+	 */
+	explicit DirectX2DHelper(HWND hwnd, std::wstring_view commandLine = {});
 
 	~DirectX2DHelper();
 
@@ -52,4 +87,25 @@ public:
 	void reloadTarget();
 
 	void nextFrame();
+
+	/**
+	 * Writes the input log if recording was requested.
+	 */
+	void saveRecording() const;
+
+	/**
+	 * Shows or hides the overlay with the phase times of recent frames, if the profiler is compiled in.
+	 */
+	void toggleProfilerOverlay();
+
+	/**
+	 * Switches between submitting sprites in batches and one by one, if the profiler is compiled in, so that the
+	 * overlay can compare both. Targets without sprite batches always draw one by one.
+	 */
+	void toggleSpriteBatch();
+
+	/**
+	 * Writes the profiled frames to ProfilePath, if the profiler is compiled in.
+	 */
+	void saveProfile() const;
 };
\ No newline at end of file
@@ -0,0 +1,242 @@
+#include "Game.h"
+
+#include "utils/AsteroiDoomConstants.h"
+
+#include <stdexcept>
+#include <utility>
+
+namespace {
+	/**
+	 * @return the stream 2^64 numbers ahead of the given generator, like the one split keeps, which the numbers drawn
+	 * from the generator itself never reach
+	 */
+	Random jumpedFrom(Random random) {
+		random.jump();
+		return random;
+	}
+} // namespace
+
+Game::Game() = default;
+
+Game::Game(GameSprites sprites, uint64_t seed) :
+    sprites(sprites),
+    random(seed),
+    particles(ParticleCapacity, sprites.projectile),
+    particleRandom(jumpedFrom(random)) {
+	reset();
+}
+
+std::shared_ptr<Spaceship> Game::makeSpaceship(MovementData movement) const {
+	return std::make_shared<Spaceship>(
+	    SpaceshipSize,
+	    movement,
+	    sprites.spaceship,
+	    SpaceshipHitPoints,
+	    ThrusterData(SpaceshipDeceleration, SpaceshipThrust, SpaceshipTorque),
+	    SpaceshipGunOffset,
+	    SpaceshipGunCooldown,
+	    sprites.projectile
+	);
+}
+
+unsigned int Game::randomAsteroidType() {
+	return random.next(0, numOfAsteroidTypes);
+}
+
+void Game::reset() {
+	MovementData start{};
+	if (duel) {
+		// A quarter of the arena from either edge, facing each other.
+		start.location = {-ArenaWidth / 4, 0};
+		start.rotation = 90;
+	}
+	spaceship = makeSpaceship(start);
+	arena = Arena(ArenaWidth, ArenaHeight, SpawnAreaMargin, spaceship);
+	rival = nullptr;
+	if (duel) {
+		start.location = {ArenaWidth / 4, 0};
+		start.rotation = 270;
+		rival = makeSpaceship(start);
+		arena.setRival(rival);
+	}
+	arena.setParallelMoveThreshold(parallelMoveThreshold);
+	arena.setCollisionMasks(collisionMasks);
+	if (swarmSize > 0) {
+		// Every ship keeps at most one projectile alive per cooldown of its guns.
+		auto projectilesPerShip = size_t(ProjectileTimeToLive / SpaceshipGunCooldown) + 1;
+		arena.setProjectileCapacity(ProjectilePoolCapacity + swarmSize * projectilesPerShip);
+		Swarm swarm(
+		    swarmController,
+		    ThrusterData(SpaceshipDeceleration, SpaceshipThrust, SpaceshipTorque),
+		    SpaceshipGunOffset,
+		    SpaceshipGunCooldown,
+		    sprites.projectile
+		);
+		swarm.spawn(swarmSize, SpaceshipSize, sprites.spaceship, SpaceshipHitPoints, arena.getRectangle(), random);
+		arena.setSwarm(std::move(swarm));
+	}
+	particles.clear();
+	time = 0;
+	previousAsteroidSpawnTime = 0;
+	score = 0;
+}
+
+void Game::seed(uint64_t value) {
+	random.seed(value);
+	particleRandom = jumpedFrom(random);
+}
+
+void Game::setParallelMoveThreshold(size_t entityCount) {
+	parallelMoveThreshold = entityCount;
+	arena.setParallelMoveThreshold(entityCount);
+}
+
+void Game::setCollisionMasks(std::shared_ptr<const CollisionMaskSet> masks) {
+	collisionMasks = std::move(masks);
+	arena.setCollisionMasks(collisionMasks);
+}
+
+void Game::setSwarm(size_t shipCount, std::shared_ptr<const ShipController> controller) {
+	swarmSize = shipCount;
+	swarmController = std::move(controller);
+}
+
+void Game::setDuel(bool enabled) {
+	duel = enabled;
+}
+
+void Game::scatterAsteroids(size_t count) {
+	size_t counts[numOfAsteroidTypes]{};
+	for (size_t asteroid = 0; asteroid < count; asteroid++) {
+		counts[randomAsteroidType()]++;
+	}
+	for (unsigned int asteroidType = 0; asteroidType < numOfAsteroidTypes; asteroidType++) {
+		arena.scatterAsteroids(
+		    counts[asteroidType],
+		    asteroidSizes[asteroidType],
+		    sprites.asteroids[asteroidType],
+		    asteroidHealth[asteroidType],
+		    asteroidHealth[asteroidType],
+		    random
+		);
+	}
+}
+
+void Game::step(unsigned int millis, InputState input, InputState rivalInput) {
+	move(millis, input, rivalInput);
+	spawn(input, rivalInput);
+	checkCollisions();
+}
+
+void Game::move(unsigned int millis, InputState input, InputState rivalInput) {
+	time += millis;
+	spaceship->setInput(input);
+	if (rival) {
+		rival->setInput(rivalInput);
+	}
+	arena.move(millis);
+	// Particles are drawn once, not in every copy of the arena, and debris of outer asteroids starts in the spawn area,
+	// so they loop around it like outer asteroids instead of jumping to the opposite edge of the screen.
+	particles.move(millis, arena.getSpawnRectangle());
+}
+
+void Game::spawn(InputState input, InputState rivalInput) {
+	if (input.isPressed(Key::Shoot)) {
+		if (auto projectile = spaceship->shoot(time)) {
+			arena.addProjectile(*projectile);
+		}
+	}
+	if (rival && rivalInput.isPressed(Key::Shoot)) {
+		if (auto projectile = rival->shoot(time)) {
+			arena.addProjectile(*projectile);
+		}
+	}
+	if (input.isPressed(Key::Thrust)) {
+		particles.emitExhaust(spaceship->getMovement(), SpaceshipSize, particleRandom);
+	}
+	if (rival && rivalInput.isPressed(Key::Thrust)) {
+		particles.emitExhaust(rival->getMovement(), SpaceshipSize, particleRandom);
+	}
+	arena.shootSwarm(time);
+	if (time - previousAsteroidSpawnTime > AsteroidSpawnDelay) {
+		unsigned int asteroidType = randomAsteroidType();
+		arena.spawnAsteroid(
+		    asteroidSizes[asteroidType],
+		    sprites.asteroids[asteroidType],
+		    asteroidHealth[asteroidType],
+		    asteroidHealth[asteroidType],
+		    random
+		);
+		previousAsteroidSpawnTime = time;
+	}
+}
+
+void Game::checkCollisions() {
+	score += arena.checkCollisions();
+	for (const DestroyedAsteroid & asteroid : arena.getDestroyedAsteroids()) {
+		particles.emitExplosion(asteroid.location, asteroid.velocity, asteroid.size, particleRandom);
+	}
+}
+
+void Game::draw(DrawBackend & backend, float alpha) const {
+	arena.draw(backend, alpha);
+	particles.draw(backend, arena.getRectangle());
+}
+
+bool Game::isOver() const {
+	return spaceship->destroyed() || (rival && rival->destroyed());
+}
+
+unsigned long long Game::getTime() const {
+	return time;
+}
+
+unsigned long long Game::getScore() const {
+	return score;
+}
+
+const Spaceship & Game::getSpaceship() const {
+	return *spaceship;
+}
+
+const Spaceship * Game::getRival() const {
+	return rival.get();
+}
+
+const Arena & Game::getArena() const {
+	return arena;
+}
+
+const ParticleSystem & Game::getParticles() const {
+	return particles;
+}
+
+void Game::save(std::vector<uint8_t> & snapshot) const {
+	SnapshotWriter writer(snapshot);
+	save(writer);
+}
+
+void Game::save(SnapshotWriter & writer) const {
+	writer.write(time);
+	writer.write(previousAsteroidSpawnTime);
+	writer.write(score);
+	writer.write(random);
+	arena.save(writer);
+}
+
+void Game::restore(std::span<const uint8_t> snapshot) {
+	SnapshotReader reader(snapshot);
+	restore(reader);
+	if (!reader.atEnd()) {
+		throw std::runtime_error("The snapshot continues past the game.");
+	}
+}
+
+void Game::restore(SnapshotReader & reader) {
+	reader.read(time);
+	reader.read(previousAsteroidSpawnTime);
+	reader.read(score);
+	reader.read(random);
+	arena.restore(reader);
+	particles.clear();
+}
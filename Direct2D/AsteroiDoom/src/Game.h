@@ -0,0 +1,169 @@
+#pragma once
+
+#include "collidable/Arena.h"
+#include "collidable/ParticleSystem.h"
+#include "utils/DrawBackend.h"
+#include "utils/Input.h"
+#include "utils/Random.h"
+#include "utils/Snapshot.h"
+
+#include <memory>
+#include <span>
+#include <vector>
+
+struct GameSprites {
+	BitmapSegment spaceship{};
+	BitmapSegment projectile{};
+	BitmapSegment asteroids[2]{};
+};
+
+/**
+ * The rules of AsteroiDoom, independent of the window, the renderer and the real clock,
+ * so that it can also be simulated headless.
+ */
+class Game {
+	static const unsigned int numOfAsteroidTypes = 2;
+	static constexpr float asteroidSizes[numOfAsteroidTypes]{20, 30};
+	static constexpr unsigned int asteroidHealth[numOfAsteroidTypes]{50, 150};
+
+	GameSprites sprites{};
+
+	std::shared_ptr<Spaceship> spaceship{};
+	// The second player's spaceship in a duel, or nothing.
+	std::shared_ptr<Spaceship> rival{};
+	Arena arena{};
+
+	// Milliseconds of simulated time since the game started.
+	unsigned long long time{};
+	unsigned long long previousAsteroidSpawnTime{};
+	unsigned long long score{};
+
+	// Kept for the arenas of later games.
+	size_t parallelMoveThreshold{ParallelMoveThreshold};
+	std::shared_ptr<const CollisionMaskSet> collisionMasks{};
+	size_t swarmSize{};
+	std::shared_ptr<const ShipController> swarmController{};
+	bool duel{};
+
+	// Continues across games, so that a whole session is reproduced by its seed.
+	Random random{};
+
+	// Effects only: they draw from a generator of their own, a stream independent of the game's, and are left out of
+	// snapshots, so that they never change how the game goes.
+	ParticleSystem particles{};
+	Random particleRandom{};
+
+	[[nodiscard]] std::shared_ptr<Spaceship> makeSpaceship(MovementData movement) const;
+
+	unsigned int randomAsteroidType();
+
+public:
+	Game();
+
+	Game(GameSprites sprites, uint64_t seed);
+
+	/**
+	 * Starts a new game with a new spaceship and an empty arena.
+	 */
+	void reset();
+
+	/**
+	 * Restarts the random generators of the game and of its particles, so that the following games can be reproduced.
+	 */
+	void seed(uint64_t value);
+
+	/**
+	 * @see Arena::setParallelMoveThreshold
+	 */
+	void setParallelMoveThreshold(size_t entityCount);
+
+	/**
+	 * Makes objects of this and later games collide only where the opaque pixels of their sprites do, given the masks
+	 * of the sprites, or as circles again given nullptr.
+	 * @see Arena::setCollisionMasks
+	 */
+	void setCollisionMasks(std::shared_ptr<const CollisionMaskSet> masks);
+
+	/**
+	 * Fills the arena of this and later games with the given number of ships, all steered by the controller and
+	 * fighting alongside the player's spaceship. Takes effect from the next reset.
+	 */
+	void setSwarm(size_t shipCount, std::shared_ptr<const ShipController> controller);
+
+	/**
+	 * Makes this and later games duels of two spaceships, which start on opposite sides of the arena facing each
+	 * other, the second one steered by the rival input of every step. A duel is over when either ship is destroyed.
+	 * Takes effect from the next reset.
+	 */
+	void setDuel(bool enabled);
+
+	/**
+	 * Adds the given number of asteroids of random types all over the arena of the current game.
+	 */
+	void scatterAsteroids(size_t count);
+
+	/**
+	 * Advances the game by the given time: moves, spawns and checks collisions.
+	 * @param rivalInput the keys held by the second player in a duel, ignored otherwise
+	 */
+	void step(unsigned int millis, InputState input, InputState rivalInput = {});
+
+	// The phases of a step, exposed separately so that they can be timed.
+
+	void move(unsigned int millis, InputState input, InputState rivalInput = {});
+
+	/**
+	 * Fires the spaceships' guns if requested, spawns asteroids when it's time to, and blows exhaust out of the
+	 * spaceships whose thrusters are on.
+	 */
+	void spawn(InputState input, InputState rivalInput = {});
+
+	/**
+	 * Resolves the collisions of the last move, and bursts every asteroid destroyed into debris.
+	 */
+	void checkCollisions();
+
+	/**
+	 * Draws the arena, then the particles over it.
+	 * @param alpha the fraction of the step elapsed since the last move, see Arena::draw
+	 */
+	void draw(DrawBackend & backend, float alpha = 1) const;
+
+	[[nodiscard]] bool isOver() const;
+
+	[[nodiscard]] unsigned long long getTime() const;
+
+	[[nodiscard]] unsigned long long getScore() const;
+
+	[[nodiscard]] const Spaceship & getSpaceship() const;
+
+	/**
+	 * @return the second player's spaceship in a duel, or nullptr
+	 */
+	[[nodiscard]] const Spaceship * getRival() const;
+
+	[[nodiscard]] const Arena & getArena() const;
+
+	[[nodiscard]] const ParticleSystem & getParticles() const;
+
+	/**
+	 * Writes the whole state of the current game into a snapshot, reusing the memory of the bytes.
+	 * Snapshots are taken between steps.
+	 */
+	void save(std::vector<uint8_t> & snapshot) const;
+
+	/**
+	 * Writes the state of the game, for a snapshot with more state following it.
+	 */
+	void save(SnapshotWriter & writer) const;
+
+	/**
+	 * Returns to the state saved in the snapshot, which must come from a game with the same swarm. The following
+	 * steps go exactly as they went after the snapshot was taken, including the random numbers drawn. The particles,
+	 * which snapshots leave out, are cleared.
+	 * @throws std::runtime_error if the snapshot is malformed
+	 */
+	void restore(std::span<const uint8_t> snapshot);
+
+	void restore(SnapshotReader & reader);
+};
@@ -0,0 +1,23 @@
+#include "Hud.h"
+
+void Hud::update(const Game & game) {
+	score.update(game.getScore());
+	health.update(game.getSpaceship().getHitPoints());
+	projectiles.update(game.getArena().getProjectileCount(), game.getArena().getProjectileHighWaterMark());
+}
+
+const HudText & Hud::getScore() const {
+	return score;
+}
+
+const HudText & Hud::getHealth() const {
+	return health;
+}
+
+const HudText & Hud::getProjectiles() const {
+	return projectiles;
+}
+
+unsigned long long Hud::getFormatCount() const {
+	return score.getFormatCount() + health.getFormatCount() + projectiles.getFormatCount();
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Game.h"
+#include "utils/HudText.h"
+
+/**
+ * The lines of text shown over the game, formatted only when the numbers in them change.
+ */
+class Hud {
+	HudText score{L"SCORE: %llu"};
+	HudText health{L"HEALTH: %llu"};
+	HudText projectiles{L"PROJECTILES: %llu (MAX %llu)"};
+
+public:
+	/**
+	 * Formats again the lines whose numbers changed since the last update.
+	 */
+	void update(const Game & game);
+
+	[[nodiscard]] const HudText & getScore() const;
+
+	[[nodiscard]] const HudText & getHealth() const;
+
+	[[nodiscard]] const HudText & getProjectiles() const;
+
+	/**
+	 * @return how many times any line has been formatted
+	 */
+	[[nodiscard]] unsigned long long getFormatCount() const;
+};
@@ -53,7 +53,7 @@ INT WINAPI wWinMain(
 	UINT_PTR IDT_TIMER1 = 1;
 
 	try {
-		new (&d2DHelper) DirectX2DHelper(hwnd);
+		new (&d2DHelper) DirectX2DHelper(hwnd, pCmdLine);
 		SetWindowLong(hwnd, GWL_STYLE, WS_MAXIMIZE);
 		ShowWindow(hwnd, nCmdShow);
 		SendMessage(hwnd, WM_SYSCOMMAND, SC_MAXIMIZE, 0);
@@ -79,6 +79,8 @@ namespace {
 		try {
 			switch (uMsg) {
 			case WM_DESTROY:
+				d2DHelper.saveRecording();
+				d2DHelper.saveProfile();
 				PostQuitMessage(0);
 				return 0;
 
@@ -91,6 +93,17 @@ namespace {
 				InvalidateRect(hwnd, nullptr, false);
 				return 0;
 
+			case WM_KEYDOWN:
+				if (wParam == VK_F3) {
+					d2DHelper.toggleProfilerOverlay();
+					return 0;
+				}
+				if (wParam == VK_F4) {
+					d2DHelper.toggleSpriteBatch();
+					return 0;
+				}
+				return DefWindowProc(hwnd, uMsg, wParam, lParam);
+
 			case WM_MOUSEMOVE:
 				SetCursor(nullptr);
 				return 0;
@@ -0,0 +1,86 @@
+#include "ShipController.h"
+
+#include "../collidable/SweptCollision.h"
+#include "../utils/AsteroiDoomConstants.h"
+
+#include <cmath>
+
+namespace {
+	// How far ahead the spin is extrapolated when turning, so that ships stop turning before they overshoot.
+	const float TurnLookaheadSeconds = 0.25f;
+
+	// Ships only thrust roughly towards the target, so that they do not drift away from it.
+	const float ThrustTolerance = 45;
+
+	/**
+	 * @return the angle wrapped into [-180, 180)
+	 */
+	float wrapDegrees(float angle) {
+		return angle - 360 * std::floor((angle + 180) / 360);
+	}
+
+	/**
+	 * @return the input with which a ship chases the target
+	 */
+	InputState chase(
+	    D2D_POINT_2F location, float rotation, float spin, D2D_POINT_2F target, D2D_RECT_F modulo, Pursuit pursuit
+	) {
+		D2D_POINT_2F offset = minimumImage({target.x - location.x, target.y - location.y}, modulo);
+		float distance = std::hypot(offset.x, offset.y);
+		// A rotation of 0 faces up, the negative y direction, and grows clockwise.
+		float bearing = std::atan2(offset.x, -offset.y) / RadiansInDegree;
+		float turn = wrapDegrees(bearing - rotation);
+		float overshoot = turn - spin * TurnLookaheadSeconds;
+
+		InputState input{};
+		if (overshoot > pursuit.aimTolerance / 2) {
+			input.press(Key::TurnRight);
+		} else if (overshoot < -pursuit.aimTolerance / 2) {
+			input.press(Key::TurnLeft);
+		}
+		if (std::abs(turn) < ThrustTolerance && distance > pursuit.keepDistance) {
+			input.press(Key::Thrust);
+		}
+		if (std::abs(turn) < pursuit.aimTolerance && distance < pursuit.firingRange) {
+			input.press(Key::Shoot);
+		}
+		return input;
+	}
+} // namespace
+
+ShipController::~ShipController() = default;
+
+HunterController::HunterController(Pursuit pursuit) : pursuit(pursuit) {
+}
+
+void HunterController::control(
+    ShipArchetype & ships, size_t begin, size_t end, const ControlContext & context
+) const {
+	auto locations = ships.column<Location>();
+	auto rotations = ships.column<Rotation>();
+	auto spins = ships.column<Spin>();
+	auto inputs = ships.column<ShipInput>();
+	for (size_t ship = begin; ship < end; ship++) {
+		inputs[ship].value = chase(
+		    locations[ship].value, rotations[ship].value, spins[ship].value, context.target, context.modulo, pursuit
+		);
+	}
+}
+
+DogfightController::DogfightController(Pursuit pursuit) : pursuit(pursuit) {
+}
+
+void DogfightController::control(
+    ShipArchetype & ships, size_t begin, size_t end, const ControlContext & context
+) const {
+	// Only inputs are written, so the locations of targets in other ranges can be read concurrently.
+	auto locations = ships.column<Location>();
+	auto rotations = ships.column<Rotation>();
+	auto spins = ships.column<Spin>();
+	auto inputs = ships.column<ShipInput>();
+	for (size_t ship = begin; ship < end; ship++) {
+		D2D_POINT_2F target = locations[ship + 1 == ships.size() ? 0 : ship + 1].value;
+		inputs[ship].value =
+		    chase(locations[ship].value, rotations[ship].value, spins[ship].value, target, context.modulo, pursuit);
+	}
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "../collidable/Components.h"
+
+/**
+ * What a controller knows of the arena when deciding what ships do next.
+ */
+struct ControlContext {
+	// The spaceship of the player.
+	D2D_POINT_2F target{};
+	D2D_RECT_F modulo{};
+};
+
+/**
+ * Decides the input of ships which are not steered by the keyboard, a whole batch of them at once.
+ */
+class ShipController {
+public:
+	virtual ~ShipController();
+
+	/**
+	 * Sets the ShipInput of the ships in rows [begin, end) from their current state.
+	 * Called concurrently for disjoint ranges of rows, so it must only write to the given rows.
+	 */
+	virtual void control(ShipArchetype & ships, size_t begin, size_t end, const ControlContext & context) const = 0;
+};
+
+/**
+ * How a ship chases its target: it turns towards the target, closes in on it up to a distance and fires whenever it
+ * is aimed at the target and close enough to hit it.
+ */
+struct Pursuit {
+	// The largest angle in degrees between the heading and the target at which to fire.
+	float aimTolerance{};
+	// The distance from the target at which to stop thrusting.
+	float keepDistance{};
+	// The largest distance from the target at which to fire.
+	float firingRange{};
+};
+
+/**
+ * Chases the player's spaceship with every ship.
+ */
+class HunterController final : public ShipController {
+	Pursuit pursuit{};
+
+public:
+	explicit HunterController(Pursuit pursuit);
+
+	void control(ShipArchetype & ships, size_t begin, size_t end, const ControlContext & context) const override;
+};
+
+/**
+ * Chases the ship in the next row with every ship, the last one chasing the first, so that a swarm fights itself all
+ * over the arena. As ships are destroyed and rows reused, they pick new targets.
+ */
+class DogfightController final : public ShipController {
+	Pursuit pursuit{};
+
+public:
+	explicit DogfightController(Pursuit pursuit);
+
+	void control(ShipArchetype & ships, size_t begin, size_t end, const ControlContext & context) const override;
+};
@@ -0,0 +1,80 @@
+#include "../collidable/Components.h"
+#include "../collidable/specific/Asteroid.h"
+#include "Benchmark.h"
+
+#include <memory>
+#include <random>
+#include <set>
+
+// Compares asteroids kept as std::set<std::unique_ptr<Asteroid>>, as Arena used to, with an AsteroidArchetype.
+
+namespace {
+	const D2D_RECT_F Modulo{-1000, -600, 1000, 600};
+	const unsigned int FrameMillis = 16;
+	const unsigned int Repetitions = 50;
+
+	void runFor(size_t count) {
+		std::mt19937 rng{2024};
+		std::uniform_real_distribution<float> x(Modulo.left, Modulo.right), y(Modulo.top, Modulo.bottom);
+		std::uniform_real_distribution<float> speed(-300, 300), spin(-360, 360);
+
+		std::set<std::unique_ptr<Asteroid>> legacy{};
+		AsteroidArchetype archetype{};
+		archetype.reserve(count);
+		for (size_t i = 0; i < count; i++) {
+			MovementData movement({x(rng), y(rng)}, 0, {speed(rng), speed(rng)}, spin(rng));
+			float size = i % 2 ? 20.f : 30.f;
+			legacy.emplace(std::make_unique<Asteroid>(size, movement, BitmapSegment(), 50, 50));
+			archetype.add(
+			    {movement.location},
+			    {movement.velocity},
+			    {movement.rotation},
+			    {movement.spin},
+			    {size},
+			    {50},
+			    {50},
+			    {},
+			    {movement.location},
+			    {movement.rotation}
+			);
+		}
+
+		double legacyMove = measure(Repetitions, [&] {
+			for (auto & asteroid : legacy) {
+				asteroid->move(FrameMillis, Modulo);
+			}
+		});
+		double archetypeMove = measure(Repetitions, [&] {
+			archetype.each<Location, Rotation, Velocity, Spin>(
+			    [](Location & location, Rotation & rotation, const Velocity & velocity, const Spin & spin) {
+				    MovementData::move(location.value, rotation.value, velocity.value, spin.value, FrameMillis, Modulo);
+			    }
+			);
+		});
+		report("move", count, legacyMove, archetypeMove);
+
+		Asteroid probe(25, MovementData(), BitmapSegment(), 100, 0);
+		volatile size_t sink = 0;
+		double legacyScan = measure(Repetitions, [&] {
+			size_t hits = 0;
+			for (auto & asteroid : legacy) {
+				hits += probe.collidesWith(*asteroid, Modulo);
+			}
+			sink = hits;
+		});
+		double archetypeScan = measure(Repetitions, [&] {
+			size_t hits = 0;
+			archetype.each<Location, Size>([&](const Location & location, const Size & size) {
+				hits += CollidableObject::collide(probe.getLocation(), probe.getSize(), location.value, size.value, Modulo);
+			});
+			sink = hits;
+		});
+		report("collision scan", count, legacyScan, archetypeScan);
+	}
+} // namespace
+
+void runArchetypeBenchmark() {
+	for (size_t count : {10'000, 100'000}) {
+		runFor(count);
+	}
+}
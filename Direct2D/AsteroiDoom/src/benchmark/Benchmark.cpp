@@ -0,0 +1,22 @@
+#include "Benchmark.h"
+
+#include <cstdarg>
+
+namespace {
+	unsigned int failedChecks = 0;
+} // namespace
+
+bool expect(bool passed, const char * name, const char * format, ...) {
+	std::printf("%-32s %-7s", name, passed ? "ok" : "FAILED");
+	va_list details;
+	va_start(details, format);
+	std::vprintf(format, details);
+	va_end(details);
+	std::printf("\n");
+	failedChecks += !passed;
+	return passed;
+}
+
+unsigned int getFailedCheckCount() {
+	return failedChecks;
+}
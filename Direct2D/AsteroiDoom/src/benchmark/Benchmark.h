@@ -0,0 +1,181 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+/**
+ * Runs the body the given number of times after a single warm-up run.
+ * @return the average duration of a run in microseconds
+ */
+template <typename Body>
+double measure(unsigned int repetitions, Body && body) {
+	body();
+	auto start = std::chrono::steady_clock::now();
+	for (unsigned int repetition = 0; repetition < repetitions; repetition++) {
+		body();
+	}
+	std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count() / repetitions;
+}
+
+/**
+ * The durations of the timed runs of a benchmark, in microseconds per run.
+ */
+struct Timing {
+	double medianMicros{};
+	double minMicros{};
+	double meanMicros{};
+};
+
+/**
+ * Runs the body the given number of times after some warm-up runs, timing every run on its own, so that the median
+ * can be reported, which an interruption of a few runs does not move. The setup runs before every run, untimed, e.g.
+ * to restore what the body changes.
+ */
+template <typename Setup, typename Body>
+Timing measureRuns(unsigned int warmups, unsigned int repetitions, Setup && setup, Body && body) {
+	for (unsigned int warmup = 0; warmup < warmups; warmup++) {
+		setup();
+		body();
+	}
+	std::vector<double> runs(repetitions);
+	for (double & run : runs) {
+		setup();
+		auto start = std::chrono::steady_clock::now();
+		body();
+		run = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+	}
+	Timing timing{};
+	if (runs.empty()) {
+		return timing;
+	}
+	for (double run : runs) {
+		timing.meanMicros += run / double(runs.size());
+	}
+	std::sort(runs.begin(), runs.end());
+	timing.minMicros = runs.front();
+	size_t middle = runs.size() / 2;
+	timing.medianMicros = runs.size() % 2 ? runs[middle] : (runs[middle - 1] + runs[middle]) / 2;
+	return timing;
+}
+
+/**
+ * A kernel timed on a given number of entities at a given density, one line of the JSON report.
+ */
+struct BenchmarkRecord {
+	const char * kernel{};
+	size_t entities{};
+	// Entities per million square units of the looped rectangle they live on.
+	double density{};
+	unsigned int repetitions{};
+	Timing timing{};
+};
+
+inline void report(const char * name, size_t entities, double baselineMicros, double optimizedMicros) {
+	std::printf(
+	    "%-32s n = %-8zu %10.1f us -> %10.1f us (%.2fx)\n",
+	    name,
+	    entities,
+	    baselineMicros,
+	    optimizedMicros,
+	    baselineMicros / optimizedMicros
+	);
+}
+
+/**
+ * Reports a check of the benchmarks on a line of its own: the name, whether it passed, and the details. A failed
+ * check fails the whole run, see getFailedCheckCount.
+ * @param format the printf format of the details, followed by their values
+ * @return whether the check passed
+ */
+bool expect(bool passed, const char * name, const char * format, ...);
+
+/**
+ * @return the number of checks which failed so far
+ */
+unsigned int getFailedCheckCount();
+
+void runArchetypeBenchmark();
+
+/**
+ * Checks collisionMask and collisionMaskScalar against CollidableObject::collide on random pairs and on edge cases.
+ */
+void checkCollisionKernel();
+
+void runCollisionKernelBenchmark();
+
+/**
+ * Checks that the entities collide like a copy of the virtual-inheritance hierarchy they replaced, also after moving.
+ */
+void checkEntities();
+
+void runEntityBenchmark();
+
+/**
+ * Times the movement and collision kernels over a sweep of entity counts and densities.
+ * @return a record for every kernel, count and density
+ */
+std::vector<BenchmarkRecord> runKernelBenchmark();
+
+/**
+ * Checks that collision masks overlap the same both ways around, and exactly where they should on edge cases.
+ */
+void checkMasks();
+
+void runMaskBenchmark();
+
+/**
+ * Checks that Arena::draw culls exactly the copies of objects which do not show on the screen.
+ */
+void checkDrawCulling();
+
+/**
+ * Checks that a sorted DrawCommandList replays the sprites drawn into it, grouped by bitmap in stable order.
+ */
+void checkDrawCommands();
+
+void runDrawBenchmark();
+
+/**
+ * Checks that moving an arena on the thread pool gives bit-identical results to moving it serially.
+ */
+void checkParallelMove();
+
+void runMoveBenchmark();
+
+/**
+ * Checks that moving particles with SIMD gives exactly the results of moving them one by one.
+ */
+void checkParticles();
+
+void runParticleBenchmark();
+
+/**
+ * Checks that bounded integers are unbiased and uniform, and that filled floats stay in their range.
+ */
+void checkRandom();
+
+void runRandomBenchmark();
+
+/**
+ * Checks that restored games go on like the original ones, and that a rewind buffer gives back its snapshots.
+ */
+void checkRewind();
+
+void runRewindBenchmark();
+
+/**
+ * Checks that blending with SIMD and on all threads gives the pixels of blending one channel at a time.
+ */
+void checkSoftwareRenderer();
+
+void runSoftwareRenderBenchmark();
+
+/**
+ * Checks timeOfImpact against sampling the travel of random pairs, and on edge cases.
+ */
+void checkSweptCollision();
+
+void runSweptBenchmark();
@@ -0,0 +1,213 @@
+#include "../utils/ThreadPool.h"
+#include "Benchmark.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace {
+	enum class Suite { All, Kernels, Checks };
+
+	struct Options {
+		Suite suite{Suite::All};
+		unsigned int threadCount{};
+		const char * jsonPath{nullptr};
+		const char * baselinePath{nullptr};
+	};
+
+	void printUsage(const char * program) {
+		std::fprintf(
+		    stderr,
+		    "Usage: %s [--suite all|kernels|checks] [--threads N] [--json FILE] [--baseline FILE]\n"
+		    "Runs the checks and the microbenchmarks, or with --suite kernels only the sweep of the movement and\n"
+		    "collision kernels, or with --suite checks only the checks. Fails if any check fails.\n"
+		    "With --threads, runs parallel loops on N threads instead of one per hardware thread.\n"
+		    "With --json, writes the results of the sweep to a JSON file, a result per line.\n"
+		    "With --baseline, compares the sweep to the results of another build written with --json.\n",
+		    program
+		);
+	}
+
+	bool parseOptions(int argc, char ** argv, Options & options) {
+		for (int i = 1; i < argc; i++) {
+			std::string_view option = argv[i];
+			if (i + 1 == argc) {
+				return false;
+			}
+			const char * value = argv[++i];
+			if (option == "--suite") {
+				std::string_view suite = value;
+				if (suite == "all") {
+					options.suite = Suite::All;
+				} else if (suite == "kernels") {
+					options.suite = Suite::Kernels;
+				} else if (suite == "checks") {
+					options.suite = Suite::Checks;
+				} else {
+					return false;
+				}
+			} else if (option == "--threads") {
+				char * end = nullptr;
+				unsigned long threadCount = std::strtoul(value, &end, 10);
+				if (*end != '\0' || threadCount == 0 || threadCount > 256) {
+					return false;
+				}
+				options.threadCount = unsigned(threadCount);
+			} else if (option == "--json") {
+				options.jsonPath = value;
+			} else if (option == "--baseline") {
+				options.baselinePath = value;
+			} else {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * Writes every record on a line of its own, with its key first, so that reports of two builds can be diffed.
+	 */
+	void writeJson(std::ostream & file, const std::vector<BenchmarkRecord> & records) {
+		file << "{\n  \"threads\": " << ThreadPool::shared().getThreadCount() << ",\n  \"results\": [\n";
+		char line[512];
+		for (size_t index = 0; index < records.size(); index++) {
+			const BenchmarkRecord & record = records[index];
+			std::snprintf(
+			    line,
+			    sizeof(line),
+			    "    {\"kernel\": \"%s\", \"entities\": %zu, \"density\": %.0f, \"repetitions\": %u, "
+			    "\"median_us\": %.3f, \"min_us\": %.3f, \"mean_us\": %.3f}%s\n",
+			    record.kernel,
+			    record.entities,
+			    record.density,
+			    record.repetitions,
+			    record.timing.medianMicros,
+			    record.timing.minMicros,
+			    record.timing.meanMicros,
+			    index + 1 < records.size() ? "," : ""
+			);
+			file << line;
+		}
+		file << "  ]\n}\n";
+	}
+
+	/**
+	 * Finds the median of the record with the same key in a report written by writeJson.
+	 * @return whether the report holds such a record
+	 */
+	bool findMedian(std::string_view report, const BenchmarkRecord & record, double & medianMicros) {
+		char key[256];
+		std::snprintf(
+		    key,
+		    sizeof(key),
+		    "{\"kernel\": \"%s\", \"entities\": %zu, \"density\": %.0f,",
+		    record.kernel,
+		    record.entities,
+		    record.density
+		);
+		size_t start = report.find(key);
+		if (start == std::string_view::npos) {
+			return false;
+		}
+		const char * medianKey = "\"median_us\": ";
+		size_t median = report.find(medianKey, start);
+		if (median == std::string_view::npos || median > report.find('}', start)) {
+			return false;
+		}
+		medianMicros = std::strtod(report.data() + median + std::strlen(medianKey), nullptr);
+		return true;
+	}
+
+	void compare(const std::string & baseline, const std::vector<BenchmarkRecord> & records) {
+		std::printf("compared to the baseline, by median:\n");
+		for (const BenchmarkRecord & record : records) {
+			double baselineMicros = 0;
+			if (!findMedian(baseline, record, baselineMicros)) {
+				std::printf(
+				    "%-36s n = %-8zu density %-6.0f not in the baseline\n", record.kernel, record.entities, record.density
+				);
+				continue;
+			}
+			std::printf(
+			    "%-36s n = %-8zu density %-6.0f %10.1f us -> %10.1f us (%.2fx)\n",
+			    record.kernel,
+			    record.entities,
+			    record.density,
+			    baselineMicros,
+			    record.timing.medianMicros,
+			    baselineMicros / record.timing.medianMicros
+			);
+		}
+	}
+} // namespace
+
+int main(int argc, char ** argv) {
+	Options options{};
+	if (!parseOptions(argc, argv, options)) {
+		printUsage(argv[0]);
+		return 1;
+	}
+	ThreadPool::setSharedThreadCount(options.threadCount);
+	std::string baseline{};
+	if (options.baselinePath) {
+		std::ifstream file(options.baselinePath);
+		if (!file) {
+			std::fprintf(stderr, "Failed to open baseline '%s'.\n", options.baselinePath);
+			return 1;
+		}
+		std::stringstream contents{};
+		contents << file.rdbuf();
+		baseline = contents.str();
+	}
+
+	if (options.suite != Suite::Kernels) {
+		checkCollisionKernel();
+		checkEntities();
+		checkMasks();
+		checkDrawCulling();
+		checkDrawCommands();
+		checkParallelMove();
+		checkParticles();
+		checkRandom();
+		checkRewind();
+		checkSoftwareRenderer();
+		checkSweptCollision();
+	}
+	if (options.suite == Suite::All) {
+		runArchetypeBenchmark();
+		runCollisionKernelBenchmark();
+		runEntityBenchmark();
+		runMaskBenchmark();
+		runDrawBenchmark();
+		runMoveBenchmark();
+		runParticleBenchmark();
+		runRandomBenchmark();
+		runRewindBenchmark();
+		runSoftwareRenderBenchmark();
+		runSweptBenchmark();
+	}
+	std::vector<BenchmarkRecord> records{};
+	if (options.suite != Suite::Checks) {
+		records = runKernelBenchmark();
+	}
+
+	if (options.jsonPath) {
+		std::ofstream file(options.jsonPath);
+		writeJson(file, records);
+		if (!file) {
+			std::fprintf(stderr, "Failed to write results '%s'.\n", options.jsonPath);
+			return 1;
+		}
+	}
+	if (options.baselinePath) {
+		compare(baseline, records);
+	}
+	if (getFailedCheckCount() > 0) {
+		std::fprintf(stderr, "%u checks failed.\n", getFailedCheckCount());
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,225 @@
+#include "../collidable/CollisionKernel.h"
+#include "../collidable/base/CollidableObject.h"
+#include "Benchmark.h"
+
+#include <random>
+#include <vector>
+
+// Checks collisionMask against CollidableObject::collide on both moduli used by Arena, on random pairs and on pairs
+// at the edge cases of wrapping and touching, then compares their speed.
+
+namespace {
+	const float Width = 1920;
+	const float Height = 1080;
+	const float Margin = 200;
+	const D2D_RECT_F ArenaModulo{-Width / 2, -Height / 2, Width / 2, Height / 2};
+	const D2D_RECT_F SpawnModulo{-Width / 2 - Margin, -Height / 2 - Margin, Width / 2 + Margin, Height / 2 + Margin};
+	const size_t Count = 4096;
+	const size_t Probes = 256;
+	const unsigned int Repetitions = 20;
+
+	struct Batch {
+		std::vector<float> xs{};
+		std::vector<float> ys{};
+		std::vector<float> sizes{};
+		std::vector<D2D_POINT_2F> probes{};
+		std::vector<float> probeSizes{};
+	};
+
+	Batch generate(D2D_RECT_F modulo, std::mt19937 & rng) {
+		std::uniform_real_distribution<float> x(modulo.left, modulo.right), y(modulo.top, modulo.bottom);
+		// Large sizes, so that a good share of pairs collides, also across the edges.
+		std::uniform_real_distribution<float> size(20, 200);
+		Batch batch{};
+		for (size_t i = 0; i < Count; i++) {
+			batch.xs.push_back(x(rng));
+			batch.ys.push_back(y(rng));
+			batch.sizes.push_back(size(rng));
+		}
+		for (size_t i = 0; i < Probes; i++) {
+			batch.probes.push_back({x(rng), y(rng)});
+			batch.probeSizes.push_back(size(rng));
+		}
+		return batch;
+	}
+
+	using Kernel =
+	    void (*)(D2D_POINT_2F, float, const float *, const float *, const float *, size_t, D2D_RECT_F, uint64_t *);
+
+	const Kernel Kernels[2]{collisionMask, collisionMaskScalar};
+	const char * const KernelNames[2]{"SIMD kernel", "scalar kernel"};
+
+	void verify(const char * name, const Batch & batch, D2D_RECT_F modulo, Kernel kernel) {
+		std::vector<uint64_t> mask((Count + 63) / 64);
+		size_t mismatches = 0, hits = 0;
+		for (size_t probe = 0; probe < Probes; probe++) {
+			kernel(
+			    batch.probes[probe],
+			    batch.probeSizes[probe],
+			    batch.xs.data(),
+			    batch.ys.data(),
+			    batch.sizes.data(),
+			    Count,
+			    modulo,
+			    mask.data()
+			);
+			for (size_t i = 0; i < Count; i++) {
+				bool expected = CollidableObject::collide(
+				    batch.probes[probe], batch.probeSizes[probe], {batch.xs[i], batch.ys[i]}, batch.sizes[i], modulo
+				);
+				bool actual = (mask[i / 64] >> (i % 64)) & 1;
+				mismatches += expected != actual;
+				hits += expected;
+			}
+		}
+		expect(
+		    mismatches == 0, name, "%zu of %zu random pairs collide, %zu mismatches", hits, Count * Probes, mismatches
+		);
+	}
+
+	/**
+	 * A circle placed relative to a probe, whether it collides with the probe being known exactly: every coordinate,
+	 * size and squared distance below is a small integer or half, which floats hold without rounding.
+	 */
+	struct EdgeCase {
+		D2D_POINT_2F offset{};
+		float size{};
+		bool collides{};
+	};
+
+	const float ProbeSize = 20;
+
+	std::vector<EdgeCase> makeEdgeCases(D2D_RECT_F modulo) {
+		float halfWidth = (modulo.right - modulo.left) / 2, halfHeight = (modulo.bottom - modulo.top) / 2;
+		return {
+		    // Exactly half the rectangle apart, where both ways around are equally short.
+		    {{halfWidth, 0}, halfWidth - ProbeSize, true},
+		    {{-halfWidth, 0}, halfWidth - ProbeSize, true},
+		    {{0, halfHeight}, halfHeight - ProbeSize, true},
+		    {{0, -halfHeight}, halfHeight - ProbeSize, true},
+		    {{halfWidth, 0}, halfWidth - ProbeSize - 1, false},
+		    {{-halfWidth, 0}, halfWidth - ProbeSize - 0.5f, false},
+		    {{0, halfHeight}, halfHeight - ProbeSize - 1, false},
+		    {{0, -halfHeight}, halfHeight - ProbeSize - 0.5f, false},
+		    // Exactly touching, at a distance of 50, and just apart.
+		    {{30, 40}, 30, true},
+		    {{-30, 40}, 30, true},
+		    {{30, -40}, 29.5f, false},
+		    {{-30, -40}, 29, false},
+		    {{50, 0}, 30, true},
+		    {{0, -50}, 29.5f, false},
+		    {{0, 0}, 1, true},
+		};
+	}
+
+	/**
+	 * Wraps a coordinate into [low, high] the way MovementData::move does, which is exact for the edge cases.
+	 */
+	float wrap(float value, float low, float high) {
+		if (value < low) {
+			return value + (high - low);
+		}
+		if (value > high) {
+			return value - (high - low);
+		}
+		return value;
+	}
+
+	/**
+	 * Tests a probe in the middle and one near a corner, so that the cases there lie across the edges, against
+	 * batches of every length up to a few words, so that every lane of the vectors and of the tail is hit.
+	 */
+	void verifyEdgeCases(const char * name, D2D_RECT_F modulo, Kernel kernel) {
+		std::vector<EdgeCase> cases = makeEdgeCases(modulo);
+		const size_t length = 5 * cases.size();
+		const D2D_POINT_2F probes[2]{{0, 0}, {modulo.left + 10, modulo.top + 20}};
+		size_t mismatches = 0, checks = 0;
+		for (D2D_POINT_2F probe : probes) {
+			std::vector<float> xs{}, ys{}, sizes{};
+			std::vector<bool> expected{};
+			for (size_t i = 0; i < length; i++) {
+				const EdgeCase & edgeCase = cases[i % cases.size()];
+				xs.push_back(wrap(probe.x + edgeCase.offset.x, modulo.left, modulo.right));
+				ys.push_back(wrap(probe.y + edgeCase.offset.y, modulo.top, modulo.bottom));
+				sizes.push_back(edgeCase.size);
+				expected.push_back(edgeCase.collides);
+				// The 9 translations must agree, or the cases themselves are wrong.
+				mismatches += CollidableObject::collide(probe, ProbeSize, {xs[i], ys[i]}, sizes[i], modulo) !=
+				              edgeCase.collides;
+			}
+			for (size_t count = 1; count <= length; count++) {
+				std::vector<uint64_t> mask((count + 63) / 64, ~uint64_t(0));
+				kernel(probe, ProbeSize, xs.data(), ys.data(), sizes.data(), count, modulo, mask.data());
+				for (size_t i = 0; i < 64 * mask.size(); i++) {
+					bool actual = (mask[i / 64] >> (i % 64)) & 1;
+					// Bits past the batch must be clear.
+					mismatches += actual != (i < count && expected[i]);
+					checks++;
+				}
+			}
+		}
+		expect(mismatches == 0, name, "%zu of %zu edge case bits wrong", mismatches, checks);
+	}
+
+	void runFor(const char * name, D2D_RECT_F modulo, std::mt19937 & rng) {
+		Batch batch = generate(modulo, rng);
+		auto simd = [&](D2D_POINT_2F location, float size, D2D_RECT_F m, uint64_t * mask) {
+			collisionMask(location, size, batch.xs.data(), batch.ys.data(), batch.sizes.data(), Count, m, mask);
+		};
+		auto scalar = [&](D2D_POINT_2F location, float size, D2D_RECT_F m, uint64_t * mask) {
+			collisionMaskScalar(location, size, batch.xs.data(), batch.ys.data(), batch.sizes.data(), Count, m, mask);
+		};
+
+		std::vector<uint64_t> mask((Count + 63) / 64);
+		volatile size_t sink = 0;
+		double legacy = measure(Repetitions, [&] {
+			size_t hits = 0;
+			for (size_t probe = 0; probe < Probes; probe++) {
+				for (size_t i = 0; i < Count; i++) {
+					hits += CollidableObject::collide(
+					    batch.probes[probe], batch.probeSizes[probe], {batch.xs[i], batch.ys[i]}, batch.sizes[i], modulo
+					);
+				}
+			}
+			sink = hits;
+		});
+		double scalarMicros = measure(Repetitions, [&] {
+			for (size_t probe = 0; probe < Probes; probe++) {
+				scalar(batch.probes[probe], batch.probeSizes[probe], modulo, mask.data());
+			}
+			sink = mask[0];
+		});
+		double simdMicros = measure(Repetitions, [&] {
+			for (size_t probe = 0; probe < Probes; probe++) {
+				simd(batch.probes[probe], batch.probeSizes[probe], modulo, mask.data());
+			}
+			sink = mask[0];
+		});
+		char line[64];
+		std::snprintf(line, sizeof(line), "%s: 9 translations -> scalar", name);
+		report(line, Count * Probes, legacy, scalarMicros);
+		std::snprintf(line, sizeof(line), "%s: 9 translations -> SIMD", name);
+		report(line, Count * Probes, legacy, simdMicros);
+	}
+} // namespace
+
+void checkCollisionKernel() {
+	std::mt19937 rng{2024};
+	const char * const moduloNames[2]{"arena modulo", "spawn modulo"};
+	const D2D_RECT_F moduli[2]{ArenaModulo, SpawnModulo};
+	char name[64];
+	for (size_t modulo = 0; modulo < 2; modulo++) {
+		Batch batch = generate(moduli[modulo], rng);
+		for (size_t kernel = 0; kernel < 2; kernel++) {
+			std::snprintf(name, sizeof(name), "%s, %s", moduloNames[modulo], KernelNames[kernel]);
+			verify(name, batch, moduli[modulo], Kernels[kernel]);
+			verifyEdgeCases(name, moduli[modulo], Kernels[kernel]);
+		}
+	}
+}
+
+void runCollisionKernelBenchmark() {
+	std::mt19937 rng{2024};
+	runFor("arena", ArenaModulo, rng);
+	runFor("spawn", SpawnModulo, rng);
+}
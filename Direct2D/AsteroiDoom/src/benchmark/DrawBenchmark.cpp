@@ -0,0 +1,209 @@
+#include "../collidable/Arena.h"
+#include "../utils/DrawBackend.h"
+#include "../utils/Random.h"
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+// Checks that the screen culling of Arena::draw drops exactly the copies which do not show on the screen, and that a
+// sorted DrawCommandList replays the sprites drawn, grouped by bitmap. Counts the sprites it submits against drawing
+// every copy of every object as it used to, then measures recording the frame into a DrawCommandList and sorting it
+// by bitmap, and replaying it.
+
+namespace {
+	const float Width = 1920;
+	const float Height = 1080;
+	const float Margin = 200;
+	const D2D_RECT_F Screen{-Width / 2, -Height / 2, Width / 2, Height / 2};
+	const float Infinity = std::numeric_limits<float>::infinity();
+	const D2D_RECT_F Everywhere{-Infinity, -Infinity, Infinity, Infinity};
+	const unsigned int Repetitions = 200;
+
+	// A bitmap per kind of sprite, like the game's, so that sorting has bitmaps to group.
+	BitmapHelper Bitmaps[4]{};
+	const BitmapSegment SpaceshipSprite{&Bitmaps[0], {0, 0, 60, 60}};
+	const BitmapSegment ProjectileSprite{&Bitmaps[1], {0, 0, 10, 10}};
+	const BitmapSegment AsteroidSprites[2]{{&Bitmaps[2], {0, 0, 40, 40}}, {&Bitmaps[3], {0, 0, 60, 60}}};
+
+	// A sprite as drawn: its bitmap, location and rotation.
+	using DrawnSprite = std::tuple<const BitmapHelper *, float, float, float>;
+
+	/**
+	 * Counts all sprites, and records the ones drawn in order: all of them, or only the ones which show on the screen.
+	 */
+	class RecordingDrawBackend final : public DrawBackend {
+	public:
+		bool visibleOnly{};
+		size_t drawCount{};
+		std::vector<DrawnSprite> sprites{};
+
+		void drawSprite(const BitmapSegment & sprite, D2D_POINT_2F location, float rotation) override {
+			float radius = sprite.getBoundingRadius();
+			drawCount++;
+			if (!visibleOnly || (Screen.left <= location.x + radius && location.x - radius <= Screen.right &&
+			                     Screen.top <= location.y + radius && location.y - radius <= Screen.bottom)) {
+				sprites.emplace_back(sprite.getBitmap(), location.x, location.y, rotation);
+			}
+		}
+	};
+
+	Arena makeArena(size_t asteroids, size_t projectiles, Random & random) {
+		auto spaceship = std::make_shared<Spaceship>(
+		    25, MovementData(), SpaceshipSprite, 100, ThrusterData(), 20, 250, ProjectileSprite
+		);
+		Arena arena(Width, Height, Margin, spaceship);
+		for (size_t i = 0; i < asteroids; i++) {
+			arena.spawnAsteroid(i % 2 ? 30.f : 20.f, AsteroidSprites[i % 2], 50, 50, random);
+		}
+		for (size_t i = 0; i < projectiles; i++) {
+			float velocity[2];
+			random.fill(velocity, 2, -300, 300);
+			MovementData movement({0, 0}, 0, {velocity[0], velocity[1]}, random.nextFloat() * 720 - 360);
+			arena.addProjectile(Projectile(5, movement, ProjectileSprite, 25));
+		}
+		// Let asteroids drift into the arena and projectiles spread over it, not checking collisions.
+		for (int step = 0; step < 400; step++) {
+			arena.move(4);
+		}
+		return arena;
+	}
+
+	void runFor(size_t asteroids, size_t projectiles, Random & random) {
+		Arena arena = makeArena(asteroids, projectiles, random);
+
+		CountingDrawBackend everything{};
+		arena.draw(everything, 1, Everywhere);
+		CountingDrawBackend culled{};
+		arena.draw(culled, 1);
+		size_t objects = arena.getAsteroidCount() + arena.getProjectileCount() + 1;
+		std::printf(
+		    "%-32s n = %-8zu %10zu    -> %10zu    (%.2fx)\n",
+		    "draw submissions per frame",
+		    objects,
+		    everything.getDrawCount(),
+		    culled.getDrawCount(),
+		    double(everything.getDrawCount()) / double(culled.getDrawCount())
+		);
+
+		double allMicros = measure(Repetitions, [&] {
+			everything.reset();
+			arena.draw(everything, 0.5f, Everywhere);
+		});
+		double culledMicros = measure(Repetitions, [&] {
+			culled.reset();
+			arena.draw(culled, 0.5f);
+		});
+		report("draw: all copies -> culled", objects, allMicros, culledMicros);
+
+		DrawCommandList commands{};
+		double recordMicros = measure(Repetitions, [&] {
+			commands.clear();
+			arena.draw(commands, 0.5f);
+			commands.sortByBitmap();
+		});
+		double replayMicros = measure(Repetitions, [&] {
+			culled.reset();
+			commands.replay(culled);
+		});
+		report("draw: direct -> recorded, sorted", objects, culledMicros, recordMicros);
+		expect(
+		    culled.getDrawCount() == commands.size(),
+		    "draw command list",
+		    "%zu commands in %zu batches per frame, %zu replayed in %.1f us",
+		    commands.size(),
+		    commands.getBatches().size(),
+		    culled.getDrawCount(),
+		    replayMicros
+		);
+	}
+
+	/**
+	 * @return the sprites in the order sortByBitmap gives them: stably, by the bitmap they first appeared with
+	 */
+	std::vector<DrawnSprite> sortedByBitmap(std::vector<DrawnSprite> sprites) {
+		std::vector<const BitmapHelper *> bitmaps{};
+		for (const DrawnSprite & sprite : sprites) {
+			if (std::find(bitmaps.begin(), bitmaps.end(), std::get<0>(sprite)) == bitmaps.end()) {
+				bitmaps.push_back(std::get<0>(sprite));
+			}
+		}
+		auto rank = [&](const DrawnSprite & sprite) {
+			return std::find(bitmaps.begin(), bitmaps.end(), std::get<0>(sprite)) - bitmaps.begin();
+		};
+		std::stable_sort(sprites.begin(), sprites.end(), [&](const DrawnSprite & first, const DrawnSprite & second) {
+			return rank(first) < rank(second);
+		});
+		return sprites;
+	}
+
+	/**
+	 * @return whether the batches follow one another over all commands, each of its own bitmap
+	 */
+	bool batchesCover(const DrawCommandList & commands) {
+		size_t next = 0;
+		for (const DrawBatch & batch : commands.getBatches()) {
+			if (batch.first != next || batch.count == 0) {
+				return false;
+			}
+			for (size_t index = batch.first; index < batch.first + batch.count; index++) {
+				if (commands.getCommands()[index].sprite.getBitmap() != batch.bitmap) {
+					return false;
+				}
+			}
+			next += batch.count;
+		}
+		return next == commands.size();
+	}
+} // namespace
+
+void checkDrawCulling() {
+	Random random(2024);
+	for (size_t asteroids : {100, 1000}) {
+		Arena arena = makeArena(asteroids, asteroids / 2, random);
+		RecordingDrawBackend visible{}, culled{};
+		visible.visibleOnly = true;
+		arena.draw(visible, 0.5f, Everywhere);
+		arena.draw(culled, 0.5f);
+		std::sort(visible.sprites.begin(), visible.sprites.end());
+		std::sort(culled.sprites.begin(), culled.sprites.end());
+		expect(
+		    culled.sprites == visible.sprites,
+		    "draw culling",
+		    "%zu of %zu copies drawn, %zu show on the screen",
+		    culled.drawCount,
+		    visible.drawCount,
+		    visible.sprites.size()
+		);
+	}
+}
+
+void checkDrawCommands() {
+	Random random(2024);
+	for (size_t asteroids : {100, 1000}) {
+		Arena arena = makeArena(asteroids, asteroids / 2, random);
+		RecordingDrawBackend direct{}, replayed{};
+		arena.draw(direct, 0.5f);
+		DrawCommandList commands{};
+		arena.draw(commands, 0.5f);
+		commands.sortByBitmap();
+		commands.replay(replayed);
+		expect(
+		    replayed.sprites == sortedByBitmap(direct.sprites) && batchesCover(commands),
+		    "draw command list",
+		    "%zu sprites drawn, %zu replayed in %zu batches",
+		    direct.sprites.size(),
+		    replayed.sprites.size(),
+		    commands.getBatches().size()
+		);
+	}
+}
+
+void runDrawBenchmark() {
+	Random random(2024);
+	runFor(100, 50, random);
+	runFor(1000, 500, random);
+}
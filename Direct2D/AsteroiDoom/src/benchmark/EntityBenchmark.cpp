@@ -0,0 +1,209 @@
+#include "../collidable/specific/Asteroid.h"
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+// Compares the entity classes with a copy of the virtual-inheritance hierarchy they replaced, and checks that both find
+// the same collisions. The old entities could only be kept behind pointers to their polymorphic base, the new ones are
+// kept by value.
+
+namespace {
+	const D2D_RECT_F Modulo{-1000, -600, 1000, 600};
+	const unsigned int FrameMillis = 16;
+	const unsigned int Repetitions = 50;
+
+	namespace legacy {
+		float square(float x) {
+			return x * x;
+		}
+
+		class CollidableObject {
+		protected:
+			const float size{};
+
+			MovementData movement{};
+
+			BitmapSegment bitmapSegment{};
+
+			CollidableObject() = default;
+
+		public:
+			CollidableObject(float size, MovementData movement, BitmapSegment bitmapSegment) :
+			    size(size),
+			    movement(movement),
+			    bitmapSegment(bitmapSegment) {
+			}
+
+			virtual ~CollidableObject() = default;
+
+			[[nodiscard]] float squareDistanceFrom(const CollidableObject & other, D2D_RECT_F modulo) const {
+				const static float mxFactors[9] = {0, -1, -1, 0, 1, 1, 1, 0, -1};
+				const static float myFactors[9] = {0, 0, -1, -1, -1, 0, 1, 1, 1};
+				float mx = modulo.right - modulo.left;
+				float my = modulo.bottom - modulo.top;
+				auto & [x, y] = movement.location;
+				auto & [ox, oy] = other.movement.location;
+
+				float result = std::numeric_limits<float>::infinity();
+
+				for (int i = 0; i < 9; i++) {
+					result = std::min(result, square(x + mxFactors[i] * mx - ox) + square(y + myFactors[i] * my - oy));
+				}
+
+				return result;
+			}
+
+			[[nodiscard]] bool collidesWith(const CollidableObject & other, D2D_RECT_F modulo) const {
+				return square(size + other.size) >= squareDistanceFrom(other, modulo);
+			}
+
+			virtual void move(unsigned int millis, D2D_RECT_F modulo) {
+				movement.move(millis, modulo);
+			}
+		};
+
+		class DamagableObject : virtual public CollidableObject {
+			unsigned int hitPoints;
+
+		protected:
+			explicit DamagableObject(unsigned int hitPoints) : hitPoints(hitPoints) {
+			}
+		};
+
+		class DamagingObject : virtual public CollidableObject {
+			unsigned int damagePoints;
+
+		protected:
+			explicit DamagingObject(unsigned int damagePoints) : damagePoints(damagePoints) {
+			}
+		};
+
+		class Asteroid final : virtual public DamagableObject, virtual public DamagingObject {
+		public:
+			Asteroid(
+			    float size,
+			    MovementData movement,
+			    BitmapSegment bitmapSegment,
+			    unsigned int hitPoints,
+			    unsigned int damagePoints
+			) :
+			    CollidableObject(size, movement, bitmapSegment),
+			    DamagableObject(hitPoints),
+			    DamagingObject(damagePoints) {
+			}
+		};
+	} // namespace legacy
+
+	/**
+	 * The same asteroids, both ways.
+	 */
+	struct Entities {
+		std::vector<std::unique_ptr<legacy::CollidableObject>> legacyAsteroids{};
+		std::vector<Asteroid> asteroids{};
+	};
+
+	MovementData randomMovement(std::mt19937 & rng) {
+		std::uniform_real_distribution<float> x(Modulo.left, Modulo.right), y(Modulo.top, Modulo.bottom);
+		std::uniform_real_distribution<float> speed(-300, 300), spin(-360, 360);
+		return {{x(rng), y(rng)}, 0, {speed(rng), speed(rng)}, spin(rng)};
+	}
+
+	Entities makeEntities(size_t count, std::mt19937 & rng) {
+		Entities entities{};
+		entities.asteroids.reserve(count);
+		for (size_t i = 0; i < count; i++) {
+			MovementData movement = randomMovement(rng);
+			float size = i % 2 ? 20.f : 30.f;
+			entities.legacyAsteroids.push_back(
+			    std::make_unique<legacy::Asteroid>(size, movement, BitmapSegment(), 50, 50)
+			);
+			entities.asteroids.emplace_back(size, movement, BitmapSegment(), 50, 50);
+		}
+		return entities;
+	}
+
+	void runFor(size_t count) {
+		std::mt19937 rng{2024};
+		Entities entities = makeEntities(count, rng);
+		auto & legacyAsteroids = entities.legacyAsteroids;
+		auto & asteroids = entities.asteroids;
+
+		double legacyMove = measure(Repetitions, [&] {
+			for (auto & asteroid : legacyAsteroids) {
+				asteroid->move(FrameMillis, Modulo);
+			}
+		});
+		double move = measure(Repetitions, [&] {
+			for (auto & asteroid : asteroids) {
+				asteroid.move(FrameMillis, Modulo);
+			}
+		});
+		report("entity move", count, legacyMove, move);
+
+		legacy::Asteroid legacyProbe(25, MovementData(), BitmapSegment(), 100, 0);
+		Asteroid probe(25, MovementData(), BitmapSegment(), 100, 0);
+		volatile size_t legacyHits = 0, hits = 0;
+		double legacyCollide = measure(Repetitions, [&] {
+			size_t found = 0;
+			for (auto & asteroid : legacyAsteroids) {
+				found += legacyProbe.collidesWith(*asteroid, Modulo);
+			}
+			legacyHits = found;
+		});
+		double collide = measure(Repetitions, [&] {
+			size_t found = 0;
+			for (auto & asteroid : asteroids) {
+				found += probe.collidesWith(asteroid, Modulo);
+			}
+			hits = found;
+		});
+		report("entity collide", count, legacyCollide, collide);
+		expect(legacyHits == hits, "entity collide", "%zu hits, %zu before", size_t(hits), size_t(legacyHits));
+	}
+} // namespace
+
+void checkEntities() {
+	const size_t count = 10'000, probes = 64;
+	const unsigned int frames = 100;
+	std::mt19937 rng{2024};
+	Entities entities = makeEntities(count, rng);
+	size_t mismatches = 0, hits = 0;
+	auto compare = [&] {
+		for (size_t probe = 0; probe < probes; probe++) {
+			MovementData movement = randomMovement(rng);
+			legacy::Asteroid legacyProbe(25, movement, BitmapSegment(), 100, 0);
+			Asteroid newProbe(25, movement, BitmapSegment(), 100, 0);
+			for (size_t i = 0; i < count; i++) {
+				bool expected = legacyProbe.collidesWith(*entities.legacyAsteroids[i], Modulo);
+				mismatches += newProbe.collidesWith(entities.asteroids[i], Modulo) != expected;
+				hits += expected;
+			}
+		}
+	};
+	compare();
+	for (unsigned int frame = 0; frame < frames; frame++) {
+		for (size_t i = 0; i < count; i++) {
+			entities.legacyAsteroids[i]->move(FrameMillis, Modulo);
+			entities.asteroids[i].move(FrameMillis, Modulo);
+		}
+	}
+	compare();
+	expect(
+	    mismatches == 0,
+	    "entities: old -> new",
+	    "%zu of %zu pairs collide before and after moving, %zu mismatches",
+	    hits,
+	    2 * count * probes,
+	    mismatches
+	);
+}
+
+void runEntityBenchmark() {
+	for (size_t count : {10'000, 100'000}) {
+		runFor(count);
+	}
+}
@@ -0,0 +1,221 @@
+#include "../collidable/Arena.h"
+#include "../collidable/specific/Spaceship.h"
+#include "../utils/AsteroiDoomConstants.h"
+#include "../utils/Random.h"
+#include "../utils/Snapshot.h"
+#include "Benchmark.h"
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+// Times the kernels every step runs, on their own, over a sweep of entity counts and densities. Every configuration
+// is generated from a fixed seed, so that runs of different builds time exactly the same work.
+
+namespace {
+	const size_t Counts[]{1'000, 10'000, 100'000};
+	// Entities per million square units: about the density of a busy game, and a crowd.
+	const double Densities[]{100, 1'000};
+	const unsigned int Warmups = 3;
+	const unsigned int Repetitions = 31;
+	const unsigned int StepMillis = SimulationStepMillis;
+	// The objects tested against every entity by the pairwise kernels.
+	const size_t Probes = 16;
+
+	/**
+	 * @return a looped rectangle of the arena's aspect ratio, centered at the origin, holding the given number of
+	 * entities at the given density
+	 */
+	D2D_RECT_F rectangleFor(size_t entities, double density) {
+		double area = double(entities) / density * 1'000'000;
+		auto width = float(std::sqrt(area * ArenaWidth / ArenaHeight));
+		float height = width * ArenaHeight / ArenaWidth;
+		return {-width / 2, -height / 2, width / 2, height / 2};
+	}
+
+	std::vector<MovementData> randomMovements(size_t count, D2D_RECT_F modulo, std::mt19937 & rng) {
+		std::uniform_real_distribution<float> x(modulo.left, modulo.right), y(modulo.top, modulo.bottom);
+		std::uniform_real_distribution<float> speed(-300, 300), angle(0, 360), spin(-360, 360);
+		std::vector<MovementData> movements{};
+		movements.reserve(count);
+		for (size_t i = 0; i < count; i++) {
+			D2D_POINT_2F location{x(rng), y(rng)};
+			float rotation = angle(rng);
+			D2D_POINT_2F velocity{speed(rng), speed(rng)};
+			movements.emplace_back(location, rotation, velocity, spin(rng));
+		}
+		return movements;
+	}
+
+	class Sweep {
+		std::vector<BenchmarkRecord> records{};
+		size_t entities{};
+		double density{};
+
+	public:
+		/**
+		 * Times the body, which processes all entities of the current configuration once, and records it.
+		 * @param setup runs before every run of the body, untimed
+		 */
+		template <typename Setup, typename Body>
+		void time(const char * kernel, Setup && setup, Body && body) {
+			Timing timing = measureRuns(Warmups, Repetitions, setup, body);
+			records.push_back({kernel, entities, density, Repetitions, timing});
+			std::printf(
+			    "%-36s n = %-8zu density %-6.0f %10.1f us median %10.1f us min %8.2f ns/entity\n",
+			    kernel,
+			    entities,
+			    density,
+			    timing.medianMicros,
+			    timing.minMicros,
+			    timing.medianMicros * 1000 / double(entities)
+			);
+		}
+
+		template <typename Body>
+		void time(const char * kernel, Body && body) {
+			time(kernel, [] {}, body);
+		}
+
+		void runFor(size_t count, double entityDensity) {
+			entities = count;
+			density = entityDensity;
+			D2D_RECT_F modulo = rectangleFor(count, entityDensity);
+			// Every configuration starts from its own seed, whatever ran before.
+			std::mt19937 rng(uint32_t(count * 7 + size_t(entityDensity)));
+			std::vector<MovementData> movements = randomMovements(count, modulo, rng);
+
+			time("MovementData::move", [&] {
+				for (MovementData & movement : movements) {
+					movement.move(StepMillis, modulo);
+				}
+			});
+
+			std::vector<CollidableObject> objects{};
+			objects.reserve(count);
+			for (size_t i = 0; i < count; i++) {
+				objects.emplace_back(i % 2 ? 30.f : 20.f, movements[i], BitmapSegment());
+			}
+			std::vector<CollidableObject> probes{};
+			for (size_t i = 0; i < Probes; i++) {
+				probes.emplace_back(SpaceshipSize, movements[i * count / Probes], BitmapSegment());
+			}
+			volatile float distanceSink = 0;
+			volatile size_t hitSink = 0;
+			time("CollidableObject::squareDistanceFrom", [&] {
+				float sum = 0;
+				for (size_t i = 0; i < count; i++) {
+					sum += objects[i].squareDistanceFrom(probes[i % Probes], modulo);
+				}
+				distanceSink = sum;
+			});
+			time("CollidableObject::collidesWith", [&] {
+				size_t hits = 0;
+				for (size_t i = 0; i < count; i++) {
+					hits += objects[i].collidesWith(probes[i % Probes], modulo);
+				}
+				hitSink = hits;
+			});
+			// The visible part of the arena, as for outer asteroids moving in.
+			D2D_RECT_F inner{modulo.left / 2, modulo.top / 2, modulo.right / 2, modulo.bottom / 2};
+			time("CollidableObject::isInside", [&] {
+				size_t inside = 0;
+				for (const CollidableObject & object : objects) {
+					inside += object.isInside(inner);
+				}
+				hitSink = inside;
+			});
+
+			InputState input{};
+			input.press(Key::Thrust);
+			input.press(Key::TurnRight);
+			std::vector<Spaceship> ships{};
+			ships.reserve(count);
+			for (size_t i = 0; i < count; i++) {
+				ships.emplace_back(
+				    SpaceshipSize,
+				    movements[i],
+				    BitmapSegment(),
+				    SpaceshipHitPoints,
+				    ThrusterData(SpaceshipDeceleration, SpaceshipThrust, SpaceshipTorque),
+				    SpaceshipGunOffset,
+				    SpaceshipGunCooldown,
+				    BitmapSegment()
+				);
+				ships.back().setInput(input);
+			}
+			time("Spaceship::move", [&] {
+				for (Spaceship & ship : ships) {
+					ship.move(StepMillis, modulo);
+				}
+			});
+
+			timeArena(count, modulo);
+		}
+
+		/**
+		 * Times collision checks of an arena of the given rectangle, with asteroids scattered all over it and a
+		 * tenth as many projectiles, among which a crowd loses many to the first check.
+		 */
+		void timeArena(size_t count, D2D_RECT_F modulo) {
+			Random random(uint64_t(count) * 31 + uint64_t(density));
+			auto spaceship = std::make_shared<Spaceship>(
+			    SpaceshipSize,
+			    MovementData(),
+			    BitmapSegment(),
+			    SpaceshipHitPoints,
+			    ThrusterData(SpaceshipDeceleration, SpaceshipThrust, SpaceshipTorque),
+			    SpaceshipGunOffset,
+			    SpaceshipGunCooldown,
+			    BitmapSegment()
+			);
+			float width = modulo.right - modulo.left, height = modulo.bottom - modulo.top;
+			Arena arena(width, height, SpawnAreaMargin, spaceship);
+			size_t projectiles = count / 10;
+			arena.setProjectileCapacity(projectiles);
+			arena.scatterAsteroids(count - projectiles, 20, BitmapSegment(), 50, 50, random);
+			for (size_t i = 0; i < projectiles; i++) {
+				float coordinates[2];
+				random.fill(coordinates, 2, 0, 1);
+				float angle = float(random.next(0, 360)) * RadiansInDegree;
+				MovementData movement(
+				    {modulo.left + width * coordinates[0], modulo.top + height * coordinates[1]},
+				    0,
+				    {ProjectileSpeed * std::cos(angle), ProjectileSpeed * std::sin(angle)},
+				    0
+				);
+				(void)arena.addProjectile(Projectile(ProjectileSize, movement, BitmapSegment(), 50));
+			}
+			// Moves the scattered asteroids into the arena, where projectiles can hit them.
+			arena.move(StepMillis);
+			std::vector<uint8_t> snapshot{};
+			SnapshotWriter writer(snapshot);
+			arena.save(writer);
+
+			// Every run resolves the same collisions from the same state, rebuilding the broadphase first like a move.
+			auto restore = [&] {
+				SnapshotReader reader(snapshot);
+				arena.restore(reader);
+			};
+			time("Arena::checkCollisions", restore, [&] {
+				(void)arena.checkCollisions();
+			});
+		}
+
+		[[nodiscard]] std::vector<BenchmarkRecord> takeRecords() {
+			return std::move(records);
+		}
+	};
+} // namespace
+
+std::vector<BenchmarkRecord> runKernelBenchmark() {
+	Sweep sweep{};
+	for (double density : Densities) {
+		for (size_t count : Counts) {
+			sweep.runFor(count, density);
+		}
+	}
+	return sweep.takeRecords();
+}
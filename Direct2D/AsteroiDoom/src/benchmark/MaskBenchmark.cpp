@@ -0,0 +1,278 @@
+#include "../Game.h"
+#include "../collidable/CollisionMask.h"
+#include "../collidable/SweptCollision.h"
+#include "../collidable/base/CollidableObject.h"
+#include "Benchmark.h"
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+// Checks the collision masks against themselves, tested the other way around, and on edge cases whose overlap is known
+// exactly. Then measures the narrowphase on the pairs of touching circles of a crowded arena, and whole steps of a game
+// with 10k asteroids with and without masks.
+
+namespace {
+	const D2D_RECT_F Modulo{-960, -540, 960, 540};
+	const size_t PairCount = 10'000;
+	const size_t Asteroids = 10'000;
+	const unsigned int Warmups = 3;
+	const unsigned int Repetitions = 20;
+
+	/**
+	 * Draws an opaque shape covering the pixels of the square [-size / 2, size / 2]^2 whose centers are inside.
+	 */
+	template <typename Shape>
+	PixelBuffer rasterize(unsigned int size, Shape && inside) {
+		PixelBuffer pixels(size, size);
+		float half = float(size) / 2;
+		for (unsigned int y = 0; y < size; y++) {
+			for (unsigned int x = 0; x < size; x++) {
+				pixels.row(y)[x] = inside(float(x) + 0.5f - half, float(y) + 0.5f - half) ? 0xFFFFFFFF : 0;
+			}
+		}
+		return pixels;
+	}
+
+	PixelBuffer asteroid(unsigned int size) {
+		float radius = float(size) / 2;
+		return rasterize(size, [&](float x, float y) {
+			return std::hypot(x, y) <= radius * (0.85f + 0.1f * std::sin(5 * std::atan2(y, x)));
+		});
+	}
+
+	/**
+	 * Sprites of the sizes the game draws, with their masks.
+	 */
+	struct Sprites {
+		BitmapHelper bitmaps[4]{};
+		PixelBuffer pixels[4]{};
+		GameSprites game{
+		    {&bitmaps[0], {0, 0, 60, 60}},
+		    {&bitmaps[1], {0, 0, 10, 10}},
+		    {{&bitmaps[2], {0, 0, 40, 40}}, {&bitmaps[3], {0, 0, 60, 60}}}};
+		std::shared_ptr<CollisionMaskSet> masks = std::make_shared<CollisionMaskSet>();
+
+		Sprites() {
+			pixels[0] = rasterize(60, [](float x, float y) {
+				return y <= 25 && std::abs(x) * 2.5f <= y + 25;
+			});
+			pixels[1] = rasterize(10, [](float x, float y) {
+				return std::hypot(x, y) <= 4;
+			});
+			pixels[2] = asteroid(40);
+			pixels[3] = asteroid(60);
+			masks->add(game.spaceship, pixels[0]);
+			masks->add(game.projectile, pixels[1]);
+			masks->add(game.asteroids[0], pixels[2]);
+			masks->add(game.asteroids[1], pixels[3]);
+		}
+	};
+
+	/**
+	 * Pairs of objects whose circles touch, as the broadphase finds them, mostly asteroids with projectiles.
+	 */
+	std::vector<MaskPlacement> generatePairs(const Sprites & sprites, std::mt19937 & rng) {
+		const CollisionMask * asteroidMasks[2]{
+		    sprites.masks->find(sprites.game.asteroids[0]), sprites.masks->find(sprites.game.asteroids[1])};
+		const CollisionMask * projectileMask = sprites.masks->find(sprites.game.projectile);
+		std::uniform_real_distribution<float> x(Modulo.left, Modulo.right), y(Modulo.top, Modulo.bottom);
+		std::uniform_real_distribution<float> unit(0, 1), angle(0, 360);
+		std::vector<MaskPlacement> pairs{};
+		for (size_t pair = 0; pair < PairCount; pair++) {
+			unsigned int type = rng() % 2;
+			MaskPlacement first{asteroidMasks[type], {x(rng), y(rng)}, {0, 0}, angle(rng), type == 0 ? 20.f : 30.f};
+			MaskPlacement second{projectileMask, {}, {4, 0}, angle(rng), 5};
+			if (rng() % 4 == 0) {
+				second = {asteroidMasks[1 - type], {}, {1, 1}, angle(rng), type == 0 ? 30.f : 20.f};
+			}
+			// Anywhere within the sum of the radii, also across the edges of the arena.
+			float distance = (first.size + second.size) * std::sqrt(unit(rng));
+			float direction = angle(rng) * RadiansInDegree;
+			second.location = minimumImage(
+			    {first.location.x + distance * std::cos(direction), first.location.y + distance * std::sin(direction)},
+			    Modulo
+			);
+			pairs.push_back(first);
+			pairs.push_back(second);
+		}
+		return pairs;
+	}
+
+	void verifySymmetry(const Sprites & sprites, std::mt19937 & rng) {
+		std::vector<MaskPlacement> pairs = generatePairs(sprites, rng);
+		size_t mismatches = 0, touching = 0;
+		for (size_t pair = 0; pair < pairs.size(); pair += 2) {
+			const MaskPlacement & first = pairs[pair];
+			const MaskPlacement & second = pairs[pair + 1];
+			D2D_POINT_2F offset = minimumImage(
+			    {second.location.x - first.location.x, second.location.y - first.location.y}, Modulo
+			);
+			size_t forwards = CollisionMask::overlap(*first.mask, first.rotation, *second.mask, second.rotation, offset);
+			size_t backwards = CollisionMask::overlap(
+			    *second.mask, second.rotation, *first.mask, first.rotation, {-offset.x, -offset.y}
+			);
+			mismatches += forwards != backwards;
+			touching += forwards > 0;
+		}
+		expect(
+		    mismatches == 0,
+		    "pixel overlap: both ways",
+		    "%zu of %zu circle pairs touch, %zu mismatches",
+		    touching,
+		    pairs.size() / 2,
+		    mismatches
+		);
+	}
+
+	struct EdgeCase {
+		const char * name{};
+		D2D_POINT_2F first{};
+		D2D_POINT_2F second{};
+		bool touching{};
+	};
+
+	/**
+	 * Two opaque 20x20 squares, unrotated, whose masks are exactly the squares, so that centers 20 apart leave a
+	 * column of pixels between them and centers 19 apart share one.
+	 */
+	const EdgeCase EdgeCases[]{
+	    {"side by side", {0, 0}, {19, 0}, true},
+	    {"1 px apart", {0, 0}, {20, 0}, false},
+	    {"corner to corner", {0, 0}, {19, 19}, true},
+	    {"corners 1 px apart", {0, 0}, {19, 20}, false},
+	    // The same pairs across the edges of the arena, 1920 wide and 1080 high.
+	    {"side by side across the seam", {950, 0}, {-951, 0}, true},
+	    {"1 px apart across the seam", {950, 0}, {-950, 0}, false},
+	    {"corner to corner across both", {950, 530}, {-951, -531}, true},
+	    {"1 px apart across both", {950, 530}, {-950, -531}, false},
+	};
+
+	void verifyEdgeCases() {
+		PixelBuffer square = rasterize(20, [](float, float) {
+			return true;
+		});
+		CollisionMask mask(square, {0, 0, 20, 20});
+		for (const EdgeCase & edgeCase : EdgeCases) {
+			MaskPlacement first{&mask, edgeCase.first, {0, 0}, 0, 10};
+			MaskPlacement second{&mask, edgeCase.second, {0, 0}, 0, 10};
+			bool touching = pixelsTouch(first, second, 0, Modulo);
+			expect(
+			    touching == edgeCase.touching && pixelsTouch(second, first, 0, Modulo) == touching,
+			    "pixel overlap",
+			    "%s: %s, expected %s",
+			    edgeCase.name,
+			    touching ? "touching" : "apart",
+			    edgeCase.touching ? "touching" : "apart"
+			);
+		}
+	}
+
+	/**
+	 * Rotations are rounded to the nearest of 64 steps of 5.625 degrees, modulo 360, so that a bar rotated by any
+	 * rotation rounding to the same step covers exactly the same pixels, and by any other covers different ones.
+	 */
+	void verifyRotationSteps() {
+		PixelBuffer bar = rasterize(40, [](float, float y) {
+			return std::abs(y) <= 4;
+		});
+		CollisionMask mask(bar, {0, 0, 40, 40});
+		struct {
+			float first;
+			float second;
+			bool same;
+		} const cases[]{
+		    {0, 359.9f, true},
+		    {0, 360, true},
+		    {0, 720, true},
+		    {0, -0.1f, true},
+		    {0, 2.8f, true},
+		    {0, 2.9f, false},
+		    {0, 357.2f, true},
+		    {0, 357.1f, false},
+		    {357, -3, true},
+		    {354.5f, -5.5f, true},
+		};
+		for (const auto & rotations : cases) {
+			size_t area = mask.getArea(rotations.first);
+			size_t overlap = CollisionMask::overlap(mask, rotations.first, mask, rotations.second, {0, 0});
+			bool same = overlap == area && mask.getArea(rotations.second) == area;
+			expect(
+			    same == rotations.same,
+			    "pixel overlap: rotation steps",
+			    "%g and %g degrees share %zu of %zu pixels, expected %s",
+			    double(rotations.first),
+			    double(rotations.second),
+			    overlap,
+			    area,
+			    rotations.same ? "all" : "fewer"
+			);
+		}
+	}
+
+	void measurePairs(const Sprites & sprites, std::mt19937 & rng) {
+		std::vector<MaskPlacement> pairs = generatePairs(sprites, rng);
+		volatile size_t sink = 0;
+		double circleMicros = measure(Repetitions, [&] {
+			size_t hits = 0;
+			for (size_t pair = 0; pair < pairs.size(); pair += 2) {
+				hits += CollidableObject::collide(
+				    pairs[pair].location, pairs[pair].size, pairs[pair + 1].location, pairs[pair + 1].size, Modulo
+				);
+			}
+			sink = hits;
+		});
+		double pixelMicros = measure(Repetitions, [&] {
+			size_t hits = 0;
+			for (size_t pair = 0; pair < pairs.size(); pair += 2) {
+				hits += pixelsTouch(pairs[pair], pairs[pair + 1], 0, Modulo);
+			}
+			sink = hits;
+		});
+		(void)sink;
+		report("circles -> pixel masks", PairCount, circleMicros, pixelMicros);
+		std::printf("%-32s %.1f ns per pair\n", "pixel masks", pixelMicros * 1000 / double(PairCount));
+	}
+
+	void measureSteps(const Sprites & sprites) {
+		InputState input{};
+		input.press(Key::TurnRight);
+		input.press(Key::Shoot);
+		Game game(sprites.game, 2024);
+		game.scatterAsteroids(Asteroids);
+		for (int step = 0; step < 100; step++) {
+			game.step(SimulationStepMillis, input);
+		}
+		std::vector<uint8_t> snapshot{};
+		game.save(snapshot);
+
+		// The same step from the same state, restored untimed, so that the difference is the narrowphase.
+		auto restore = [&] {
+			game.restore(snapshot);
+		};
+		double micros[2]{};
+		for (int masked = 0; masked < 2; masked++) {
+			game.setCollisionMasks(masked ? sprites.masks : nullptr);
+			micros[masked] = measureRuns(Warmups, Repetitions, restore, [&] {
+				game.step(SimulationStepMillis, input);
+			}).medianMicros;
+		}
+		report("game step, circles -> masks", Asteroids, micros[0], micros[1]);
+	}
+} // namespace
+
+void checkMasks() {
+	std::mt19937 rng(22);
+	Sprites sprites{};
+	verifySymmetry(sprites, rng);
+	verifyEdgeCases();
+	verifyRotationSteps();
+}
+
+void runMaskBenchmark() {
+	std::mt19937 rng(22);
+	Sprites sprites{};
+	measurePairs(sprites, rng);
+	measureSteps(sprites);
+}
@@ -0,0 +1,115 @@
+#include "../collidable/Arena.h"
+#include "../utils/DrawBackend.h"
+#include "../utils/Random.h"
+#include "../utils/ThreadPool.h"
+#include "Benchmark.h"
+
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Checks that moving an arena, with a swarm of ships steered among its asteroids, on the thread pool gives
+// bit-identical results to moving it serially, then compares their speed.
+
+namespace {
+	const float Width = 1920;
+	const float Height = 1080;
+	const float Margin = 200;
+	const float Infinity = std::numeric_limits<float>::infinity();
+	const D2D_RECT_F Everywhere{-Infinity, -Infinity, Infinity, Infinity};
+	const unsigned int StepMillis = 4;
+	const unsigned int Steps = 200;
+	const unsigned int Repetitions = 50;
+	const size_t AsteroidsPerShip = 10;
+
+	/**
+	 * Records where every sprite is drawn, which captures the location and rotation of every object.
+	 */
+	class RecordingDrawBackend final : public DrawBackend {
+	public:
+		std::vector<float> values{};
+
+		void drawSprite(const BitmapSegment &, D2D_POINT_2F location, float rotation) override {
+			values.insert(values.end(), {location.x, location.y, rotation});
+		}
+	};
+
+	Arena makeArena(size_t asteroids, size_t parallelMoveThreshold) {
+		// Both arenas get the same asteroids.
+		Random random(2024);
+		auto spaceship = std::make_shared<Spaceship>(
+		    25, MovementData(), BitmapSegment(), 100, ThrusterData(), 20, 250, BitmapSegment()
+		);
+		Arena arena(Width, Height, Margin, spaceship);
+		arena.setParallelMoveThreshold(parallelMoveThreshold);
+		for (size_t i = 0; i < asteroids; i++) {
+			arena.spawnAsteroid(i % 2 ? 30.f : 20.f, BitmapSegment(), 50, 50, random);
+		}
+		Swarm swarm(
+		    std::make_shared<DogfightController>(Pursuit{10, 150, 450}),
+		    ThrusterData(0.1f, 600, 400),
+		    20,
+		    250,
+		    BitmapSegment()
+		);
+		swarm.spawn(asteroids / AsteroidsPerShip, 25, BitmapSegment(), 100, arena.getRectangle(), random);
+		arena.setSwarm(std::move(swarm));
+		return arena;
+	}
+
+	/**
+	 * The same arena twice, one moving serially and one on the thread pool, after the given number of steps.
+	 */
+	std::pair<Arena, Arena> makeArenas(size_t asteroids, unsigned int steps) {
+		std::pair<Arena, Arena> arenas{makeArena(asteroids, std::numeric_limits<size_t>::max()), makeArena(asteroids, 0)};
+		for (unsigned int step = 0; step < steps; step++) {
+			arenas.first.move(StepMillis);
+			arenas.second.move(StepMillis);
+		}
+		return arenas;
+	}
+
+	void runFor(size_t asteroids) {
+		auto [serial, parallel] = makeArenas(asteroids, Steps);
+
+		double serialMicros = measure(Repetitions, [&] {
+			serial.move(StepMillis);
+		});
+		double parallelMicros = measure(Repetitions, [&] {
+			parallel.move(StepMillis);
+		});
+		report("arena move: serial -> parallel", asteroids, serialMicros, parallelMicros);
+	}
+} // namespace
+
+void checkParallelMove() {
+	for (size_t asteroids : {10'000, 100'000}) {
+		auto [serial, parallel] = makeArenas(asteroids, Steps);
+		RecordingDrawBackend serialState{}, parallelState{};
+		serial.draw(serialState, 1, Everywhere);
+		parallel.draw(parallelState, 1, Everywhere);
+		bool identical = serialState.values.size() == parallelState.values.size() &&
+		                 std::memcmp(
+		                     serialState.values.data(),
+		                     parallelState.values.data(),
+		                     serialState.values.size() * sizeof(float)
+		                 ) == 0;
+		expect(
+		    identical,
+		    "parallel move",
+		    "%zu asteroids after %u steps on %zu threads, bitwise like the serial move",
+		    asteroids,
+		    Steps,
+		    ThreadPool::shared().getThreadCount()
+		);
+	}
+}
+
+void runMoveBenchmark() {
+	std::printf("parallel move on %zu threads\n", ThreadPool::shared().getThreadCount());
+	for (size_t asteroids : {10'000, 100'000}) {
+		runFor(asteroids);
+	}
+}
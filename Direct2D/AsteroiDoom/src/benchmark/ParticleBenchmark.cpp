@@ -0,0 +1,226 @@
+#include "../collidable/ParticleSystem.h"
+#include "../utils/AsteroiDoomConstants.h"
+#include "../utils/DrawBackend.h"
+#include "../utils/Random.h"
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+// Checks that moving particles with SIMD gives exactly the results of moving them one by one. Then runs frames with
+// 100k and more particles alive, as the window would: the steps of a 60 Hz frame, each emitting as many particles as
+// expired and moving them, then recording them into a sorted DrawCommandList. The same frames with a heap object per
+// particle show what the archetype saves.
+
+namespace {
+	// Particles loop around the spawn area, as in the game.
+	const D2D_RECT_F Modulo{
+	    -ArenaWidth / 2 - SpawnAreaMargin,
+	    -ArenaHeight / 2 - SpawnAreaMargin,
+	    ArenaWidth / 2 + SpawnAreaMargin,
+	    ArenaHeight / 2 + SpawnAreaMargin};
+	// Only the particles on the screen are drawn.
+	const D2D_RECT_F Screen{-ArenaWidth / 2, -ArenaHeight / 2, ArenaWidth / 2, ArenaHeight / 2};
+	const size_t Counts[]{100'000, 200'000};
+	const unsigned int Frames = 60;
+	// A 60 Hz frame simulates four or five steps, see FrameBudgetMillis.
+	const unsigned int StepsPerFrame = 5;
+	const unsigned int Repetitions = 20;
+	const unsigned int MinTimeToLive = 300;
+	const unsigned int MaxTimeToLive = 900;
+	// Long enough to outlive every repetition, so that moves only ever move.
+	const unsigned int Forever = 1'000'000;
+
+	BitmapHelper ParticleBitmap{};
+	const BitmapSegment ParticleSprite{&ParticleBitmap, {0, 0, 10, 10}};
+
+	MovementData randomParticle(Random & random) {
+		float values[6];
+		random.fill(values, 6, 0, 1);
+		return {
+		    {Modulo.left + values[0] * (Modulo.right - Modulo.left), Modulo.top + values[1] * (Modulo.bottom - Modulo.top)},
+		    values[2] * 360,
+		    {values[3] * 400 - 200, values[4] * 400 - 200},
+		    values[5] * 1440 - 720};
+	}
+
+	/**
+	 * The naive way: every particle a heap object of its own, removed by erasing it from the middle of the list.
+	 */
+	class HeapParticles {
+		struct Particle {
+			MovementData movement;
+			unsigned int timeToLive;
+		};
+
+		std::vector<std::unique_ptr<Particle>> particles{};
+
+	public:
+		void emit(MovementData movement, unsigned int timeToLive) {
+			particles.push_back(std::make_unique<Particle>(Particle{movement, timeToLive}));
+		}
+
+		void move(unsigned int millis, D2D_RECT_F modulo) {
+			std::erase_if(particles, [millis](const std::unique_ptr<Particle> & particle) {
+				return particle->timeToLive <= millis;
+			});
+			for (const std::unique_ptr<Particle> & particle : particles) {
+				particle->timeToLive -= millis;
+				particle->movement.move(millis, modulo);
+			}
+		}
+
+		void draw(DrawBackend & backend, D2D_RECT_F visibleRectangle) const {
+			float radius = ParticleSprite.getBoundingRadius();
+			for (const std::unique_ptr<Particle> & particle : particles) {
+				auto [x, y] = particle->movement.location;
+				if (visibleRectangle.left <= x + radius && x - radius <= visibleRectangle.right &&
+				    visibleRectangle.top <= y + radius && y - radius <= visibleRectangle.bottom) {
+					backend.drawSprite(ParticleSprite, particle->movement.location, particle->movement.rotation);
+				}
+			}
+		}
+
+		[[nodiscard]] size_t size() const {
+			return particles.size();
+		}
+	};
+
+	/**
+	 * Counts the sprites drawn, and the ones among them which show on the screen.
+	 */
+	class VisibleCountingBackend final : public DrawBackend {
+	public:
+		size_t drawCount{};
+		size_t visibleCount{};
+
+		void drawSprite(const BitmapSegment & sprite, D2D_POINT_2F location, float) override {
+			float radius = sprite.getBoundingRadius();
+			drawCount++;
+			visibleCount += Screen.left <= location.x + radius && location.x - radius <= Screen.right &&
+			                Screen.top <= location.y + radius && location.y - radius <= Screen.bottom;
+		}
+	};
+
+	/**
+	 * Emits particles until the given number are alive, drawing the same random numbers for any kind of particles.
+	 */
+	template <typename Particles>
+	void refill(Particles & particles, size_t count, Random & random) {
+		while (particles.size() < count) {
+			MovementData movement = randomParticle(random);
+			particles.emit(movement, random.next(MinTimeToLive, MaxTimeToLive));
+		}
+	}
+
+	template <typename Particles>
+	void runFrame(Particles & particles, size_t count, Random & random, DrawCommandList & commands) {
+		for (unsigned int step = 0; step < StepsPerFrame; step++) {
+			refill(particles, count, random);
+			particles.move(SimulationStepMillis, Modulo);
+		}
+		commands.clear();
+		particles.draw(commands, Screen);
+		commands.sortByBitmap();
+	}
+
+	void measureMoves(size_t count) {
+		ParticleSystem particles(count, ParticleSprite);
+		Random random(25);
+		for (size_t particle = 0; particle < count; particle++) {
+			particles.emit(randomParticle(random), Forever);
+		}
+		double micros[2]{};
+		for (bool vectorized : {false, true}) {
+			particles.setVectorized(vectorized);
+			micros[vectorized] = measure(Repetitions, [&] {
+				particles.move(SimulationStepMillis, Modulo);
+			});
+		}
+		report("particle move: scalar -> SIMD", count, micros[0], micros[1]);
+	}
+
+	void measureFrames(size_t count) {
+		ParticleSystem particles(count, ParticleSprite);
+		HeapParticles heapParticles{};
+		Random random(25), heapRandom(25);
+		DrawCommandList commands{}, heapCommands{};
+		// Lets the particles reach a steady state of dying and being replaced before timing.
+		for (unsigned int frame = 0; frame < 60; frame++) {
+			runFrame(particles, count, random, commands);
+			runFrame(heapParticles, count, heapRandom, heapCommands);
+		}
+
+		double heapMicros = measure(Frames, [&] {
+			runFrame(heapParticles, count, heapRandom, heapCommands);
+		});
+		double worstMillis = 0;
+		double micros = measure(Frames, [&] {
+			auto start = std::chrono::steady_clock::now();
+			runFrame(particles, count, random, commands);
+			double millis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			worstMillis = std::max<double>(worstMillis, millis);
+		});
+		report("particles: heap -> archetype", count, heapMicros, micros);
+		std::printf(
+		    "%-32s %.2f ms per frame, at most %.2f ms, of a %.1f ms budget, %zu of %zu drawn in %zu batches\n",
+		    "particle frame",
+		    micros / 1000,
+		    worstMillis,
+		    FrameBudgetMillis,
+		    commands.size(),
+		    particles.size(),
+		    commands.getBatches().size()
+		);
+	}
+} // namespace
+
+void checkParticles() {
+	ParticleSystem vectorized(Counts[0], ParticleSprite), scalar(Counts[0], ParticleSprite);
+	scalar.setVectorized(false);
+	Random first(25), second(25);
+	for (unsigned int step = 0; step < 300; step++) {
+		refill(vectorized, Counts[0], first);
+		refill(scalar, Counts[0], second);
+		vectorized.move(SimulationStepMillis, Modulo);
+		scalar.move(SimulationStepMillis, Modulo);
+	}
+	auto locations = vectorized.entities().column<Location>();
+	auto scalarLocations = scalar.entities().column<Location>();
+	auto rotations = vectorized.entities().column<Rotation>();
+	auto scalarRotations = scalar.entities().column<Rotation>();
+	size_t mismatches = vectorized.size() == scalar.size() ? 0 : vectorized.size();
+	for (size_t particle = 0; particle < std::min<size_t>(vectorized.size(), scalar.size()); particle++) {
+		mismatches += locations[particle].value.x != scalarLocations[particle].value.x ||
+		              locations[particle].value.y != scalarLocations[particle].value.y ||
+		              rotations[particle].value != scalarRotations[particle].value;
+	}
+	expect(
+	    mismatches == 0,
+	    "particle SIMD",
+	    "%zu particles after 300 steps, %zu mismatches",
+	    vectorized.size(),
+	    mismatches
+	);
+
+	VisibleCountingBackend everything{}, culled{};
+	vectorized.draw(everything, Modulo);
+	vectorized.draw(culled, Screen);
+	expect(
+	    culled.drawCount == culled.visibleCount && culled.visibleCount == everything.visibleCount,
+	    "particle culling",
+	    "%zu of %zu particles drawn, %zu show on the screen",
+	    culled.drawCount,
+	    everything.drawCount,
+	    everything.visibleCount
+	);
+}
+
+void runParticleBenchmark() {
+	for (size_t count : Counts) {
+		measureMoves(count);
+		measureFrames(count);
+	}
+}
@@ -0,0 +1,188 @@
+#include "../utils/Random.h"
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <vector>
+
+// Checks that bounded integers are unbiased where taking a modulo is not, that they are uniform, that filled floats
+// stay below their upper bound, and that jumps and splits give the streams they promise. Then compares drawing bounded
+// integers and floats from std::mt19937, as Random used to, with the xoshiro128** generator.
+
+namespace {
+	const unsigned int Repetitions = 50;
+
+	// Takes 3 / 4 of all 32 bit values, so that a modulo hits the lowest third twice as often as the rest.
+	const unsigned int SkewedRange = 3u << 30;
+	const unsigned int LowestThird = 1u << 30;
+
+	void checkBias(size_t count) {
+		std::mt19937 rng{2024};
+		Random random(2024);
+		size_t legacyLow = 0, lemireLow = 0;
+		for (size_t i = 0; i < count; i++) {
+			legacyLow += rng() % SkewedRange < LowestThird;
+			lemireLow += random.next(0, SkewedRange) < LowestThird;
+		}
+		// Over 4 standard deviations of the share of a million draws.
+		double share = double(lemireLow) / double(count);
+		expect(
+		    std::abs(share - 1. / 3) < 0.002,
+		    "bounded integers: bias",
+		    "%.4f in the lowest third of the range, modulo %.4f, expected 0.3333",
+		    share,
+		    double(legacyLow) / double(count)
+		);
+	}
+
+	/**
+	 * Pearson's chi-squared test of the results of next(0, 360) being equally likely.
+	 */
+	void checkUniformity() {
+		const unsigned int bins = 360, perBin = 10'000;
+		Random random(2024);
+		std::vector<unsigned int> counts(bins);
+		for (unsigned int i = 0; i < bins * perBin; i++) {
+			counts[random.next(0, bins)]++;
+		}
+		double chiSquared = 0;
+		for (unsigned int count : counts) {
+			chiSquared += (double(count) - perBin) * (double(count) - perBin) / perBin;
+		}
+		// 359 degrees of freedom have a mean of 359 and a standard deviation of 26.8, so this is 5 of them above.
+		expect(chiSquared < 493, "bounded integers: uniformity", "chi-squared %.1f of 359 degrees of freedom", chiSquared);
+	}
+
+	/**
+	 * Draws 2^26 floats in [1, 2), where the largest draw, 1 + (1 - 2^-24), would round to 2.
+	 */
+	void checkFillRange() {
+		Random random(2024);
+		std::vector<float> values(1 << 20);
+		float lowest = 2, highest = 1;
+		for (int chunk = 0; chunk < 64; chunk++) {
+			random.fill(values.data(), values.size(), 1, 2);
+			auto [minimum, maximum] = std::minmax_element(values.begin(), values.end());
+			lowest = std::min<float>(lowest, *minimum);
+			highest = std::max<float>(highest, *maximum);
+		}
+		expect(1 <= lowest && highest < 2, "floats: range", "[1, 2) filled with [%.9g, %.9g]", lowest, highest);
+	}
+
+	/**
+	 * Compares the numbers after a jump with the ones after 2^64 steps, computed apart from Random by raising the
+	 * linear transition of the xoshiro128** state over GF(2) to the 2^64th power, for the state seed 12 gives.
+	 */
+	void checkJump() {
+		const uint32_t expected[4]{0x51d9cddc, 0x7af7e531, 0xbb5cc16a, 0xa9697a67};
+		Random random(12);
+		random.jump();
+		uint32_t actual[4]{};
+		for (uint32_t & number : actual) {
+			number = random.next();
+		}
+		expect(
+		    std::equal(std::begin(actual), std::end(actual), std::begin(expected)),
+		    "jump",
+		    "%08x %08x %08x %08x after 2^64 steps, expected %08x %08x %08x %08x",
+		    actual[0],
+		    actual[1],
+		    actual[2],
+		    actual[3],
+		    expected[0],
+		    expected[1],
+		    expected[2],
+		    expected[3]
+		);
+	}
+
+	/**
+	 * Splits streams off a generator, each of which must continue where the generator was, while the generator jumps
+	 * ahead. No two consecutive numbers of any stream may show up in another one within the first million.
+	 */
+	void checkSplit() {
+		const size_t streams = 4, count = 1 << 20;
+		Random parent(2024);
+		std::vector<std::vector<uint32_t>> numbers(streams + 1);
+		size_t continued = 0;
+		for (size_t stream = 0; stream < streams; stream++) {
+			Random before = parent;
+			Random split = parent.split();
+			Random jumped = before;
+			jumped.jump();
+			continued += Random(split).next() == before.next() && Random(parent).next() == jumped.next();
+			numbers[stream].resize(count);
+			for (uint32_t & number : numbers[stream]) {
+				number = split.next();
+			}
+		}
+		numbers[streams].resize(count);
+		for (uint32_t & number : numbers[streams]) {
+			number = parent.next();
+		}
+
+		std::vector<uint64_t> pairs{};
+		for (const std::vector<uint32_t> & stream : numbers) {
+			for (size_t i = 0; i + 1 < stream.size(); i++) {
+				pairs.push_back(uint64_t(stream[i]) << 32 | stream[i + 1]);
+			}
+		}
+		std::sort(pairs.begin(), pairs.end());
+		auto repeated = size_t(pairs.end() - std::unique(pairs.begin(), pairs.end()));
+		expect(
+		    repeated == 0 && continued == streams,
+		    "split",
+		    "%zu of %zu streams continue their parent, which jumped, %zu pairs of numbers repeated",
+		    continued,
+		    streams,
+		    repeated
+		);
+	}
+
+	void runFor(size_t count) {
+		std::vector<unsigned int> integers(count);
+		std::vector<float> floats(count);
+		std::mt19937 rng{2024};
+		Random random(2024);
+
+		double legacyIntegerMicros = measure(Repetitions, [&] {
+			for (auto & integer : integers) {
+				integer = rng() % 360;
+			}
+		});
+		double integerMicros = measure(Repetitions, [&] {
+			for (auto & integer : integers) {
+				integer = random.next(0, 360);
+			}
+		});
+		report("bounded ints: mt19937 -> xoshiro", count, legacyIntegerMicros, integerMicros);
+
+		std::uniform_real_distribution<float> distribution(-300, 300);
+		double legacyFloatMicros = measure(Repetitions, [&] {
+			for (auto & value : floats) {
+				value = distribution(rng);
+			}
+		});
+		double floatMicros = measure(Repetitions, [&] {
+			random.fill(floats.data(), floats.size(), -300, 300);
+		});
+		report("floats: mt19937 -> xoshiro fill", count, legacyFloatMicros, floatMicros);
+	}
+} // namespace
+
+void checkRandom() {
+	checkBias(1'000'000);
+	checkUniformity();
+	checkFillRange();
+	checkJump();
+	checkSplit();
+}
+
+void runRandomBenchmark() {
+	for (size_t count : {1'000, 100'000}) {
+		runFor(count);
+	}
+}
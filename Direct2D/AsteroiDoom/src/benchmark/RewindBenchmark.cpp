@@ -0,0 +1,169 @@
+#include "../Game.h"
+#include "../utils/RewindBuffer.h"
+#include "../utils/Snapshot.h"
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// Checks that a restored game goes on exactly like the original one, and that a rewind buffer gives back every
+// snapshot it was given. Measures taking and restoring snapshots of a game with many entities, and their delta
+// compression in the buffer.
+
+namespace {
+	const unsigned int Repetitions = 50;
+	// A frame's worth of steps between snapshots, like the window takes them.
+	const unsigned int StepsPerSnapshot = 4;
+	const size_t Keyframes = 4;
+	const size_t DeltasPerKeyframe = 29;
+
+	void step(Game & game, unsigned int steps) {
+		InputState input{};
+		input.press(Key::Thrust);
+		input.press(Key::TurnRight);
+		input.press(Key::Shoot);
+		for (unsigned int i = 0; i < steps; i++) {
+			game.step(SimulationStepMillis, input);
+		}
+	}
+
+	void printCost(const char * name, size_t entities, double micros) {
+		std::printf("%-32s n = %-8zu %10.1f us\n", name, entities, micros);
+	}
+
+	/**
+	 * Fills the buffer past its capacity, so that the oldest groups are replaced, with snapshots a frame apart.
+	 * @return the snapshots the buffer should keep, the last ones
+	 */
+	std::vector<std::vector<uint8_t>> fill(RewindBuffer & buffer, Game & game) {
+		size_t snapshots = (Keyframes + 1) * (DeltasPerKeyframe + 1);
+		std::vector<std::vector<uint8_t>> kept{};
+		std::vector<uint8_t> snapshot{};
+		for (size_t frame = 0; frame < snapshots; frame++) {
+			step(game, StepsPerSnapshot);
+			game.save(snapshot);
+			buffer.push(snapshot);
+			kept.push_back(snapshot);
+		}
+		kept.erase(kept.begin(), kept.end() - std::ptrdiff_t(buffer.size()));
+		return kept;
+	}
+
+	void runFor(size_t asteroids) {
+		Game game(GameSprites{}, 2024);
+		game.scatterAsteroids(asteroids);
+		step(game, 100);
+		size_t entities = game.getArena().getAsteroidCount() + game.getArena().getProjectileCount() + 1;
+
+		std::vector<uint8_t> snapshot{}, later{};
+		game.save(snapshot);
+		step(game, 250);
+
+		double saveMicros = measure(Repetitions, [&] {
+			game.save(later);
+		});
+		double restoreMicros = measure(Repetitions, [&] {
+			game.restore(snapshot);
+		});
+
+		// Snapshots a frame apart, as a rewind buffer stores them.
+		game.restore(snapshot);
+		step(game, StepsPerSnapshot);
+		game.save(later);
+		std::vector<uint8_t> delta{};
+		double encodeMicros = measure(Repetitions, [&] {
+			delta.clear();
+			encodeDelta(snapshot, later, delta);
+		});
+		std::vector<uint8_t> decoded{};
+		double applyMicros = measure(Repetitions, [&] {
+			decoded = snapshot;
+			applyDelta(decoded, delta);
+		});
+
+		printCost("rewind: save snapshot", entities, saveMicros);
+		printCost("rewind: restore snapshot", entities, restoreMicros);
+		printCost("rewind: encode frame delta", entities, encodeMicros);
+		printCost("rewind: apply frame delta", entities, applyMicros);
+		std::printf(
+		    "%-32s n = %-8zu %10zu B  -> %10zu B  (%.2fx)\n",
+		    "rewind: snapshot -> frame delta",
+		    entities,
+		    later.size(),
+		    delta.size(),
+		    double(later.size()) / double(delta.size())
+		);
+
+		RewindBuffer buffer(Keyframes, DeltasPerKeyframe);
+		game.restore(snapshot);
+		size_t rawBytes = 0;
+		for (const std::vector<uint8_t> & kept : fill(buffer, game)) {
+			rawBytes += kept.size();
+		}
+
+		// The last snapshot of a group needs every delta of the group applied, unless the one before it was read.
+		size_t checksum = 0;
+		double worstMicros = measure(Repetitions, [&] {
+			checksum += buffer.at(0).size();
+			checksum += buffer.at(DeltasPerKeyframe).size();
+		});
+		double scrubMicros = measure(Repetitions, [&] {
+			for (size_t index = 0; index <= DeltasPerKeyframe; index++) {
+				checksum += buffer.at(index).size();
+			}
+		});
+		volatile size_t sink = checksum;
+		(void)sink;
+		printCost("rewind: seek to a group's end", entities, worstMicros);
+		printCost("rewind: scrub a snapshot forward", entities, scrubMicros / double(DeltasPerKeyframe + 1));
+		std::printf(
+		    "%-32s n = %-8zu %10zu B  -> %10zu B  (%.2fx) for %zu snapshots\n",
+		    "rewind: buffered bytes",
+		    entities,
+		    rawBytes,
+		    buffer.getStoredBytes(),
+		    double(rawBytes) / double(buffer.getStoredBytes()),
+		    buffer.size()
+		);
+	}
+} // namespace
+
+void checkRewind() {
+	Game game(GameSprites{}, 2024);
+	game.scatterAsteroids(1000);
+	step(game, 100);
+	std::vector<uint8_t> snapshot{}, later{}, replayed{};
+	game.save(snapshot);
+	step(game, 250);
+	game.save(later);
+	game.restore(snapshot);
+	step(game, 250);
+	game.save(replayed);
+	expect(replayed == later, "rewind: restore", "a restored game goes on like the original one for 250 steps");
+
+	game.restore(snapshot);
+	step(game, StepsPerSnapshot);
+	game.save(later);
+	std::vector<uint8_t> delta{}, decoded = snapshot;
+	encodeDelta(snapshot, later, delta);
+	applyDelta(decoded, delta);
+	expect(
+	    decoded == later, "rewind: frame delta", "%zu B decoded back into a %zu B snapshot", delta.size(), later.size()
+	);
+
+	RewindBuffer buffer(Keyframes, DeltasPerKeyframe);
+	game.restore(snapshot);
+	std::vector<std::vector<uint8_t>> kept = fill(buffer, game);
+	size_t mismatches = buffer.size() == kept.size() && !kept.empty() ? 0 : kept.size() + 1;
+	for (size_t index = 0; index < std::min<size_t>(buffer.size(), kept.size()); index++) {
+		auto bytes = buffer.at(index);
+		mismatches += !std::equal(bytes.begin(), bytes.end(), kept[index].begin(), kept[index].end());
+	}
+	expect(mismatches == 0, "rewind: buffer", "%zu of %zu snapshots differ when read back", mismatches, buffer.size());
+}
+
+void runRewindBenchmark() {
+	runFor(1000);
+	runFor(10000);
+}
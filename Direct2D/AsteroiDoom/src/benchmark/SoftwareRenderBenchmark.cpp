@@ -0,0 +1,144 @@
+#include "../utils/Random.h"
+#include "../utils/SoftwareRenderer.h"
+#include "../utils/ThreadPool.h"
+#include "Benchmark.h"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+// Checks that blending with SIMD and rasterizing tiles in parallel give the same pixels as blending one channel at a
+// time on one thread. Then renders frames of rotated, translated sprites on the CPU and reports sprites per second.
+
+namespace {
+	const unsigned int Width = 1920;
+	const unsigned int Height = 1080;
+	const unsigned int Repetitions = 5;
+	const size_t Never = std::numeric_limits<size_t>::max();
+
+	/**
+	 * A sheet of two discs side by side, fading out towards their edges, so that blending sees every alpha.
+	 */
+	PixelBuffer makeSheet() {
+		PixelBuffer sheet(100, 60);
+		for (unsigned int y = 0; y < 60; y++) {
+			for (unsigned int x = 0; x < 100; x++) {
+				// A disc of diameter 40 on the left, and of 60 on the right.
+				float radius = x < 40 ? 20.f : 30.f;
+				float centerX = x < 40 ? 20.f : 70.f;
+				float distance = std::hypot(float(x) + 0.5f - centerX, float(y) + 0.5f - 30) / radius;
+				float coverage = distance >= 1 ? 0 : 1 - distance * distance;
+				auto alpha = uint32_t(coverage * 255);
+				uint32_t red = alpha * 200 / 255, green = alpha * 150 / 255, blue = alpha * 100 / 255;
+				sheet.row(y)[x] = alpha << 24 | red << 16 | green << 8 | blue;
+			}
+		}
+		return sheet;
+	}
+
+	std::vector<SoftwareRenderer::Sprite> makeSprites(size_t count, const PixelBuffer & sheet, Random & random) {
+		std::vector<SoftwareRenderer::Sprite> sprites{};
+		for (size_t i = 0; i < count; i++) {
+			D2D_RECT_F segment = i % 2 ? D2D_RECT_F{40, 0, 100, 60} : D2D_RECT_F{0, 10, 40, 50};
+			float location[2];
+			random.fill(location, 2, 0, 1);
+			sprites.push_back(
+			    {&sheet,
+			     segment,
+			     {location[0] * Width, location[1] * Height},
+			     random.nextFloat() * 360,
+			     0.5f + random.nextFloat() / 2}
+			);
+		}
+		return sprites;
+	}
+
+	void renderAll(
+	    SoftwareRenderer & renderer, const std::vector<SoftwareRenderer::Sprite> & sprites, PixelBuffer & frame
+	) {
+		frame.fill(0xFF000000);
+		for (const auto & sprite : sprites) {
+			renderer.draw(sprite);
+		}
+		renderer.render(frame);
+	}
+
+	size_t countMismatches(const PixelBuffer & expected, const PixelBuffer & actual) {
+		size_t mismatches = 0;
+		for (unsigned int y = 0; y < Height; y++) {
+			for (unsigned int x = 0; x < Width; x++) {
+				mismatches += expected.row(y)[x] != actual.row(y)[x];
+			}
+		}
+		return mismatches;
+	}
+
+	/**
+	 * Blending one channel at a time on one thread, with SIMD on one thread, and with SIMD on all threads.
+	 */
+	struct Renderers {
+		SoftwareRenderer scalar{};
+		SoftwareRenderer vectorized{};
+		SoftwareRenderer parallel{};
+
+		Renderers() {
+			scalar.setVectorized(false);
+			scalar.setParallelThreshold(Never);
+			vectorized.setParallelThreshold(Never);
+			parallel.setParallelThreshold(0);
+		}
+	};
+
+	void runFor(size_t count, const PixelBuffer & sheet, Random & random) {
+		std::vector<SoftwareRenderer::Sprite> sprites = makeSprites(count, sheet, random);
+		PixelBuffer actual(Width, Height);
+		Renderers renderers{};
+		SoftwareRenderer & scalar = renderers.scalar;
+		SoftwareRenderer & vectorized = renderers.vectorized;
+		SoftwareRenderer & parallel = renderers.parallel;
+
+		double scalarMicros = measure(Repetitions, [&] {
+			renderAll(scalar, sprites, actual);
+		});
+		double vectorizedMicros = measure(Repetitions, [&] {
+			renderAll(vectorized, sprites, actual);
+		});
+		double parallelMicros = measure(Repetitions, [&] {
+			renderAll(parallel, sprites, actual);
+		});
+		report("software sprites: scalar -> SIMD", count, scalarMicros, vectorizedMicros);
+		report("software sprites: 1 -> all threads", count, vectorizedMicros, parallelMicros);
+		std::printf(
+		    "%-32s n = %-8zu %10.0f    -> %10.0f    sprites/s on %zu threads\n",
+		    "software sprites per second",
+		    count,
+		    double(count) / scalarMicros * 1e6,
+		    double(count) / parallelMicros * 1e6,
+		    ThreadPool::shared().getThreadCount()
+		);
+	}
+} // namespace
+
+void checkSoftwareRenderer() {
+	Random random(2024);
+	PixelBuffer sheet = makeSheet();
+	std::vector<SoftwareRenderer::Sprite> sprites = makeSprites(1000, sheet, random);
+	PixelBuffer expected(Width, Height), actual(Width, Height);
+	Renderers renderers{};
+	renderAll(renderers.scalar, sprites, expected);
+
+	renderAll(renderers.vectorized, sprites, actual);
+	size_t mismatches = countMismatches(expected, actual);
+	expect(mismatches == 0, "software SIMD blending", "%zu pixels differ from scalar blending", mismatches);
+
+	renderAll(renderers.parallel, sprites, actual);
+	mismatches = countMismatches(expected, actual);
+	expect(mismatches == 0, "software parallel tiles", "%zu pixels differ from a single thread", mismatches);
+}
+
+void runSoftwareRenderBenchmark() {
+	Random random(2024);
+	PixelBuffer sheet = makeSheet();
+	runFor(1000, sheet, random);
+	runFor(10000, sheet, random);
+}
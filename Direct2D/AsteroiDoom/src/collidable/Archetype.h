@@ -0,0 +1,171 @@
+#pragma once
+
+#include "../utils/Snapshot.h"
+
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/**
+ * Storage for entities which share the same set of components, kept as one contiguous column per component type.
+ * Rows are not stable: removing an entity moves the last one into its place.
+ */
+template <typename... Components>
+class Archetype {
+	std::tuple<std::vector<Components>...> columns{};
+
+public:
+	[[nodiscard]] size_t size() const;
+
+	[[nodiscard]] bool empty() const;
+
+	void reserve(size_t capacity);
+
+	void clear();
+
+	/**
+	 * @return the row of the added entity
+	 */
+	size_t add(Components... components);
+
+	/**
+	 * Removes the entity in O(1) by moving the last entity into its row.
+	 */
+	void remove(size_t row);
+
+	/**
+	 * Appends the entity to the other archetype and removes it from this one.
+	 */
+	void moveTo(size_t row, Archetype & other);
+
+	template <typename Component>
+	[[nodiscard]] std::span<Component> column();
+
+	template <typename Component>
+	[[nodiscard]] std::span<const Component> column() const;
+
+	/**
+	 * Calls visit(Queried & ...) for every entity, in row order.
+	 */
+	template <typename... Queried, typename Visitor>
+	void each(Visitor && visit);
+
+	template <typename... Queried, typename Visitor>
+	void each(Visitor && visit) const;
+
+	/**
+	 * Writes every column as a whole, so that unchanged columns make long runs of unchanged bytes between snapshots.
+	 */
+	void save(SnapshotWriter & writer) const;
+
+	/**
+	 * Replaces all entities with the ones saved, reusing the memory of the columns.
+	 * @throws std::runtime_error if the snapshot is malformed
+	 */
+	void restore(SnapshotReader & reader);
+};
+
+template <typename... Components>
+size_t Archetype<Components...>::size() const {
+	return std::get<0>(columns).size();
+}
+
+template <typename... Components>
+bool Archetype<Components...>::empty() const {
+	return size() == 0;
+}
+
+template <typename... Components>
+void Archetype<Components...>::reserve(size_t capacity) {
+	std::apply(
+	    [capacity](auto &... column) {
+		    (column.reserve(capacity), ...);
+	    },
+	    columns
+	);
+}
+
+template <typename... Components>
+void Archetype<Components...>::clear() {
+	std::apply(
+	    [](auto &... column) {
+		    (column.clear(), ...);
+	    },
+	    columns
+	);
+}
+
+template <typename... Components>
+size_t Archetype<Components...>::add(Components... components) {
+	(std::get<std::vector<Components>>(columns).push_back(std::move(components)), ...);
+	return size() - 1;
+}
+
+template <typename... Components>
+void Archetype<Components...>::remove(size_t row) {
+	auto removeFrom = [row](auto & column) {
+		if (row + 1 != column.size()) {
+			column[row] = std::move(column.back());
+		}
+		column.pop_back();
+	};
+	std::apply(
+	    [&removeFrom](auto &... column) {
+		    (removeFrom(column), ...);
+	    },
+	    columns
+	);
+}
+
+template <typename... Components>
+void Archetype<Components...>::moveTo(size_t row, Archetype & other) {
+	other.add(std::move(std::get<std::vector<Components>>(columns)[row])...);
+	remove(row);
+}
+
+template <typename... Components>
+template <typename Component>
+std::span<Component> Archetype<Components...>::column() {
+	return std::get<std::vector<Component>>(columns);
+}
+
+template <typename... Components>
+template <typename Component>
+std::span<const Component> Archetype<Components...>::column() const {
+	return std::get<std::vector<Component>>(columns);
+}
+
+template <typename... Components>
+template <typename... Queried, typename Visitor>
+void Archetype<Components...>::each(Visitor && visit) {
+	auto queried = std::tie(std::get<std::vector<Queried>>(columns)...);
+	for (size_t row = 0; row < size(); row++) {
+		visit(std::get<std::vector<Queried> &>(queried)[row]...);
+	}
+}
+
+template <typename... Components>
+template <typename... Queried, typename Visitor>
+void Archetype<Components...>::each(Visitor && visit) const {
+	auto queried = std::tie(std::get<std::vector<Queried>>(columns)...);
+	for (size_t row = 0; row < size(); row++) {
+		visit(std::get<const std::vector<Queried> &>(queried)[row]...);
+	}
+}
+
+template <typename... Components>
+void Archetype<Components...>::save(SnapshotWriter & writer) const {
+	(writer.writeAll(std::span<const Components>(std::get<std::vector<Components>>(columns))), ...);
+}
+
+template <typename... Components>
+void Archetype<Components...>::restore(SnapshotReader & reader) {
+	(reader.readAll(std::get<std::vector<Components>>(columns)), ...);
+	size_t rows = size();
+	if (((std::get<std::vector<Components>>(columns).size() != rows) || ...)) {
+		throw std::runtime_error("The columns of a restored archetype differ in length.");
+	}
+}
@@ -1,12 +1,234 @@
 #include "Arena.h"
 
-#include "../utils/Random.h"
+#include "../utils/ThreadPool.h"
 #include "../utils/AsteroiDoomConstants.h"
 
+#include <algorithm>
+#include <cmath>
+#include <span>
+#include <stdexcept>
+#include <tuple>
 #include <utility>
 
 using namespace std;
 
+namespace {
+	/**
+	 * Remembers the previous location and rotation of the entities in rows [begin, end) and moves them.
+	 */
+	template <typename EntityArchetype>
+	void moveRows(EntityArchetype & entities, size_t begin, size_t end, unsigned int millis, D2D_RECT_F modulo) {
+		auto locations = entities.template column<Location>();
+		auto rotations = entities.template column<Rotation>();
+		auto velocities = entities.template column<Velocity>();
+		auto spins = entities.template column<Spin>();
+		auto previousLocations = entities.template column<PreviousLocation>();
+		auto previousRotations = entities.template column<PreviousRotation>();
+		for (size_t row = begin; row < end; row++) {
+			previousLocations[row].value = locations[row].value;
+			previousRotations[row].value = rotations[row].value;
+			MovementData::move(
+			    locations[row].value, rotations[row].value, velocities[row].value, spins[row].value, millis, modulo
+			);
+		}
+	}
+
+	/**
+	 * Moves all entities, split between the threads of the pool if one is given. Every entity is moved by the same
+	 * operations either way, so the results are identical.
+	 */
+	template <typename EntityArchetype>
+	void moveAll(EntityArchetype & entities, unsigned int millis, D2D_RECT_F modulo, ThreadPool * pool) {
+		if (!pool) {
+			moveRows(entities, 0, entities.size(), millis, modulo);
+			return;
+		}
+		pool->parallelFor(entities.size(), MinParallelMoveRows, [&](size_t begin, size_t end) {
+			moveRows(entities, begin, end, millis, modulo);
+		});
+	}
+
+	/**
+	 * Draws a whole coordinate of the spawn area along one axis, which keeps an object of the given size completely
+	 * outside the arena along that axis, uniformly from the strips on either side of the arena.
+	 * @throws std::runtime_error if there is no such coordinate
+	 */
+	float spawnCoordinate(float spawnLow, float spawnHigh, float arenaLow, float arenaHigh, float size, Random & random) {
+		auto width = (unsigned int)(spawnHigh - spawnLow);
+		// Offsets from spawnLow in [0, lowCount) keep the object before the arena, those in [highStart, width) after it.
+		auto lowCount = (unsigned int)clamp(floor(arenaLow - size - spawnLow) + 1, 0.f, float(width));
+		auto highStart = (unsigned int)clamp(ceil(arenaHigh + size - spawnLow), float(lowCount), float(width));
+		unsigned int count = lowCount + (width - highStart);
+		if (count == 0) {
+			throw runtime_error("The spawn area has no room for the asteroid outside the arena.");
+		}
+		unsigned int offset = random.next(0, count);
+		if (offset >= lowCount) {
+			offset += highStart - lowCount;
+		}
+		return float(offset) + spawnLow;
+	}
+
+	/**
+	 * Sets a random spin, and a random velocity of a random direction, for an asteroid.
+	 */
+	void randomizeDrift(MovementData & movement, Random & random) {
+		movement.spin = float(random.next(0, 720)) - 360;
+
+		auto speed = float(random.next(50, 300));
+		auto angle = float(random.next(0, 360)) * RadiansInDegree;
+		movement.velocity = {speed * cos(angle), speed * sin(angle)};
+	}
+
+	/**
+	 * Finds the translations by whole periods, along one axis, of the copies of an object which overlap the range.
+	 * @return the number of translations found
+	 */
+	int visibleTranslations(
+	    float coordinate, float radius, float period, float low, float high, float (&translations)[3]
+	) {
+		int count = 0;
+		for (float translation : {-period, 0.f, period}) {
+			if (low <= coordinate + translation + radius && coordinate + translation - radius <= high) {
+				translations[count++] = translation;
+			}
+		}
+		return count;
+	}
+
+	/**
+	 * Draws the copies of a sprite on a looped rectangle, which show in the visible one.
+	 */
+	void drawCopies(
+	    DrawBackend & backend,
+	    const BitmapSegment & sprite,
+	    D2D_POINT_2F location,
+	    float rotation,
+	    D2D_RECT_F modulo,
+	    D2D_RECT_F visible
+	) {
+		float radius = sprite.getBoundingRadius();
+		float xs[3], ys[3];
+		int columns = visibleTranslations(location.x, radius, modulo.right - modulo.left, visible.left, visible.right, xs);
+		int rows = visibleTranslations(location.y, radius, modulo.bottom - modulo.top, visible.top, visible.bottom, ys);
+		for (int row = 0; row < rows; row++) {
+			for (int column = 0; column < columns; column++) {
+				backend.drawSprite(sprite, {location.x + xs[column], location.y + ys[row]}, rotation);
+			}
+		}
+	}
+
+	/**
+	 * Draws the sprite where it shows in the visible rectangle, without copies.
+	 */
+	void drawSingle(
+	    DrawBackend & backend, const BitmapSegment & sprite, D2D_POINT_2F location, float rotation, D2D_RECT_F visible
+	) {
+		float radius = sprite.getBoundingRadius();
+		if (visible.left <= location.x + radius && location.x - radius <= visible.right &&
+		    visible.top <= location.y + radius && location.y - radius <= visible.bottom) {
+			backend.drawSprite(sprite, location, rotation);
+		}
+	}
+
+	/**
+	 * Calls draw(sprite, location, rotation) for every entity, interpolated between its last two states.
+	 */
+	template <typename EntityArchetype, typename Draw>
+	void drawAll(const EntityArchetype & entities, float alpha, D2D_RECT_F modulo, Draw && draw) {
+		entities.template each<Location, Rotation, PreviousLocation, PreviousRotation, Sprite>(
+		    [&](const Location & location,
+		        const Rotation & rotation,
+		        const PreviousLocation & previousLocation,
+		        const PreviousRotation & previousRotation,
+		        const Sprite & sprite) {
+			    D2D_POINT_2F position = location.value;
+			    float angle = rotation.value;
+			    MovementData::interpolate(
+			        position, angle, previousLocation.value, previousRotation.value, alpha, modulo
+			    );
+			    draw(sprite.value, position, angle);
+		    }
+		);
+	}
+
+	/**
+	 * @return where the entity ended the last move, with the mask of its sprite if there are masks
+	 */
+	template <typename EntityArchetype>
+	MaskPlacement placeMask(
+	    const EntityArchetype & entities, size_t row, const CollisionMaskSet * masks, D2D_RECT_F modulo
+	) {
+		D2D_POINT_2F location = entities.template column<Location>()[row].value;
+		D2D_POINT_2F previousLocation = entities.template column<PreviousLocation>()[row].value;
+		return {
+		    masks ? masks->find(entities.template column<Sprite>()[row].value) : nullptr,
+		    location,
+		    minimumImage({location.x - previousLocation.x, location.y - previousLocation.y}, modulo),
+		    entities.template column<Rotation>()[row].value,
+		    entities.template column<Size>()[row].value};
+	}
+
+	/**
+	 * Appends a pair for every living asteroid which the object touched during the last move, targeting the asteroid.
+	 * With masks, only asteroids whose pixels the object's touched count.
+	 * @param modulo the rectangle in which the asteroids move, and so loop around
+	 */
+	void detectAsteroids(
+	    const AsteroidArchetype & asteroids,
+	    const CollisionGrid & grid,
+	    D2D_RECT_F modulo,
+	    const CollisionMaskSet * masks,
+	    CollisionPair pair,
+	    const MaskPlacement & object,
+	    vector<CollisionPair> & pairs
+	) {
+		if (asteroids.empty()) {
+			return;
+		}
+		auto hitPoints = asteroids.column<HitPoints>();
+		grid.sweptCollisions(object.location, object.size, object.travel, [&](size_t asteroid, float time) {
+			if (hitPoints[asteroid].value > 0 &&
+			    (!masks || pixelsTouch(object, placeMask(asteroids, asteroid, masks, modulo), time, modulo))) {
+				pair.targetRow = uint32_t(asteroid);
+				pair.time = time;
+				pairs.push_back(pair);
+			}
+		});
+	}
+
+	/**
+	 * @return the number of points gained if the hit destroyed the asteroid
+	 */
+	unsigned int hitAsteroid(AsteroidArchetype & asteroids, size_t asteroid, unsigned int damagePoints) {
+		if (!DamagableObject::takeDamage(asteroids.column<HitPoints>()[asteroid].value, damagePoints)) {
+			return 0;
+		}
+		return DamagableObject::pointsForDestruction(asteroids.column<Size>()[asteroid].value);
+	}
+
+	/**
+	 * Removes asteroids without hit points left, appending where they were to the destroyed ones.
+	 * @return whether any asteroid was removed
+	 */
+	bool removeDestroyed(AsteroidArchetype & asteroids, vector<DestroyedAsteroid> & destroyed) {
+		auto hitPoints = asteroids.column<HitPoints>();
+		auto locations = asteroids.column<Location>();
+		auto velocities = asteroids.column<Velocity>();
+		auto sizes = asteroids.column<Size>();
+		bool removed = false;
+		// Going backwards, every asteroid moved into a freed row has already been checked.
+		for (size_t asteroid = asteroids.size(); asteroid-- > 0;) {
+			if (hitPoints[asteroid].value == 0) {
+				destroyed.push_back({locations[asteroid].value, velocities[asteroid].value, sizes[asteroid].value});
+				asteroids.remove(asteroid);
+				removed = true;
+			}
+		}
+		return removed;
+	}
+} // namespace
+
 Arena::Arena() = default;
 
 Arena::Arena(float width, float height, float spawnAreaMargin, shared_ptr<Spaceship> spaceship) :
@@ -21,153 +243,421 @@ Arena::Arena(float width, float height, float spawnAreaMargin, shared_ptr<Spaces
          arenaRectangle.bottom + spawnAreaMargin}
     ),
     spaceship(std::move(spaceship)) {
+	spentProjectiles.reserve(ProjectilePoolCapacity);
+	rebuildGrids();
+}
+
+void Arena::rebuildGrids() {
+	outerGrid.rebuild(outerAsteroids, spawnRectangle);
+	innerGrid.rebuild(innerAsteroids, arenaRectangle);
+	swarm.rebuildGrid(arenaRectangle);
+	gridsOutdated = false;
 }
 
 void Arena::addAsteroid(
     float size, MovementData movement, BitmapSegment bitmapSegment, unsigned int hitPoints, unsigned int damagePoints
 ) {
-	outerAsteroids.emplace(make_unique<Asteroid>(size, movement, bitmapSegment, hitPoints, damagePoints));
+	size_t asteroid = outerAsteroids.add(
+	    {movement.location},
+	    {movement.velocity},
+	    {movement.rotation},
+	    {movement.spin},
+	    {size},
+	    {hitPoints},
+	    {damagePoints},
+	    {bitmapSegment},
+	    {movement.location},
+	    {movement.rotation}
+	);
+	if (!gridsOutdated) {
+		outerGrid.insert(asteroid, movement.location, size);
+	}
 }
 
-void Arena::addProjectile(unique_ptr<Projectile> && projectilePointer) {
-	if (projectilePointer) {
-		projectiles.emplace(std::move(projectilePointer));
-	}
+void Arena::setSwarm(Swarm newSwarm) {
+	swarm = std::move(newSwarm);
+	swarm.rebuildGrid(arenaRectangle);
 }
 
-void Arena::drawInner(D2D_POINT_2F translation) const {
-	for (auto & asteroid : innerAsteroids) {
-		asteroid->draw(translation);
-	}
-	for (auto & projectile : projectiles) {
-		projectile->draw(translation);
-	}
-	spaceship->draw(translation);
+void Arena::setRival(shared_ptr<Spaceship> ship) {
+	rival = std::move(ship);
 }
 
-void Arena::draw() const {
-	static D2D_POINT_2F translations[9] = {
-	    {0, 0},
-	    {-width, 0},
-	    {-width, -height},
-	    {0, -height},
-	    {width, -height},
-	    {width, 0},
-	    {width, height},
-	    {0, height},
-	    {-width, height}};
-	for (auto & asteroid : outerAsteroids) {
-		asteroid->draw();
-	}
-	for (D2D_POINT_2F translation : translations) {
-		drawInner(translation);
+void Arena::setCollisionMasks(shared_ptr<const CollisionMaskSet> masks) {
+	collisionMasks = std::move(masks);
+}
+
+void Arena::shootSwarm(unsigned long long timestamp) {
+	swarm.shoot(timestamp, projectiles);
+}
+
+void Arena::setProjectileCapacity(size_t capacity) {
+	projectiles = ProjectilePool(capacity);
+	spentProjectiles.reserve(capacity);
+}
+
+ProjectileHandle Arena::addProjectile(const Projectile & projectile) {
+	return projectiles.add(
+	    projectile.getMovement(),
+	    projectile.getSize(),
+	    projectile.getDamagePoints(),
+	    projectile.getBitmapSegment(),
+	    ProjectileTimeToLive
+	);
+}
+
+void Arena::draw(DrawBackend & backend, float alpha) const {
+	draw(backend, alpha, arenaRectangle);
+}
+
+void Arena::draw(DrawBackend & backend, float alpha, D2D_RECT_F visibleRectangle) const {
+	// Outer asteroids do not loop around the arena, so they only ever show once.
+	auto drawOuter = [&](const BitmapSegment & sprite, D2D_POINT_2F location, float rotation) {
+		drawSingle(backend, sprite, location, rotation, visibleRectangle);
+	};
+	drawAll(outerAsteroids, alpha, spawnRectangle, drawOuter);
+
+	auto drawInner = [&](const BitmapSegment & sprite, D2D_POINT_2F location, float rotation) {
+		drawCopies(backend, sprite, location, rotation, arenaRectangle, visibleRectangle);
+	};
+	drawAll(innerAsteroids, alpha, arenaRectangle, drawInner);
+	drawAll(projectiles.entities(), alpha, arenaRectangle, drawInner);
+	drawAll(swarm.entities(), alpha, arenaRectangle, drawInner);
+	MovementData spaceshipMovement = spaceship->getInterpolatedMovement(alpha, arenaRectangle);
+	drawInner(spaceship->getBitmapSegment(), spaceshipMovement.location, spaceshipMovement.rotation);
+	if (rival) {
+		MovementData rivalMovement = rival->getInterpolatedMovement(alpha, arenaRectangle);
+		drawInner(rival->getBitmapSegment(), rivalMovement.location, rivalMovement.rotation);
 	}
 }
 
+D2D_RECT_F Arena::getRectangle() const {
+	return arenaRectangle;
+}
+
+D2D_RECT_F Arena::getSpawnRectangle() const {
+	return spawnRectangle;
+}
+
+const Swarm & Arena::getSwarm() const {
+	return swarm;
+}
+
+size_t Arena::getAsteroidCount() const {
+	return innerAsteroids.size() + outerAsteroids.size();
+}
+
+size_t Arena::getProjectileCount() const {
+	return projectiles.size();
+}
+
+void Arena::setParallelMoveThreshold(size_t entityCount) {
+	parallelMoveThreshold = entityCount;
+}
+
+size_t Arena::getProjectileHighWaterMark() const {
+	return projectiles.getHighWaterMark();
+}
+
 void Arena::move(unsigned long long millis) {
-	for (auto & asteroid : innerAsteroids) {
-		asteroid->move(millis, arenaRectangle);
-	}
-	for (auto asteroid = outerAsteroids.begin(); asteroid != outerAsteroids.end();) {
-		(*asteroid)->move(millis, spawnRectangle);
-		if ((*asteroid)->isInside(arenaRectangle)) {
-			auto extracted = outerAsteroids.extract(asteroid++);
-			innerAsteroids.emplace(std::move(extracted.value()));
-		} else {
-			asteroid++;
+	projectiles.age((unsigned int)millis);
+
+	size_t entityCount = innerAsteroids.size() + outerAsteroids.size() + projectiles.size() + swarm.size();
+	ThreadPool * pool = entityCount >= parallelMoveThreshold ? &ThreadPool::shared() : nullptr;
+	// The swarm decides what to do from where everything was before the move, like the player does.
+	swarm.control({spaceship->getLocation(), arenaRectangle}, pool);
+	moveAll(innerAsteroids, (unsigned int)millis, arenaRectangle, pool);
+	moveAll(outerAsteroids, (unsigned int)millis, spawnRectangle, pool);
+	moveAll(projectiles.entities(), (unsigned int)millis, arenaRectangle, pool);
+	swarm.move((unsigned int)millis, arenaRectangle, pool);
+
+	auto locations = outerAsteroids.column<Location>();
+	auto sizes = outerAsteroids.column<Size>();
+	migratingAsteroids.clear();
+	for (size_t asteroid = 0; asteroid < outerAsteroids.size(); asteroid++) {
+		if (CollidableObject::isInside(locations[asteroid].value, sizes[asteroid].value, arenaRectangle)) {
+			migratingAsteroids.push_back(asteroid);
 		}
 	}
-	for (auto & projectile : projectiles) {
-		projectile->move(millis, arenaRectangle);
+	// Going backwards, every asteroid moved into a freed row stays outside.
+	for (auto asteroid = migratingAsteroids.rbegin(); asteroid != migratingAsteroids.rend(); asteroid++) {
+		outerAsteroids.moveTo(*asteroid, innerAsteroids);
 	}
+
 	spaceship->move(millis, arenaRectangle);
+	if (rival) {
+		rival->move(millis, arenaRectangle);
+	}
+
+	rebuildGrids();
 }
 
-unsigned int Arena::checkCollisions() {
-	unsigned int score = 0;
+void Arena::detectCrashes(CollisionPair pair, const MaskPlacement & ship, vector<CollisionPair> & pairs) const {
+	const CollisionMaskSet * masks = collisionMasks.get();
+	pair.target = CollisionTarget::InnerAsteroid;
+	detectAsteroids(innerAsteroids, innerGrid, arenaRectangle, masks, pair, ship, pairs);
+	pair.target = CollisionTarget::OuterAsteroid;
+	detectAsteroids(outerAsteroids, outerGrid, spawnRectangle, masks, pair, ship, pairs);
+}
+
+MaskPlacement Arena::placeSpaceship(const Spaceship & ship) const {
+	D2D_POINT_2F location = ship.getLocation(), previousLocation = ship.getPreviousLocation();
+	return {
+	    collisionMasks ? collisionMasks->find(ship.getBitmapSegment()) : nullptr,
+	    location,
+	    minimumImage({location.x - previousLocation.x, location.y - previousLocation.y}, arenaRectangle),
+	    ship.getMovement().rotation,
+	    ship.getSize()};
+}
+
+void Arena::detectCollisions(ThreadPool * pool) {
+	collisionPairs.clear();
 
-	// check projectiles
-	for (auto projectile = projectiles.begin(); projectile != projectiles.end();) {
-		// check against innerAsteroids
-		for (auto asteroid = innerAsteroids.begin(); asteroid != innerAsteroids.end(); asteroid++) {
-			if ((*projectile)->collidesWith(**asteroid, arenaRectangle)) {
-				(*projectile)->dealDamage(**asteroid);
-				if ((*asteroid)->destroyed()) {
-					score += (*asteroid)->pointsForDestruction();
-					innerAsteroids.erase(asteroid);
+	const CollisionMaskSet * masks = collisionMasks.get();
+	const ShipArchetype & ships = swarm.entities();
+	auto shipHitPoints = ships.column<HitPoints>();
+	MaskPlacement spaceshipPlacement = placeSpaceship(*spaceship);
+	MaskPlacement rivalPlacement = rival ? placeSpaceship(*rival) : MaskPlacement{};
+
+	// Every projectile can hit at most one object: the first asteroid it touched, or else a spaceship, or else a ship
+	// of the swarm. All of its candidates are kept in that order, as earlier ones may be destroyed before it hits.
+	collisionPairs.detect(projectiles.size(), pool, [&](size_t projectile, vector<CollisionPair> & pairs) {
+		MaskPlacement placement = placeMask(projectiles.entities(), projectile, masks, arenaRectangle);
+		D2D_POINT_2F location = placement.location;
+		float size = placement.size;
+
+		// Fast projectiles are swept along their path, so that they cannot pass through asteroids between moves.
+		CollisionPair pair{CollisionSource::Projectile, CollisionTarget::InnerAsteroid, uint32_t(projectile)};
+		auto first = ptrdiff_t(pairs.size());
+		detectAsteroids(innerAsteroids, innerGrid, arenaRectangle, masks, pair, placement, pairs);
+		pair.target = CollisionTarget::OuterAsteroid;
+		detectAsteroids(outerAsteroids, outerGrid, spawnRectangle, masks, pair, placement, pairs);
+		// Asteroids touched at the same time are hit inner ones first, then by row.
+		sort(pairs.begin() + first, pairs.end(), [](const CollisionPair & a, const CollisionPair & b) {
+			return tie(a.time, a.target, a.targetRow) < tie(b.time, b.target, b.targetRow);
+		});
+
+		// Ships are tested where everything ended the move, and so are their pixels.
+		auto touches = [&](const MaskPlacement & ship) {
+			return !masks || pixelsTouch(placement, ship, 1, arenaRectangle);
+		};
+		pair.time = 0;
+		if (CollidableObject::collide(location, size, spaceship->getLocation(), spaceship->getSize(), arenaRectangle) &&
+		    touches(spaceshipPlacement)) {
+			pair.target = CollisionTarget::Spaceship;
+			pairs.push_back(pair);
+		} else if (rival &&
+		           CollidableObject::collide(location, size, rival->getLocation(), rival->getSize(), arenaRectangle) &&
+		           touches(rivalPlacement)) {
+			pair.target = CollisionTarget::Rival;
+			pairs.push_back(pair);
+		} else {
+			pair.target = CollisionTarget::SwarmShip;
+			first = ptrdiff_t(pairs.size());
+			swarm.getGrid().collisions(location, size, [&](size_t ship) {
+				if (shipHitPoints[ship].value > 0 && touches(placeMask(ships, ship, masks, arenaRectangle))) {
+					pair.targetRow = uint32_t(ship);
+					pairs.push_back(pair);
 				}
-				projectiles.erase(projectile++);
-				goto nextProjectile;
-			}
+			});
+			sort(pairs.begin() + first, pairs.end(), [](const CollisionPair & a, const CollisionPair & b) {
+				return a.targetRow < b.targetRow;
+			});
+		}
+	});
+
+	// Ships crash into asteroids after projectiles hit them.
+	auto detectSpaceship = [&](CollisionSource source, const MaskPlacement & ship) {
+		collisionPairs.detect(1, nullptr, [&](size_t, vector<CollisionPair> & pairs) {
+			detectCrashes({source}, ship, pairs);
+		});
+	};
+	detectSpaceship(CollisionSource::Spaceship, spaceshipPlacement);
+	if (rival) {
+		detectSpaceship(CollisionSource::Rival, rivalPlacement);
+	}
+
+	collisionPairs.detect(ships.size(), pool, [&](size_t ship, vector<CollisionPair> & pairs) {
+		if (shipHitPoints[ship].value > 0) {
+			CollisionPair pair{CollisionSource::SwarmShip, CollisionTarget::InnerAsteroid, uint32_t(ship)};
+			detectCrashes(pair, placeMask(ships, ship, masks, arenaRectangle), pairs);
 		}
-		// check against outerAsteroids
-		for (auto asteroid = outerAsteroids.begin(); asteroid != outerAsteroids.end(); asteroid++) {
-			if ((*projectile)->collidesWith(**asteroid, spawnRectangle)) {
-				(*projectile)->dealDamage(**asteroid);
-				if ((*asteroid)->destroyed()) {
-					score += (*asteroid)->pointsForDestruction();
-					outerAsteroids.erase(asteroid);
+	});
+}
+
+unsigned int Arena::resolveCollisions() {
+	auto projectileDamage = projectiles.entities().column<DamagePoints>();
+	auto shipHitPoints = swarm.entities().column<HitPoints>();
+	auto asteroidsOf = [&](CollisionTarget target) -> AsteroidArchetype & {
+		return target == CollisionTarget::InnerAsteroid ? innerAsteroids : outerAsteroids;
+	};
+
+	unsigned int score = 0;
+	spentProjectiles.clear();
+	span<const CollisionPair> pairs = collisionPairs.get();
+	for (size_t index = 0; index < pairs.size(); index++) {
+		const CollisionPair & pair = pairs[index];
+		if (pair.source == CollisionSource::Projectile) {
+			// The candidates of a projectile follow one another, the first one still there taking the hit.
+			size_t end = index + 1;
+			while (end < pairs.size() && pairs[end].source == CollisionSource::Projectile &&
+			       pairs[end].sourceRow == pair.sourceRow) {
+				end++;
+			}
+			unsigned int damage = projectileDamage[pair.sourceRow].value;
+			for (; index < end; index++) {
+				const CollisionPair & candidate = pairs[index];
+				bool hit = true;
+				if (candidate.target == CollisionTarget::InnerAsteroid ||
+				    candidate.target == CollisionTarget::OuterAsteroid) {
+					AsteroidArchetype & asteroids = asteroidsOf(candidate.target);
+					hit = asteroids.column<HitPoints>()[candidate.targetRow].value > 0;
+					if (hit) {
+						score += hitAsteroid(asteroids, candidate.targetRow, damage);
+					}
+				} else if (candidate.target == CollisionTarget::Spaceship) {
+					spaceship->takeDamage(damage);
+				} else if (candidate.target == CollisionTarget::Rival) {
+					rival->takeDamage(damage);
+				} else {
+					unsigned int & hitPoints = shipHitPoints[candidate.targetRow].value;
+					hit = hitPoints > 0;
+					if (hit) {
+						DamagableObject::takeDamage(hitPoints, damage);
+					}
+				}
+				if (hit) {
+					spentProjectiles.push_back(pair.sourceRow);
+					break;
 				}
-				projectiles.erase(projectile++);
-				goto nextProjectile;
 			}
+			index = end - 1;
+			continue;
 		}
-		// check against spaceship
-		if ((*projectile)->collidesWith(*spaceship, arenaRectangle)) {
-			(*projectile)->dealDamage(*spaceship);
-			projectiles.erase(projectile++);
-			goto nextProjectile;
-		}
-		projectile++;
-	nextProjectile:
-		continue;
-	}
 
-	// check spaceship
-	// check against innerAsteroids
-	for (auto asteroid = innerAsteroids.begin(); asteroid != innerAsteroids.end();) {
-		if (spaceship->collidesWith(**asteroid, arenaRectangle)) {
-			(*asteroid)->dealDamage(*spaceship);
-			score += (*asteroid)->pointsForDestruction();
-			innerAsteroids.erase(asteroid++);
-		} else {
-			asteroid++;
+		AsteroidArchetype & asteroids = asteroidsOf(pair.target);
+		unsigned int & asteroidHitPoints = asteroids.column<HitPoints>()[pair.targetRow].value;
+		unsigned int damage = asteroids.column<DamagePoints>()[pair.targetRow].value;
+		if (asteroidHitPoints == 0) {
+			continue;
 		}
-	}
-	// check against outerAsteroids
-	for (auto asteroid = outerAsteroids.begin(); asteroid != outerAsteroids.end();) {
-		if (spaceship->collidesWith(**asteroid, spawnRectangle)) {
-			(*asteroid)->dealDamage(*spaceship);
-			score += (*asteroid)->pointsForDestruction();
-			outerAsteroids.erase(asteroid++);
+		if (pair.source == CollisionSource::Spaceship) {
+			spaceship->takeDamage(damage);
+			score += DamagableObject::pointsForDestruction(asteroids.column<Size>()[pair.targetRow].value);
+		} else if (pair.source == CollisionSource::Rival) {
+			rival->takeDamage(damage);
+		} else if (shipHitPoints[pair.sourceRow].value > 0) {
+			DamagableObject::takeDamage(shipHitPoints[pair.sourceRow].value, damage);
 		} else {
-			asteroid++;
+			continue;
 		}
+		asteroidHitPoints = 0;
+	}
+	return score;
+}
+
+unsigned int Arena::checkCollisions() {
+	if (gridsOutdated) {
+		rebuildGrids();
 	}
 
+	size_t entityCount = innerAsteroids.size() + outerAsteroids.size() + projectiles.size() + swarm.size();
+	detectCollisions(entityCount >= parallelMoveThreshold ? &ThreadPool::shared() : nullptr);
+	// Destroyed asteroids are only marked by their hit points and removed at the end, so that rows stay valid.
+	unsigned int score = resolveCollisions();
+
+	for (auto projectile = spentProjectiles.rbegin(); projectile != spentProjectiles.rend(); projectile++) {
+		projectiles.remove(*projectile);
+	}
+	destroyedAsteroids.clear();
+	bool removedInner = removeDestroyed(innerAsteroids, destroyedAsteroids);
+	bool removedOuter = removeDestroyed(outerAsteroids, destroyedAsteroids);
+	bool removedShips = swarm.removeDestroyed();
+	gridsOutdated = removedInner || removedOuter || removedShips;
+
 	return score;
 }
 
-void Arena::spawnAsteroid(float size, BitmapSegment bitmapSegment, unsigned int hitPoints, unsigned int damagePoints) {
+size_t Arena::getCollisionPairCount() const {
+	return collisionPairs.size();
+}
+
+span<const DestroyedAsteroid> Arena::getDestroyedAsteroids() const {
+	return destroyedAsteroids;
+}
+
+void Arena::spawnAsteroid(
+    float size, BitmapSegment bitmapSegment, unsigned int hitPoints, unsigned int damagePoints, Random & random
+) {
+	// The asteroid must lie outside the arena along both axes, so it spawns in one of the corners of the spawn area.
+	// The axes are independent, so each coordinate is drawn directly instead of rejecting points inside the arena.
+	const D2D_RECT_F & spawn = spawnRectangle;
+	const D2D_RECT_F & arena = arenaRectangle;
 	MovementData movementData{};
-	while (true) {
-		movementData.location = {
-		    float(Random::next(0, (unsigned int)(spawnRectangle.right - spawnRectangle.left))) + spawnRectangle.left,
-		    float(Random::next(0, (unsigned int)(spawnRectangle.bottom - spawnRectangle.top))) + spawnRectangle.top};
+	movementData.location = {
+	    spawnCoordinate(spawn.left, spawn.right, arena.left, arena.right, size, random),
+	    spawnCoordinate(spawn.top, spawn.bottom, arena.top, arena.bottom, size, random)};
 
-		if ((movementData.location.x + size <= arenaRectangle.left || movementData.location.x - size >= arenaRectangle.right
-		    ) &&
-		    (movementData.location.y + size <= arenaRectangle.top || movementData.location.y - size >= arenaRectangle.bottom
-		    )) {
-			break;
-		}
+	randomizeDrift(movementData, random);
+
+	addAsteroid(size, movementData, bitmapSegment, hitPoints, damagePoints);
+}
+
+void Arena::spawnAsteroids(
+    size_t count,
+    float size,
+    BitmapSegment bitmapSegment,
+    unsigned int hitPoints,
+    unsigned int damagePoints,
+    Random & random
+) {
+	outerAsteroids.reserve(outerAsteroids.size() + count);
+	for (size_t asteroid = 0; asteroid < count; asteroid++) {
+		spawnAsteroid(size, bitmapSegment, hitPoints, damagePoints, random);
 	}
+}
 
-	movementData.spin = float(Random::next(0, 720)) - 360;
+void Arena::scatterAsteroids(
+    size_t count,
+    float size,
+    BitmapSegment bitmapSegment,
+    unsigned int hitPoints,
+    unsigned int damagePoints,
+    Random & random
+) {
+	outerAsteroids.reserve(outerAsteroids.size() + count);
+	for (size_t asteroid = 0; asteroid < count; asteroid++) {
+		float coordinates[2];
+		random.fill(coordinates, 2, 0, 1);
+		MovementData movementData{};
+		movementData.location = {
+		    arenaRectangle.left + width * coordinates[0], arenaRectangle.top + height * coordinates[1]};
+		randomizeDrift(movementData, random);
+		// Added outside like spawned asteroids, it moves inside with the next move if it lies within the arena.
+		addAsteroid(size, movementData, bitmapSegment, hitPoints, damagePoints);
+	}
+}
 
-	auto speed = float(Random::next(50, 300));
-	auto angle = float(Random::next(0, 360)) * RadiansInDegree;
-	movementData.velocity = {speed * cos(angle), speed * sin(angle)};
+void Arena::save(SnapshotWriter & writer) const {
+	outerAsteroids.save(writer);
+	innerAsteroids.save(writer);
+	projectiles.save(writer);
+	spaceship->save(writer);
+	if (rival) {
+		rival->save(writer);
+	}
+	swarm.save(writer);
+}
 
-	addAsteroid(size, movementData, bitmapSegment, hitPoints, damagePoints);
+void Arena::restore(SnapshotReader & reader) {
+	outerAsteroids.restore(reader);
+	innerAsteroids.restore(reader);
+	projectiles.restore(reader);
+	spaceship->restore(reader);
+	if (rival) {
+		rival->restore(reader);
+	}
+	swarm.restore(reader);
+	// Moves rebuild the grids anyway, but collisions may be checked first.
+	gridsOutdated = true;
 }
@@ -1,11 +1,29 @@
 #pragma once
 
-#include "specific/Asteroid.h"
+#include "../utils/AsteroiDoomConstants.h"
+#include "../utils/DrawBackend.h"
+#include "../utils/Random.h"
+#include "CollisionGrid.h"
+#include "CollisionMask.h"
+#include "CollisionPairs.h"
+#include "Components.h"
+#include "ProjectilePool.h"
+#include "Swarm.h"
 #include "specific/Projectile.h"
 #include "specific/Spaceship.h"
 
 #include <memory>
-#include <set>
+#include <span>
+#include <vector>
+
+/**
+ * Where an asteroid was destroyed, e.g. to show an explosion there.
+ */
+struct DestroyedAsteroid {
+	D2D_POINT_2F location{};
+	D2D_POINT_2F velocity{};
+	float size{};
+};
 
 class Arena {
 	float width{};
@@ -14,12 +32,63 @@ class Arena {
 	D2D_RECT_F arenaRectangle{};
 	D2D_RECT_F spawnRectangle{};
 
-	std::set<std::unique_ptr<Asteroid>> outerAsteroids{};
-	std::set<std::unique_ptr<Asteroid>> innerAsteroids{};
-	std::set<std::unique_ptr<Projectile>> projectiles{};
+	AsteroidArchetype outerAsteroids{};
+	AsteroidArchetype innerAsteroids{};
+	ProjectilePool projectiles{ProjectilePoolCapacity};
 	std::shared_ptr<Spaceship> spaceship{};
+	// The second player's spaceship in a duel, if any.
+	std::shared_ptr<Spaceship> rival{};
+	Swarm swarm{};
+
+	// Broadphases over the asteroids, rebuilt on every move, or before collisions if asteroids were removed since.
+	CollisionGrid outerGrid{};
+	CollisionGrid innerGrid{};
+	bool gridsOutdated{};
+
+	// Moves and collision detection are split between threads when there are at least this many entities.
+	size_t parallelMoveThreshold{ParallelMoveThreshold};
+
+	// Rows of outer asteroids which moved into the arena, kept between frames to reuse the memory.
+	std::vector<size_t> migratingAsteroids{};
+
+	// Rows of projectiles which hit something, with memory for all of them reserved up front.
+	std::vector<size_t> spentProjectiles{};
 
-	void drawInner(D2D_POINT_2F translation = {0, 0}) const;
+	// The asteroids destroyed by the last collision check, kept between checks to reuse the memory.
+	std::vector<DestroyedAsteroid> destroyedAsteroids{};
+
+	// Everything which touched during the last move, detected before any of it is resolved.
+	CollisionPairBuffer collisionPairs{};
+
+	// The masks of the sprites, which confirm the pairs of touching circles pixel by pixel, if any.
+	std::shared_ptr<const CollisionMaskSet> collisionMasks{};
+
+	void rebuildGrids();
+
+	/**
+	 * Finds the collision pairs of the last move without changing anything, split between the threads of the pool
+	 * if one is given: every projectile with everything it touched, in the order it would hit them, then every ship
+	 * with the asteroids it crashed into.
+	 */
+	void detectCollisions(ThreadPool * pool);
+
+	/**
+	 * Appends a pair for every living asteroid, inner or outer, which the ship swept through during the last move.
+	 */
+	void detectCrashes(CollisionPair pair, const MaskPlacement & ship, std::vector<CollisionPair> & pairs) const;
+
+	/**
+	 * @return where the ship ended the last move, with its mask if there are masks
+	 */
+	[[nodiscard]] MaskPlacement placeSpaceship(const Spaceship & ship) const;
+
+	/**
+	 * Applies the collision pairs in order. Every projectile hits the first of its targets which has not been
+	 * destroyed by an earlier pair, if any, and every ship is damaged by the asteroids it crashed into, destroying
+	 * them.
+	 * @return the number of points gained for asteroids destroyed by projectiles or the spaceship
+	 */
+	unsigned int resolveCollisions();
 
 public:
 	Arena();
@@ -30,16 +99,140 @@ public:
 	    float size, MovementData movement, BitmapSegment bitmapSegment, unsigned int hitPoints, unsigned int damagePoints
 	);
 
-	void spawnAsteroid(float size, BitmapSegment bitmapSegment, unsigned int hitPoints, unsigned int damagePoints);
+	/**
+	 * Adds an asteroid at a random location in the spawn area, outside the visible arena, flying in a random direction.
+	 * Takes constant time, however little of the spawn area lies outside the arena.
+	 * @throws std::runtime_error if the spawn area is too narrow for the asteroid to fit outside the arena
+	 */
+	void spawnAsteroid(
+	    float size, BitmapSegment bitmapSegment, unsigned int hitPoints, unsigned int damagePoints, Random & random
+	);
+
+	/**
+	 * Spawns a wave of asteroids at once.
+	 * @see spawnAsteroid
+	 */
+	void spawnAsteroids(
+	    size_t count,
+	    float size,
+	    BitmapSegment bitmapSegment,
+	    unsigned int hitPoints,
+	    unsigned int damagePoints,
+	    Random & random
+	);
+
+	/**
+	 * Adds asteroids at random locations all over the arena, e.g. to start a stress test at full density.
+	 */
+	void scatterAsteroids(
+	    size_t count,
+	    float size,
+	    BitmapSegment bitmapSegment,
+	    unsigned int hitPoints,
+	    unsigned int damagePoints,
+	    Random & random
+	);
 
-	void addProjectile(std::unique_ptr<Projectile> && projectilePointer);
+	/**
+	 * Replaces the swarm, whose ships then move, shoot and collide along with everything else.
+	 */
+	void setSwarm(Swarm newSwarm);
+
+	/**
+	 * Adds a second spaceship, which moves, collides and can be shot like the first one, e.g. steered by another
+	 * player. Points for asteroids it crashes into are not counted.
+	 */
+	void setRival(std::shared_ptr<Spaceship> ship);
 
-	void draw() const;
+	/**
+	 * Confirms every pair of touching circles by testing the masks of their sprites, see pixelsTouch, so that objects
+	 * only collide where their opaque pixels do. Sprites without a mask collide as circles, as all do without masks.
+	 * @param masks the masks, or nullptr to go back to circles only
+	 */
+	void setCollisionMasks(std::shared_ptr<const CollisionMaskSet> masks);
+
+	/**
+	 * Fires the guns of the swarm, see Swarm::shoot.
+	 */
+	void shootSwarm(unsigned long long timestamp);
+
+	/**
+	 * Replaces the projectiles with an empty pool of the given capacity, e.g. to make room for those of a swarm.
+	 */
+	void setProjectileCapacity(size_t capacity);
+
+	/**
+	 * @return the handle of the added projectile, which refers to nothing if there are too many projectiles already
+	 */
+	ProjectileHandle addProjectile(const Projectile & projectile);
+
+	/**
+	 * Draws every object between its state before and after the last move, only where it shows on the screen.
+	 * @param alpha the fraction of the step elapsed since the last move, 1 drawing the current state
+	 */
+	void draw(DrawBackend & backend, float alpha = 1) const;
+
+	/**
+	 * Draws every copy of an object in the looped arena which intersects the given rectangle, e.g. at most four of
+	 * an object in a corner of the screen.
+	 */
+	void draw(DrawBackend & backend, float alpha, D2D_RECT_F visibleRectangle) const;
+
+	/**
+	 * @return the visible part of the arena, in which everything but outer asteroids loops around
+	 */
+	[[nodiscard]] D2D_RECT_F getRectangle() const;
+
+	/**
+	 * @return the arena with the spawn area around it, in which outer asteroids loop around
+	 */
+	[[nodiscard]] D2D_RECT_F getSpawnRectangle() const;
+
+	[[nodiscard]] const Swarm & getSwarm() const;
+
+	[[nodiscard]] size_t getAsteroidCount() const;
+
+	[[nodiscard]] size_t getProjectileCount() const;
+
+	/**
+	 * @return the largest number of projectiles alive at once
+	 */
+	[[nodiscard]] size_t getProjectileHighWaterMark() const;
 
 	void move(unsigned long long millis);
 
 	/**
+	 * Sets the number of entities from which moves and collision detection are split between the threads of
+	 * ThreadPool::shared.
+	 */
+	void setParallelMoveThreshold(size_t entityCount);
+
+	/**
+	 * Detects collisions, then resolves them and removes whatever was destroyed.
 	 * @return the number of points gained as a result of collisions
 	 */
 	unsigned int checkCollisions();
+
+	/**
+	 * @return the number of collision pairs detected by the last check, see CollisionPair
+	 */
+	[[nodiscard]] size_t getCollisionPairCount() const;
+
+	/**
+	 * @return the asteroids destroyed by the last check, inner and outer, by projectiles or ships
+	 */
+	[[nodiscard]] std::span<const DestroyedAsteroid> getDestroyedAsteroids() const;
+
+	/**
+	 * Writes every entity, see Snapshot.h, but not the broadphases, which are rebuilt from them.
+	 * Snapshots are taken between steps, after collisions were checked.
+	 */
+	void save(SnapshotWriter & writer) const;
+
+	/**
+	 * Reads back the entities written by save, into an arena of the same size and with the same swarm controller.
+	 * The following steps go exactly as they went after the snapshot was taken.
+	 * @throws std::runtime_error if the snapshot is malformed
+	 */
+	void restore(SnapshotReader & reader);
 };
@@ -0,0 +1,114 @@
+#include "CollisionGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+	// Keeps the number of cells bounded even for very small asteroids.
+	const int MaxCellsPerAxis = 256;
+
+	int cellsAlong(float length, float cellSize) {
+		if (cellSize <= 0) {
+			return 1;
+		}
+		return std::clamp(int(length / cellSize), 1, MaxCellsPerAxis);
+	}
+} // namespace
+
+void CollisionGrid::Cell::clear() {
+	xs.clear();
+	ys.clear();
+	sizes.clear();
+	travels.clear();
+	handles.clear();
+}
+
+void CollisionGrid::Cell::push(Handle asteroid, D2D_POINT_2F location, float size, D2D_POINT_2F travel) {
+	xs.push_back(location.x);
+	ys.push_back(location.y);
+	sizes.push_back(size);
+	travels.push_back(travel);
+	handles.push_back(asteroid);
+}
+
+CollisionGrid::CollisionGrid() = default;
+
+int CollisionGrid::columnOf(float x) const {
+	return int(std::floor((x - modulo.left) / cellWidth));
+}
+
+int CollisionGrid::rowOf(float y) const {
+	return int(std::floor((y - modulo.top) / cellHeight));
+}
+
+int CollisionGrid::wrap(int index, int count) {
+	index %= count;
+	return index < 0 ? index + count : index;
+}
+
+size_t CollisionGrid::cellOf(D2D_POINT_2F location) const {
+	auto [x, y] = location;
+	return size_t(wrap(rowOf(y), rows)) * size_t(columns) + size_t(wrap(columnOf(x), columns));
+}
+
+void CollisionGrid::push(Handle asteroid, D2D_POINT_2F location, float size, D2D_POINT_2F travel) {
+	size_t cell = cellOf(location);
+	if (cells[cell].handles.empty()) {
+		occupiedCells.push_back(cell);
+	}
+	cells[cell].push(asteroid, location, size, travel);
+}
+
+template <typename EntityArchetype>
+void CollisionGrid::rebuildFrom(const EntityArchetype & entities, D2D_RECT_F newModulo) {
+	auto locations = entities.template column<Location>();
+	auto sizes = entities.template column<Size>();
+	auto previousLocations = entities.template column<PreviousLocation>();
+
+	modulo = newModulo;
+	maxSize = 0;
+	for (auto size : sizes) {
+		maxSize = std::max(maxSize, size.value);
+	}
+	maxTravel = 0;
+	for (Handle entity = 0; entity < entities.size(); entity++) {
+		D2D_POINT_2F travel = travelOf(locations[entity].value, previousLocations[entity].value);
+		maxTravel = std::max(maxTravel, std::hypot(travel.x, travel.y));
+	}
+
+	float width = modulo.right - modulo.left;
+	float height = modulo.bottom - modulo.top;
+	columns = cellsAlong(width, 2 * maxSize);
+	rows = cellsAlong(height, 2 * maxSize);
+	cellWidth = width / float(columns);
+	cellHeight = height / float(rows);
+
+	// Keep the already allocated cells, so that rebuilding every frame does not reallocate.
+	for (size_t cell : occupiedCells) {
+		cells[cell].clear();
+	}
+	occupiedCells.clear();
+	cells.resize(size_t(columns) * size_t(rows));
+
+	for (Handle entity = 0; entity < entities.size(); entity++) {
+		D2D_POINT_2F location = locations[entity].value;
+		push(entity, location, sizes[entity].value, travelOf(location, previousLocations[entity].value));
+	}
+}
+
+void CollisionGrid::rebuild(const AsteroidArchetype & asteroids, D2D_RECT_F newModulo) {
+	rebuildFrom(asteroids, newModulo);
+}
+
+void CollisionGrid::rebuild(const ShipArchetype & ships, D2D_RECT_F newModulo) {
+	rebuildFrom(ships, newModulo);
+}
+
+void CollisionGrid::insert(Handle asteroid, D2D_POINT_2F location, float size) {
+	maxSize = std::max(maxSize, size);
+	push(asteroid, location, size, {0, 0});
+}
+
+D2D_POINT_2F CollisionGrid::travelOf(D2D_POINT_2F location, D2D_POINT_2F previousLocation) const {
+	return minimumImage({location.x - previousLocation.x, location.y - previousLocation.y}, modulo);
+}
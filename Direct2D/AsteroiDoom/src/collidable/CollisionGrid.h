@@ -0,0 +1,197 @@
+#pragma once
+
+#include "CollisionKernel.h"
+#include "Components.h"
+#include "SweptCollision.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <vector>
+
+/**
+ * A uniform grid over a looped rectangle, used as a broadphase for collisions against asteroids, or ships.
+ * Cells are about as wide as the largest stored asteroid, so a query only visits the few cells around the querying
+ * object, wrapping across the edges of the rectangle where needed.
+ */
+class CollisionGrid {
+public:
+	// The row of the asteroid in its archetype.
+	using Handle = size_t;
+
+private:
+	// Locations and sizes are copied into the cell, so that they can be tested against in batches.
+	struct Cell {
+		std::vector<float> xs{};
+		std::vector<float> ys{};
+		std::vector<float> sizes{};
+		// How far the asteroid travelled during the last move.
+		std::vector<D2D_POINT_2F> travels{};
+		std::vector<Handle> handles{};
+
+		void clear();
+
+		void push(Handle asteroid, D2D_POINT_2F location, float size, D2D_POINT_2F travel);
+	};
+
+	D2D_RECT_F modulo{};
+	int columns{1};
+	int rows{1};
+	float cellWidth{1};
+	float cellHeight{1};
+	float maxSize{};
+	float maxTravel{};
+
+	std::vector<Cell> cells{Cell()};
+	// Indices of the cells which are not empty, so that rebuilding does not have to visit all of them.
+	std::vector<size_t> occupiedCells{};
+
+	/**
+	 * @return the column of the given coordinate, not yet wrapped into [0, columns)
+	 */
+	[[nodiscard]] int columnOf(float x) const;
+
+	/**
+	 * @return the row of the given coordinate, not yet wrapped into [0, rows)
+	 */
+	[[nodiscard]] int rowOf(float y) const;
+
+	[[nodiscard]] static int wrap(int index, int count);
+
+	[[nodiscard]] size_t cellOf(D2D_POINT_2F location) const;
+
+	void push(Handle asteroid, D2D_POINT_2F location, float size, D2D_POINT_2F travel);
+
+	/**
+	 * @return the path from the previous location to the current one, across the edges if that is shorter
+	 */
+	[[nodiscard]] D2D_POINT_2F travelOf(D2D_POINT_2F location, D2D_POINT_2F previousLocation) const;
+
+	/**
+	 * Calls visit(cell) for every cell which may contain asteroids colliding with an object at the given location.
+	 */
+	template <typename Visitor>
+	void forEachCellNear(D2D_POINT_2F location, float size, Visitor && visit) const;
+
+	/**
+	 * Instantiated in the source file for the archetypes which can be stored.
+	 */
+	template <typename EntityArchetype>
+	void rebuildFrom(const EntityArchetype & entities, D2D_RECT_F newModulo);
+
+public:
+	CollisionGrid();
+
+	/**
+	 * Clears the grid, resizes the cells to fit the largest of the given asteroids and inserts all of them.
+	 */
+	void rebuild(const AsteroidArchetype & asteroids, D2D_RECT_F newModulo);
+
+	/**
+	 * Clears the grid and inserts all ships, like rebuild for asteroids.
+	 */
+	void rebuild(const ShipArchetype & ships, D2D_RECT_F newModulo);
+
+	/**
+	 * Inserts an asteroid added to the archetype after the last rebuild, which has not travelled yet.
+	 */
+	void insert(Handle asteroid, D2D_POINT_2F location, float size);
+
+	/**
+	 * Calls visit(handle) for every stored asteroid that may collide with an object at the given location.
+	 * Every asteroid for which CollidableObject::collide holds is visited exactly once.
+	 */
+	template <typename Visitor>
+	void query(D2D_POINT_2F location, float size, Visitor && visit) const;
+
+	/**
+	 * Calls visit(handle) for exactly the stored asteroids colliding with an object at the given location,
+	 * tested in batches with collisionMask.
+	 */
+	template <typename Visitor>
+	void collisions(D2D_POINT_2F location, float size, Visitor && visit) const;
+
+	/**
+	 * Calls visit(handle, time) for exactly the stored asteroids which touched an object during the last move,
+	 * with the fraction of the move at which they first did, see timeOfImpact. Asteroids too far apart at the end of
+	 * the move to have touched are ruled out in batches with collisionMask first.
+	 * @param travel how far the object travelled during the last move, ending at the given location
+	 */
+	template <typename Visitor>
+	void sweptCollisions(D2D_POINT_2F location, float size, D2D_POINT_2F travel, Visitor && visit) const;
+};
+
+template <typename Visitor>
+void CollisionGrid::forEachCellNear(D2D_POINT_2F location, float size, Visitor && visit) const {
+	// Absorbs rounding errors of wrapped coordinates, so that no colliding pair is ever missed.
+	const float slack = 0.01f;
+	float radius = size + maxSize + slack;
+	auto [x, y] = location;
+
+	int firstColumn = columnOf(x - radius), lastColumn = columnOf(x + radius);
+	int firstRow = rowOf(y - radius), lastRow = rowOf(y + radius);
+	// If the range wraps onto itself, every cell in that direction has to be visited, but only once.
+	if (lastColumn - firstColumn + 1 >= columns)
+		firstColumn = 0, lastColumn = columns - 1;
+	if (lastRow - firstRow + 1 >= rows)
+		firstRow = 0, lastRow = rows - 1;
+
+	for (int row = firstRow; row <= lastRow; row++) {
+		for (int column = firstColumn; column <= lastColumn; column++) {
+			visit(cells[wrap(row, rows) * columns + wrap(column, columns)]);
+		}
+	}
+}
+
+template <typename Visitor>
+void CollisionGrid::query(D2D_POINT_2F location, float size, Visitor && visit) const {
+	forEachCellNear(location, size, [&visit](const Cell & cell) {
+		for (Handle asteroid : cell.handles) {
+			visit(asteroid);
+		}
+	});
+}
+
+template <typename Visitor>
+void CollisionGrid::collisions(D2D_POINT_2F location, float size, Visitor && visit) const {
+	forEachCellNear(location, size, [&](const Cell & cell) {
+		for (size_t first = 0; first < cell.handles.size(); first += 64) {
+			size_t count = std::min<size_t>(64, cell.handles.size() - first);
+			uint64_t mask{};
+			collisionMask(
+			    location, size, &cell.xs[first], &cell.ys[first], &cell.sizes[first], count, modulo, &mask
+			);
+			while (mask) {
+				visit(cell.handles[first + std::countr_zero(mask)]);
+				mask &= mask - 1;
+			}
+		}
+	});
+}
+
+template <typename Visitor>
+void CollisionGrid::sweptCollisions(D2D_POINT_2F location, float size, D2D_POINT_2F travel, Visitor && visit) const {
+	// Both the object and the asteroids may have ended up to their whole travel away from the point of impact, so
+	// only asteroids within that reach at the end of the move, found in batches with collisionMask, are swept.
+	const float slack = 0.01f;
+	float reach = size + std::hypot(travel.x, travel.y) + maxTravel + slack;
+	forEachCellNear(location, reach, [&](const Cell & cell) {
+		for (size_t first = 0; first < cell.handles.size(); first += 64) {
+			size_t count = std::min<size_t>(64, cell.handles.size() - first);
+			uint64_t mask{};
+			collisionMask(
+			    location, reach, &cell.xs[first], &cell.ys[first], &cell.sizes[first], count, modulo, &mask
+			);
+			while (mask) {
+				size_t i = first + size_t(std::countr_zero(mask));
+				mask &= mask - 1;
+				auto time = timeOfImpact(
+				    location, travel, size, {cell.xs[i], cell.ys[i]}, cell.travels[i], cell.sizes[i], modulo
+				);
+				if (time) {
+					visit(cell.handles[i], *time);
+				}
+			}
+		}
+	});
+}
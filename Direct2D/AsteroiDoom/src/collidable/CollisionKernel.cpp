@@ -0,0 +1,121 @@
+#include "CollisionKernel.h"
+
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ASTEROIDOOM_SSE2
+#endif
+
+namespace {
+	void clearMask(size_t count, uint64_t * mask) {
+		for (size_t word = 0; word < (count + 63) / 64; word++) {
+			mask[word] = 0;
+		}
+	}
+
+	/**
+	 * Handles entities [first, count) one by one, without clearing the mask first.
+	 */
+	void scalarTail(
+	    D2D_POINT_2F location,
+	    float size,
+	    const float * xs,
+	    const float * ys,
+	    const float * sizes,
+	    size_t first,
+	    size_t count,
+	    D2D_RECT_F modulo,
+	    uint64_t * mask
+	) {
+		float width = modulo.right - modulo.left;
+		float height = modulo.bottom - modulo.top;
+		float inverseWidth = 1 / width;
+		float inverseHeight = 1 / height;
+
+		for (size_t i = first; i < count; i++) {
+			float dx = xs[i] - location.x;
+			float dy = ys[i] - location.y;
+			dx -= width * std::nearbyint(dx * inverseWidth);
+			dy -= height * std::nearbyint(dy * inverseHeight);
+			float reach = size + sizes[i];
+			if (reach * reach >= dx * dx + dy * dy) {
+				mask[i / 64] |= uint64_t(1) << (i % 64);
+			}
+		}
+	}
+} // namespace
+
+void collisionMaskScalar(
+    D2D_POINT_2F location,
+    float size,
+    const float * xs,
+    const float * ys,
+    const float * sizes,
+    size_t count,
+    D2D_RECT_F modulo,
+    uint64_t * mask
+) {
+	clearMask(count, mask);
+	scalarTail(location, size, xs, ys, sizes, 0, count, modulo, mask);
+}
+
+void collisionMask(
+    D2D_POINT_2F location,
+    float size,
+    const float * xs,
+    const float * ys,
+    const float * sizes,
+    size_t count,
+    D2D_RECT_F modulo,
+    uint64_t * mask
+) {
+	clearMask(count, mask);
+	size_t i = 0;
+
+#if defined(__AVX2__)
+	const __m256 x = _mm256_set1_ps(location.x);
+	const __m256 y = _mm256_set1_ps(location.y);
+	const __m256 radius = _mm256_set1_ps(size);
+	const __m256 width = _mm256_set1_ps(modulo.right - modulo.left);
+	const __m256 height = _mm256_set1_ps(modulo.bottom - modulo.top);
+	const __m256 inverseWidth = _mm256_set1_ps(1 / (modulo.right - modulo.left));
+	const __m256 inverseHeight = _mm256_set1_ps(1 / (modulo.bottom - modulo.top));
+	const int nearest = _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC;
+
+	for (; i + 8 <= count; i += 8) {
+		__m256 dx = _mm256_sub_ps(_mm256_loadu_ps(xs + i), x);
+		__m256 dy = _mm256_sub_ps(_mm256_loadu_ps(ys + i), y);
+		dx = _mm256_sub_ps(dx, _mm256_mul_ps(width, _mm256_round_ps(_mm256_mul_ps(dx, inverseWidth), nearest)));
+		dy = _mm256_sub_ps(dy, _mm256_mul_ps(height, _mm256_round_ps(_mm256_mul_ps(dy, inverseHeight), nearest)));
+		__m256 squareDistance = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+		__m256 reach = _mm256_add_ps(radius, _mm256_loadu_ps(sizes + i));
+		__m256 hits = _mm256_cmp_ps(_mm256_mul_ps(reach, reach), squareDistance, _CMP_GE_OQ);
+		mask[i / 64] |= uint64_t(unsigned(_mm256_movemask_ps(hits))) << (i % 64);
+	}
+#elif defined(ASTEROIDOOM_SSE2)
+	const __m128 x = _mm_set1_ps(location.x);
+	const __m128 y = _mm_set1_ps(location.y);
+	const __m128 radius = _mm_set1_ps(size);
+	const __m128 width = _mm_set1_ps(modulo.right - modulo.left);
+	const __m128 height = _mm_set1_ps(modulo.bottom - modulo.top);
+	const __m128 inverseWidth = _mm_set1_ps(1 / (modulo.right - modulo.left));
+	const __m128 inverseHeight = _mm_set1_ps(1 / (modulo.bottom - modulo.top));
+
+	for (; i + 4 <= count; i += 4) {
+		__m128 dx = _mm_sub_ps(_mm_loadu_ps(xs + i), x);
+		__m128 dy = _mm_sub_ps(_mm_loadu_ps(ys + i), y);
+		// SSE2 has no rounding instruction, but conversion to integers rounds to nearest.
+		dx = _mm_sub_ps(dx, _mm_mul_ps(width, _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(dx, inverseWidth)))));
+		dy = _mm_sub_ps(dy, _mm_mul_ps(height, _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(dy, inverseHeight)))));
+		__m128 squareDistance = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+		__m128 reach = _mm_add_ps(radius, _mm_loadu_ps(sizes + i));
+		__m128 hits = _mm_cmpge_ps(_mm_mul_ps(reach, reach), squareDistance);
+		mask[i / 64] |= uint64_t(unsigned(_mm_movemask_ps(hits))) << (i % 64);
+	}
+#endif
+
+	scalarTail(location, size, xs, ys, sizes, i, count, modulo, mask);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "../utils/Geometry.h"
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Tests one circle against a batch of others on a looped rectangle.
+ *
+ * Instead of trying all 9 translations like CollidableObject::squareDistance, the offsets are wrapped into
+ * [-width / 2, width / 2] and [-height / 2, height / 2], which gives the same distance (up to rounding) for objects
+ * inside the rectangle, without branches.
+ *
+ * Bit i % 64 of mask[i / 64] is set iff (size + sizes[i])^2 >= the squared distance to (xs[i], ys[i]).
+ * mask must have room for (count + 63) / 64 words.
+ *
+ * Uses AVX2 or SSE2 when compiled with support for them.
+ */
+void collisionMask(
+    D2D_POINT_2F location,
+    float size,
+    const float * xs,
+    const float * ys,
+    const float * sizes,
+    size_t count,
+    D2D_RECT_F modulo,
+    uint64_t * mask
+);
+
+/**
+ * Same as collisionMask, but never vectorized.
+ */
+void collisionMaskScalar(
+    D2D_POINT_2F location,
+    float size,
+    const float * xs,
+    const float * ys,
+    const float * sizes,
+    size_t count,
+    D2D_RECT_F modulo,
+    uint64_t * mask
+);
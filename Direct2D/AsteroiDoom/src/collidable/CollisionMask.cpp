@@ -0,0 +1,199 @@
+#include "CollisionMask.h"
+
+#include "SweptCollision.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <numbers>
+#include <stdexcept>
+
+namespace {
+	// Pixels at least this opaque belong to the mask, like the visible edge of an antialiased sprite.
+	const uint32_t OpaqueAlpha = 128;
+
+	const int WordBits = 64;
+
+	/**
+	 * @return the 64 bits of a row of a mask starting at the given pixel, which may lie outside it, zero outside
+	 */
+	uint64_t bitsFrom(const uint64_t * row, int wordCount, int start) {
+		// Rounded down, so that pixels left of the row start in a word before its first.
+		int word = start >= 0 ? start / WordBits : -((WordBits - 1 - start) / WordBits);
+		int shift = start - word * WordBits;
+		auto wordAt = [&](int index) {
+			return 0 <= index && index < wordCount ? row[index] : uint64_t(0);
+		};
+		if (shift == 0) {
+			return wordAt(word);
+		}
+		return (wordAt(word) >> shift) | (wordAt(word + 1) << (WordBits - shift));
+	}
+} // namespace
+
+CollisionMask::CollisionMask() = default;
+
+CollisionMask::CollisionMask(const PixelBuffer & pixels, D2D_RECT_F segment) {
+	int segmentLeft = int(std::lround(segment.left)), segmentTop = int(std::lround(segment.top));
+	int segmentWidth = int(std::lround(segment.right)) - segmentLeft;
+	int segmentHeight = int(std::lround(segment.bottom)) - segmentTop;
+	if (segmentLeft < 0 || segmentTop < 0 || segmentWidth <= 0 || segmentHeight <= 0 ||
+	    segmentLeft + segmentWidth > int(pixels.getWidth()) || segmentTop + segmentHeight > int(pixels.getHeight())) {
+		throw std::runtime_error("The sprite segment lies outside its pixels.");
+	}
+
+	// Large enough for the sprite in any rotation, before cropping.
+	int extent = int(std::ceil(std::hypot(float(segmentWidth), float(segmentHeight)))) + 1;
+	float middle = float(extent) / 2;
+	std::vector<bool> opaque(size_t(extent) * size_t(extent));
+	rotations.reserve(RotationSteps);
+	for (unsigned int step = 0; step < RotationSteps; step++) {
+		float radians = float(step) * 2 * std::numbers::pi_v<float> / RotationSteps;
+		float cosine = std::cos(radians), sine = std::sin(radians);
+
+		// Rotates the center of every pixel back into the segment, as SoftwareRenderer does, and takes the nearest.
+		int left = extent, top = extent, right = -1, bottom = -1;
+		for (int y = 0; y < extent; y++) {
+			for (int x = 0; x < extent; x++) {
+				float dx = float(x) + 0.5f - middle, dy = float(y) + 0.5f - middle;
+				float u = dx * cosine + dy * sine + float(segmentWidth) / 2;
+				float v = dy * cosine - dx * sine + float(segmentHeight) / 2;
+				auto column = int(std::floor(u)), line = int(std::floor(v));
+				bool set = 0 <= column && column < segmentWidth && 0 <= line && line < segmentHeight &&
+				           pixels.row(unsigned(segmentTop + line))[segmentLeft + column] >> 24 >= OpaqueAlpha;
+				opaque[size_t(y) * size_t(extent) + size_t(x)] = set;
+				if (set) {
+					left = std::min<int>(left, x);
+					top = std::min<int>(top, y);
+					right = std::max<int>(right, x);
+					bottom = std::max<int>(bottom, y);
+				}
+			}
+		}
+
+		Rotated rotated{0, 0, 0, words.size(), {0, 0}};
+		if (right >= 0) {
+			rotated.width = right - left + 1;
+			rotated.height = bottom - top + 1;
+			rotated.wordsPerRow = (rotated.width + WordBits - 1) / WordBits;
+			rotated.center = {middle - float(left), middle - float(top)};
+			words.resize(words.size() + size_t(rotated.wordsPerRow) * size_t(rotated.height));
+			for (int y = 0; y < rotated.height; y++) {
+				uint64_t * row = words.data() + rotated.offset + size_t(y) * size_t(rotated.wordsPerRow);
+				for (int x = 0; x < rotated.width; x++) {
+					if (opaque[size_t(top + y) * size_t(extent) + size_t(left + x)]) {
+						row[x / WordBits] |= uint64_t(1) << (x % WordBits);
+					}
+				}
+			}
+		}
+		rotations.push_back(rotated);
+	}
+}
+
+const CollisionMask::Rotated & CollisionMask::at(float rotation) const {
+	long step = std::lround(rotation / 360 * float(RotationSteps)) % long(RotationSteps);
+	if (step < 0) {
+		step += long(RotationSteps);
+	}
+	return rotations[size_t(step)];
+}
+
+size_t CollisionMask::overlap(
+    const CollisionMask & first,
+    float firstRotation,
+    const CollisionMask & second,
+    float secondRotation,
+    D2D_POINT_2F offset,
+    size_t limit
+) {
+	if (first.rotations.empty() || second.rotations.empty()) {
+		return 0;
+	}
+	const Rotated & a = first.at(firstRotation);
+	const Rotated & b = second.at(secondRotation);
+
+	// The top left corner of the second mask, in pixels of the first one.
+	auto left = int(std::lround(offset.x + a.center.x - b.center.x));
+	auto top = int(std::lround(offset.y + a.center.y - b.center.y));
+	int firstRow = std::max<int>(0, top), endRow = std::min<int>(a.height, top + b.height);
+	int firstColumn = std::max<int>(0, left), endColumn = std::min<int>(a.width, left + b.width);
+	if (firstRow >= endRow || firstColumn >= endColumn) {
+		return 0;
+	}
+
+	// Bits past the width of a row are clear, so whole words can be ANDed.
+	int firstWord = firstColumn / WordBits, lastWord = (endColumn - 1) / WordBits;
+	size_t count = 0;
+	for (int y = firstRow; y < endRow; y++) {
+		const uint64_t * firstBits = first.words.data() + a.offset + size_t(y) * size_t(a.wordsPerRow);
+		const uint64_t * secondBits = second.words.data() + b.offset + size_t(y - top) * size_t(b.wordsPerRow);
+		for (int word = firstWord; word <= lastWord; word++) {
+			uint64_t both = firstBits[word] & bitsFrom(secondBits, b.wordsPerRow, word * WordBits - left);
+			count += size_t(std::popcount(both));
+		}
+		if (count >= limit) {
+			return limit;
+		}
+	}
+	return count;
+}
+
+size_t CollisionMask::getArea(float rotation) const {
+	if (rotations.empty()) {
+		return 0;
+	}
+	const Rotated & rotated = at(rotation);
+	size_t area = 0;
+	for (size_t word = 0; word < size_t(rotated.wordsPerRow) * size_t(rotated.height); word++) {
+		area += size_t(std::popcount(words[rotated.offset + word]));
+	}
+	return area;
+}
+
+CollisionMaskSet::CollisionMaskSet() = default;
+
+void CollisionMaskSet::add(const BitmapSegment & sprite, const PixelBuffer & pixels) {
+	sprites.push_back(sprite);
+	masks.emplace_back(pixels, sprite.getSegment());
+}
+
+const CollisionMask * CollisionMaskSet::find(const BitmapSegment & sprite) const {
+	// A game draws a handful of sprites, so searching them beats hashing.
+	D2D_RECT_F segment = sprite.getSegment();
+	for (size_t index = 0; index < sprites.size(); index++) {
+		D2D_RECT_F candidate = sprites[index].getSegment();
+		if (sprites[index].getBitmap() == sprite.getBitmap() && candidate.left == segment.left &&
+		    candidate.top == segment.top && candidate.right == segment.right && candidate.bottom == segment.bottom) {
+			return &masks[index];
+		}
+	}
+	return nullptr;
+}
+
+bool pixelsTouch(const MaskPlacement & first, const MaskPlacement & second, float time, D2D_RECT_F modulo) {
+	if (!first.mask || !second.mask) {
+		return true;
+	}
+	// Relative to the first object, the second one travelled the difference, and is taken at the translation which
+	// brings it closest halfway through the move, like timeOfImpact does.
+	D2D_POINT_2F travel{second.travel.x - first.travel.x, second.travel.y - first.travel.y};
+	D2D_POINT_2F halfway = minimumImage(
+	    {second.location.x - first.location.x - travel.x / 2, second.location.y - first.location.y - travel.y / 2},
+	    modulo
+	);
+	D2D_POINT_2F end{halfway.x + travel.x / 2, halfway.y + travel.y / 2};
+
+	float remaining = 1 - time;
+	float spacing = std::max<float>(std::min<float>(first.size, second.size), 1);
+	auto steps = int(std::ceil(std::hypot(travel.x, travel.y) * remaining / spacing));
+	for (int step = steps; step >= 0; step--) {
+		// From the end of the move back to the fraction at which the circles touched.
+		float back = steps > 0 ? remaining * float(steps - step) / float(steps) : 0;
+		D2D_POINT_2F offset{end.x - travel.x * back, end.y - travel.y * back};
+		if (CollisionMask::overlap(*first.mask, first.rotation, *second.mask, second.rotation, offset, 1) > 0) {
+			return true;
+		}
+	}
+	return false;
+}
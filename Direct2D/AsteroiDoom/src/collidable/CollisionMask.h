@@ -0,0 +1,110 @@
+#pragma once
+
+#include "../utils/BitmapUtils.h"
+#include "../utils/Geometry.h"
+#include "../utils/SoftwareRenderer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * The opaque pixels of a sprite as one bit each, precomputed at evenly spaced rotations, so that two sprites can be
+ * tested for touching pixels by ANDing rows of 64-bit words instead of sampling their images.
+ *
+ * A pixel of the mask is set if the nearest pixel of the rotated sprite, drawn at its size in the arena like the
+ * renderers draw it, is at least half opaque. Rotations are rounded to the nearest of RotationSteps.
+ */
+class CollisionMask {
+public:
+	static const unsigned int RotationSteps = 64;
+
+private:
+	// A rotated mask, cropped to its opaque pixels, whose rows of wordsPerRow words start at offset.
+	struct Rotated {
+		int width;
+		int height;
+		int wordsPerRow;
+		size_t offset;
+		// Where the center of the sprite lies, measured from the top left corner of the cropped mask.
+		D2D_POINT_2F center;
+	};
+
+	std::vector<Rotated> rotations{};
+	std::vector<uint64_t> words{};
+
+	[[nodiscard]] const Rotated & at(float rotation) const;
+
+public:
+	CollisionMask();
+
+	/**
+	 * Rasterizes the masks of every rotation from a segment of premultiplied pixels, e.g. the ones BitmapHelper
+	 * decodes.
+	 * @throws std::runtime_error if the segment lies outside the pixels
+	 */
+	CollisionMask(const PixelBuffer & pixels, D2D_RECT_F segment);
+
+	/**
+	 * Counts the pixels which are opaque in both masks, the second one centered at the given offset from the first.
+	 * @param offset the shortest offset between the centers, see minimumImage, so that masks on a looped rectangle
+	 * are tested where they come closest
+	 * @param limit stops counting once this many pixels were found, e.g. 1 to only find out whether they touch
+	 * @return the number of pixels found, up to the limit
+	 */
+	[[nodiscard]] static size_t overlap(
+	    const CollisionMask & first,
+	    float firstRotation,
+	    const CollisionMask & second,
+	    float secondRotation,
+	    D2D_POINT_2F offset,
+	    size_t limit = SIZE_MAX
+	);
+
+	/**
+	 * @return the number of opaque pixels at the given rotation
+	 */
+	[[nodiscard]] size_t getArea(float rotation) const;
+};
+
+/**
+ * The masks of the sprites the game draws, looked up by the bitmap and segment of a sprite.
+ */
+class CollisionMaskSet {
+	std::vector<BitmapSegment> sprites{};
+	std::vector<CollisionMask> masks{};
+
+public:
+	CollisionMaskSet();
+
+	/**
+	 * Builds the mask of the sprite from the given pixels of its bitmap.
+	 */
+	void add(const BitmapSegment & sprite, const PixelBuffer & pixels);
+
+	/**
+	 * @return the mask of the sprite, or nullptr if it has none
+	 */
+	[[nodiscard]] const CollisionMask * find(const BitmapSegment & sprite) const;
+};
+
+/**
+ * Where an object ended the last move, with the mask of its sprite if it has one.
+ */
+struct MaskPlacement {
+	const CollisionMask * mask{};
+	D2D_POINT_2F location{};
+	// How far the object travelled during the last move, ending at the location.
+	D2D_POINT_2F travel{};
+	float rotation{};
+	float size{};
+};
+
+/**
+ * The narrowphase after circles touched: tests the masks of two objects at points of the last move from the given
+ * fraction on, at which their circles first touched, to its end, no further apart than the smaller object's size.
+ * Both keep their final rotation throughout.
+ * @return whether any of their pixels touched, or true if either has no mask, leaving the circles to decide
+ */
+[[nodiscard]] bool
+pixelsTouch(const MaskPlacement & first, const MaskPlacement & second, float time, D2D_RECT_F modulo);
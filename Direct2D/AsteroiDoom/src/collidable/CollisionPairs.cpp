@@ -0,0 +1,13 @@
+#include "CollisionPairs.h"
+
+void CollisionPairBuffer::clear() {
+	pairs.clear();
+}
+
+std::span<const CollisionPair> CollisionPairBuffer::get() const {
+	return pairs;
+}
+
+size_t CollisionPairBuffer::size() const {
+	return pairs.size();
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "../utils/AsteroiDoomConstants.h"
+#include "../utils/ThreadPool.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+enum class CollisionSource : uint8_t {
+	Projectile,
+	Spaceship,
+	Rival,
+	SwarmShip
+};
+
+enum class CollisionTarget : uint8_t {
+	InnerAsteroid,
+	OuterAsteroid,
+	Spaceship,
+	Rival,
+	SwarmShip
+};
+
+/**
+ * A projectile or a ship touching something during the last move, found without changing anything. Whether the
+ * collision still happens is only decided when pairs are resolved, e.g. an asteroid destroyed by an earlier pair
+ * cannot be hit again.
+ */
+struct CollisionPair {
+	CollisionSource source{};
+	CollisionTarget target{};
+	// The rows of the source and the target in their archetypes, or 0 for the spaceships.
+	uint32_t sourceRow{};
+	uint32_t targetRow{};
+	// The fraction of the last move at which they touched, ordering the candidates of a projectile.
+	float time{};
+};
+
+/**
+ * The collision pairs of a step, in the order in which they are resolved, with the memory kept between steps.
+ * Pairs may be detected on many threads at once, each writing its own block of rows, and still come out in the order
+ * of the rows, so that resolving them is deterministic.
+ */
+class CollisionPairBuffer {
+	// The pairs of every block of rows of a parallel detection, merged in order afterwards.
+	std::vector<std::vector<CollisionPair>> blocks{};
+	std::vector<CollisionPair> pairs{};
+
+public:
+	void clear();
+
+	/**
+	 * Calls detect(row, pairs) for every row in [0, count), which appends the pairs of the row, split between the
+	 * threads of the pool if one is given. Detection must only read the state of the arena.
+	 */
+	template <typename Detect>
+	void detect(size_t count, ThreadPool * pool, Detect && detect);
+
+	[[nodiscard]] std::span<const CollisionPair> get() const;
+
+	[[nodiscard]] size_t size() const;
+};
+
+template <typename Detect>
+void CollisionPairBuffer::detect(size_t count, ThreadPool * pool, Detect && detect) {
+	if (!pool) {
+		for (size_t row = 0; row < count; row++) {
+			detect(row, pairs);
+		}
+		return;
+	}
+
+	size_t blockCount = (count + MinParallelDetectRows - 1) / MinParallelDetectRows;
+	if (blocks.size() < blockCount) {
+		blocks.resize(blockCount);
+	}
+	pool->parallelFor(blockCount, 1, [&](size_t begin, size_t end) {
+		for (size_t block = begin; block < end; block++) {
+			blocks[block].clear();
+			size_t last = (block + 1) * MinParallelDetectRows < count ? (block + 1) * MinParallelDetectRows : count;
+			for (size_t row = block * MinParallelDetectRows; row < last; row++) {
+				detect(row, blocks[block]);
+			}
+		}
+	});
+	for (size_t block = 0; block < blockCount; block++) {
+		pairs.insert(pairs.end(), blocks[block].begin(), blocks[block].end());
+	}
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "../utils/BitmapUtils.h"
+#include "../utils/Geometry.h"
+#include "../utils/Input.h"
+#include "Archetype.h"
+
+#include <cstdint>
+
+// Components of entities kept in archetypes. Each one is a distinct type, so that columns can be queried by type.
+
+struct Location {
+	D2D_POINT_2F value;
+};
+
+struct Velocity {
+	D2D_POINT_2F value;
+};
+
+struct Rotation {
+	float value;
+};
+
+struct Spin {
+	float value;
+};
+
+struct Size {
+	float value;
+};
+
+struct HitPoints {
+	unsigned int value;
+};
+
+struct DamagePoints {
+	unsigned int value;
+};
+
+struct Sprite {
+	BitmapSegment value;
+};
+
+// The location and rotation before the last move, between which and the current ones frames are interpolated.
+
+struct PreviousLocation {
+	D2D_POINT_2F value;
+};
+
+struct PreviousRotation {
+	float value;
+};
+
+// Components of pooled projectiles.
+
+struct TimeToLive {
+	unsigned int value;
+};
+
+struct PoolSlot {
+	uint32_t value;
+};
+
+// Components of ships steered by a controller.
+
+struct ShipInput {
+	InputState value;
+};
+
+struct PreviousShot {
+	unsigned long long value;
+};
+
+struct ShotCount {
+	unsigned long long value;
+};
+
+using AsteroidArchetype = Archetype<
+    Location,
+    Velocity,
+    Rotation,
+    Spin,
+    Size,
+    HitPoints,
+    DamagePoints,
+    Sprite,
+    PreviousLocation,
+    PreviousRotation>;
+
+using ProjectileArchetype = Archetype<
+    Location,
+    Velocity,
+    Rotation,
+    Spin,
+    Size,
+    DamagePoints,
+    Sprite,
+    PreviousLocation,
+    PreviousRotation,
+    TimeToLive,
+    PoolSlot>;
+
+using ShipArchetype = Archetype<
+    Location,
+    Velocity,
+    Rotation,
+    Spin,
+    Size,
+    HitPoints,
+    Sprite,
+    PreviousLocation,
+    PreviousRotation,
+    ShipInput,
+    PreviousShot,
+    ShotCount>;
+
+using ParticleArchetype = Archetype<Location, Velocity, Rotation, Spin, TimeToLive>;
@@ -0,0 +1,213 @@
+#include "ParticleSystem.h"
+
+#include "../utils/AsteroiDoomConstants.h"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ASTEROIDOOM_SSE2
+#endif
+
+namespace {
+	// Debris per unit of the size of the object exploding, so that bigger asteroids burst into more of it.
+	const float ExplosionParticlesPerSize = 2;
+	const float ExplosionMinSpeed = 40;
+	const float ExplosionMaxSpeed = 260;
+	const unsigned int ExplosionMinTimeToLive = 300;
+	const unsigned int ExplosionMaxTimeToLive = 900;
+
+	const unsigned int ExhaustParticlesPerStep = 2;
+	const float ExhaustSpeed = 240;
+	// How far the exhaust fans out to either side of the ship's back, in degrees.
+	const float ExhaustSpread = 15;
+	const unsigned int ExhaustTimeToLive = 250;
+
+	const float MaxParticleSpin = 720;
+
+	// The moves below read the columns of locations and velocities as arrays of floats, x and y alternating.
+	static_assert(sizeof(Location) == 2 * sizeof(float) && sizeof(Velocity) == 2 * sizeof(float));
+	static_assert(sizeof(Rotation) == sizeof(float) && sizeof(Spin) == sizeof(float));
+
+#if defined(ASTEROIDOOM_SSE2)
+
+	/**
+	 * Moves the particles in rows [0, count) four at a time, by the same operations as MovementData::move, so that
+	 * the results are identical: each coordinate is wrapped by at most one width or height, and each rotation by at
+	 * most one turn.
+	 * @return the number of rows moved, a multiple of four, leaving the rest to be moved one by one
+	 */
+	size_t moveVectorized(
+	    float * locations,
+	    const float * velocities,
+	    float * rotations,
+	    const float * spins,
+	    size_t count,
+	    float seconds,
+	    D2D_RECT_F modulo
+	) {
+		const __m128 step = _mm_set1_ps(seconds);
+		// Two particles per register, x and y alternating like in the columns.
+		const __m128 low = _mm_setr_ps(modulo.left, modulo.top, modulo.left, modulo.top);
+		const __m128 high = _mm_setr_ps(modulo.right, modulo.bottom, modulo.right, modulo.bottom);
+		float width = modulo.right - modulo.left, height = modulo.bottom - modulo.top;
+		const __m128 extent = _mm_setr_ps(width, height, width, height);
+		const __m128 noTurn = _mm_setzero_ps();
+		const __m128 fullTurn = _mm_set1_ps(360);
+
+		size_t row = 0;
+		for (; row + 4 <= count; row += 4) {
+			for (size_t pair = 0; pair < 2; pair++) {
+				float * location = locations + 2 * (row + 2 * pair);
+				__m128 moved = _mm_add_ps(
+				    _mm_loadu_ps(location), _mm_mul_ps(_mm_loadu_ps(velocities + 2 * (row + 2 * pair)), step)
+				);
+				// Below the rectangle and above it exclude each other, so adding and subtracting zero changes nothing.
+				__m128 below = _mm_and_ps(_mm_cmplt_ps(moved, low), extent);
+				__m128 above = _mm_and_ps(_mm_cmpgt_ps(moved, high), extent);
+				_mm_storeu_ps(location, _mm_sub_ps(_mm_add_ps(moved, below), above));
+			}
+			__m128 angle = _mm_add_ps(_mm_loadu_ps(rotations + row), _mm_mul_ps(_mm_loadu_ps(spins + row), step));
+			__m128 below = _mm_and_ps(_mm_cmplt_ps(angle, noTurn), fullTurn);
+			__m128 above = _mm_and_ps(_mm_cmpgt_ps(angle, fullTurn), fullTurn);
+			_mm_storeu_ps(rotations + row, _mm_sub_ps(_mm_add_ps(angle, below), above));
+		}
+		return row;
+	}
+
+#endif
+} // namespace
+
+ParticleSystem::ParticleSystem() = default;
+
+ParticleSystem::ParticleSystem(size_t capacity, BitmapSegment sprite) : particleCapacity(capacity), sprite(sprite) {
+	particles.reserve(capacity);
+}
+
+bool ParticleSystem::emit(MovementData movement, unsigned int timeToLive) {
+	if (particles.size() == particleCapacity) {
+		return false;
+	}
+	particles.add({movement.location}, {movement.velocity}, {movement.rotation}, {movement.spin}, {timeToLive});
+	return true;
+}
+
+void ParticleSystem::emitExplosion(D2D_POINT_2F location, D2D_POINT_2F velocity, float size, Random & random) {
+	auto count = size_t(size * ExplosionParticlesPerSize);
+	for (size_t particle = 0; particle < count; particle++) {
+		// Direction, speed, distance from the center, rotation and spin, each in [0, 1).
+		float values[5];
+		random.fill(values, 5, 0, 1);
+		float direction = values[0] * 360 * RadiansInDegree;
+		float speed = ExplosionMinSpeed + values[1] * (ExplosionMaxSpeed - ExplosionMinSpeed);
+		float distance = values[2] * size;
+		MovementData movement(
+		    {location.x + distance * std::cos(direction), location.y + distance * std::sin(direction)},
+		    values[3] * 360,
+		    {velocity.x + speed * std::cos(direction), velocity.y + speed * std::sin(direction)},
+		    (values[4] * 2 - 1) * MaxParticleSpin
+		);
+		if (!emit(movement, random.next(ExplosionMinTimeToLive, ExplosionMaxTimeToLive))) {
+			return;
+		}
+	}
+}
+
+void ParticleSystem::emitExhaust(const MovementData & ship, float shipSize, Random & random) {
+	for (unsigned int particle = 0; particle < ExhaustParticlesPerStep; particle++) {
+		// Spread and speed in [-1, 1).
+		float values[2];
+		random.fill(values, 2, -1, 1);
+		// A ship faces (sin, -cos) of its rotation, see Spaceship::applyThrusters, so its back faces the opposite.
+		float direction = (ship.rotation + values[0] * ExhaustSpread) * RadiansInDegree;
+		D2D_POINT_2F backwards{-std::sin(direction), std::cos(direction)};
+		float speed = ExhaustSpeed * (1 + values[1] / 4);
+		MovementData movement(
+		    {ship.location.x + backwards.x * shipSize, ship.location.y + backwards.y * shipSize},
+		    ship.rotation,
+		    {ship.velocity.x + backwards.x * speed, ship.velocity.y + backwards.y * speed},
+		    0
+		);
+		if (!emit(movement, ExhaustTimeToLive)) {
+			return;
+		}
+	}
+}
+
+void ParticleSystem::move(unsigned int millis, D2D_RECT_F modulo) {
+	auto timesToLive = particles.column<TimeToLive>();
+	// Going backwards, every particle moved into a freed row has already been aged.
+	for (size_t particle = particles.size(); particle-- > 0;) {
+		if (timesToLive[particle].value <= millis) {
+			particles.remove(particle);
+		} else {
+			timesToLive[particle].value -= millis;
+		}
+	}
+
+	auto locations = particles.column<Location>();
+	auto velocities = particles.column<Velocity>();
+	auto rotations = particles.column<Rotation>();
+	auto spins = particles.column<Spin>();
+	size_t first = 0;
+#if defined(ASTEROIDOOM_SSE2)
+	if (vectorized && !particles.empty()) {
+		first = moveVectorized(
+		    &locations.data()->value.x,
+		    &velocities.data()->value.x,
+		    &rotations.data()->value,
+		    &spins.data()->value,
+		    particles.size(),
+		    float(millis) / 1000,
+		    modulo
+		);
+	}
+#endif
+	for (size_t particle = first; particle < particles.size(); particle++) {
+		MovementData::move(
+		    locations[particle].value,
+		    rotations[particle].value,
+		    velocities[particle].value,
+		    spins[particle].value,
+		    millis,
+		    modulo
+		);
+	}
+}
+
+void ParticleSystem::draw(DrawBackend & backend, D2D_RECT_F visibleRectangle) const {
+	auto locations = particles.column<Location>();
+	auto rotations = particles.column<Rotation>();
+	float radius = sprite.getBoundingRadius();
+	D2D_RECT_F visible{
+	    visibleRectangle.left - radius,
+	    visibleRectangle.top - radius,
+	    visibleRectangle.right + radius,
+	    visibleRectangle.bottom + radius};
+	for (size_t particle = 0; particle < particles.size(); particle++) {
+		auto [x, y] = locations[particle].value;
+		if (visible.left <= x && x <= visible.right && visible.top <= y && y <= visible.bottom) {
+			backend.drawSprite(sprite, locations[particle].value, rotations[particle].value);
+		}
+	}
+}
+
+void ParticleSystem::clear() {
+	particles.clear();
+}
+
+size_t ParticleSystem::size() const {
+	return particles.size();
+}
+
+size_t ParticleSystem::capacity() const {
+	return particleCapacity;
+}
+
+const ParticleArchetype & ParticleSystem::entities() const {
+	return particles;
+}
+
+void ParticleSystem::setVectorized(bool enabled) {
+	vectorized = enabled;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "../utils/DrawBackend.h"
+#include "../utils/Random.h"
+#include "Components.h"
+#include "base/CollidableObject.h"
+
+#include <cstddef>
+
+/**
+ * Short-lived sprites which only show what happens, such as the exhaust of thrusters and the debris of destroyed
+ * asteroids, without ever taking part in the game.
+ *
+ * Particles are kept densely in an archetype of a fixed capacity, allocated up front, so emitting them never
+ * allocates and particles emitted while it is full are dropped. Every move removes the expired ones first, moving
+ * the last particle into the freed row, then moves the rest like MovementData::move, several at a time with SIMD when
+ * compiled with SSE2. All particles share one sprite, so that they are submitted as one batch.
+ */
+class ParticleSystem {
+	ParticleArchetype particles{};
+	size_t particleCapacity{};
+	BitmapSegment sprite{};
+	bool vectorized{true};
+
+public:
+	ParticleSystem();
+
+	ParticleSystem(size_t capacity, BitmapSegment sprite);
+
+	/**
+	 * Adds a particle which lives for the given time.
+	 * @return whether it was added, i.e. the system was not full
+	 */
+	bool emit(MovementData movement, unsigned int timeToLive);
+
+	/**
+	 * Bursts an object of the given size into debris flying apart from where it was, carried along by its velocity.
+	 */
+	void emitExplosion(D2D_POINT_2F location, D2D_POINT_2F velocity, float size, Random & random);
+
+	/**
+	 * Blows exhaust out of the back of a ship of the given size, for one step of its thrusters.
+	 */
+	void emitExhaust(const MovementData & ship, float shipSize, Random & random);
+
+	/**
+	 * Removes the particles which expire within the given time, then moves the others.
+	 */
+	void move(unsigned int millis, D2D_RECT_F modulo);
+
+	/**
+	 * Draws every particle where it is, without interpolating between steps, which hardly shows on short-lived
+	 * particles. Particles whose sprite does not intersect the visible rectangle, e.g. the ones crossing the spawn
+	 * area around the screen, are skipped.
+	 */
+	void draw(DrawBackend & backend, D2D_RECT_F visibleRectangle) const;
+
+	void clear();
+
+	[[nodiscard]] size_t size() const;
+
+	[[nodiscard]] size_t capacity() const;
+
+	[[nodiscard]] const ParticleArchetype & entities() const;
+
+	/**
+	 * Chooses between moving particles with SIMD, when compiled with SSE2, and one by one, with identical results.
+	 */
+	void setVectorized(bool enabled);
+};
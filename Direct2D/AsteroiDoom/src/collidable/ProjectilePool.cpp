@@ -0,0 +1,116 @@
+#include "ProjectilePool.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+ProjectilePool::ProjectilePool() = default;
+
+ProjectilePool::ProjectilePool(size_t capacity) : rows(capacity), generations(capacity, 1) {
+	projectiles.reserve(capacity);
+	freeSlots.reserve(capacity);
+	// Slots are taken from the back, so the lowest ones are used first.
+	for (size_t slot = capacity; slot-- > 0;) {
+		freeSlots.push_back(uint32_t(slot));
+	}
+}
+
+ProjectileHandle ProjectilePool::add(
+    MovementData movement, float size, unsigned int damagePoints, BitmapSegment bitmapSegment, unsigned int timeToLive
+) {
+	if (freeSlots.empty()) {
+		return {};
+	}
+	uint32_t slot = freeSlots.back();
+	freeSlots.pop_back();
+
+	rows[slot] = uint32_t(projectiles.add(
+	    {movement.location},
+	    {movement.velocity},
+	    {movement.rotation},
+	    {movement.spin},
+	    {size},
+	    {damagePoints},
+	    {bitmapSegment},
+	    {movement.location},
+	    {movement.rotation},
+	    {timeToLive},
+	    {slot}
+	));
+	highWaterMark = std::max(highWaterMark, projectiles.size());
+	return {slot, generations[slot]};
+}
+
+void ProjectilePool::remove(size_t row) {
+	auto slots = projectiles.column<PoolSlot>();
+	uint32_t slot = slots[row].value;
+	rows[slots.back().value] = uint32_t(row);
+	projectiles.remove(row);
+
+	// Skipping 0 on overflow keeps default handles dead.
+	if (++generations[slot] == 0) {
+		generations[slot] = 1;
+	}
+	freeSlots.push_back(slot);
+}
+
+void ProjectilePool::age(unsigned int millis) {
+	auto timesToLive = projectiles.column<TimeToLive>();
+	// Going backwards, every projectile moved into a freed row has already been aged.
+	for (size_t projectile = projectiles.size(); projectile-- > 0;) {
+		if (timesToLive[projectile].value <= millis) {
+			remove(projectile);
+		} else {
+			timesToLive[projectile].value -= millis;
+		}
+	}
+}
+
+bool ProjectilePool::isAlive(ProjectileHandle handle) const {
+	return handle.slot < generations.size() && generations[handle.slot] == handle.generation;
+}
+
+std::optional<size_t> ProjectilePool::rowOf(ProjectileHandle handle) const {
+	if (!isAlive(handle)) {
+		return std::nullopt;
+	}
+	return rows[handle.slot];
+}
+
+ProjectileArchetype & ProjectilePool::entities() {
+	return projectiles;
+}
+
+const ProjectileArchetype & ProjectilePool::entities() const {
+	return projectiles;
+}
+
+size_t ProjectilePool::size() const {
+	return projectiles.size();
+}
+
+size_t ProjectilePool::capacity() const {
+	return generations.size();
+}
+
+size_t ProjectilePool::getHighWaterMark() const {
+	return highWaterMark;
+}
+
+void ProjectilePool::save(SnapshotWriter & writer) const {
+	projectiles.save(writer);
+	writer.writeAll(std::span<const uint32_t>(rows));
+	writer.writeAll(std::span<const uint32_t>(generations));
+	writer.writeAll(std::span<const uint32_t>(freeSlots));
+	writer.write(highWaterMark);
+}
+
+void ProjectilePool::restore(SnapshotReader & reader) {
+	projectiles.restore(reader);
+	reader.readAll(rows);
+	reader.readAll(generations);
+	reader.readAll(freeSlots);
+	reader.read(highWaterMark);
+	if (generations.size() != rows.size() || projectiles.size() + freeSlots.size() != rows.size()) {
+		throw std::runtime_error("The restored projectiles do not fill their slots.");
+	}
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Components.h"
+#include "base/CollidableObject.h"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+/**
+ * Refers to a projectile for as long as it lives, and to nothing once it is removed, even if its slot is reused.
+ * A default constructed handle refers to nothing.
+ */
+struct ProjectileHandle {
+	uint32_t slot{};
+	uint32_t generation{};
+};
+
+/**
+ * Projectiles of a fixed maximum count, kept densely in an archetype and expiring after their time to live.
+ * All memory is allocated up front, so adding and removing projectiles never allocates.
+ */
+class ProjectilePool {
+	ProjectileArchetype projectiles{};
+
+	// Indexed by slot. Generations start at 1, so that default handles are never alive.
+	std::vector<uint32_t> rows{};
+	std::vector<uint32_t> generations{};
+	std::vector<uint32_t> freeSlots{};
+
+	size_t highWaterMark{};
+
+public:
+	ProjectilePool();
+
+	explicit ProjectilePool(size_t capacity);
+
+	/**
+	 * @return the handle of the added projectile, or one referring to nothing if the pool is full
+	 */
+	ProjectileHandle add(
+	    MovementData movement,
+	    float size,
+	    unsigned int damagePoints,
+	    BitmapSegment bitmapSegment,
+	    unsigned int timeToLive
+	);
+
+	/**
+	 * Removes the projectile in the given row, moving the last projectile into it.
+	 */
+	void remove(size_t row);
+
+	/**
+	 * Shortens the time to live of every projectile and removes the ones which expire.
+	 */
+	void age(unsigned int millis);
+
+	[[nodiscard]] bool isAlive(ProjectileHandle handle) const;
+
+	/**
+	 * @return the current row of the projectile, if it is alive
+	 */
+	[[nodiscard]] std::optional<size_t> rowOf(ProjectileHandle handle) const;
+
+	/**
+	 * Projectiles may be modified through the archetype, but not added or removed.
+	 */
+	[[nodiscard]] ProjectileArchetype & entities();
+
+	[[nodiscard]] const ProjectileArchetype & entities() const;
+
+	[[nodiscard]] size_t size() const;
+
+	[[nodiscard]] size_t capacity() const;
+
+	/**
+	 * @return the largest number of projectiles alive at once
+	 */
+	[[nodiscard]] size_t getHighWaterMark() const;
+
+	/**
+	 * Writes the projectiles together with their slots and generations, so that handles stay valid across a restore.
+	 */
+	void save(SnapshotWriter & writer) const;
+
+	/**
+	 * Reads back the projectiles written by save, reusing the memory of the pool.
+	 * @throws std::runtime_error if the snapshot is malformed
+	 */
+	void restore(SnapshotReader & reader);
+};
@@ -0,0 +1,164 @@
+#include "Swarm.h"
+
+#include "../utils/AsteroiDoomConstants.h"
+
+#include <utility>
+
+namespace {
+	void moveRows(
+	    ShipArchetype & ships,
+	    size_t begin,
+	    size_t end,
+	    const ThrusterData & thrusters,
+	    unsigned int millis,
+	    D2D_RECT_F modulo
+	) {
+		auto locations = ships.column<Location>();
+		auto rotations = ships.column<Rotation>();
+		auto velocities = ships.column<Velocity>();
+		auto spins = ships.column<Spin>();
+		auto previousLocations = ships.column<PreviousLocation>();
+		auto previousRotations = ships.column<PreviousRotation>();
+		auto inputs = ships.column<ShipInput>();
+		for (size_t ship = begin; ship < end; ship++) {
+			Spaceship::applyThrusters(
+			    velocities[ship].value, spins[ship].value, rotations[ship].value, thrusters, inputs[ship].value, millis
+			);
+			previousLocations[ship].value = locations[ship].value;
+			previousRotations[ship].value = rotations[ship].value;
+			MovementData::move(
+			    locations[ship].value, rotations[ship].value, velocities[ship].value, spins[ship].value, millis, modulo
+			);
+		}
+	}
+} // namespace
+
+Swarm::Swarm() = default;
+
+Swarm::Swarm(
+    std::shared_ptr<const ShipController> controller,
+    ThrusterData thrusters,
+    float gunOffset,
+    unsigned long long gunCooldown,
+    BitmapSegment projectileBitmapSegment
+) :
+    controller(std::move(controller)),
+    thrusters(thrusters),
+    gunOffset(gunOffset),
+    gunCooldown(gunCooldown),
+    projectileBitmapSegment(projectileBitmapSegment) {
+}
+
+void Swarm::add(float size, MovementData movement, BitmapSegment bitmapSegment, unsigned int hitPoints) {
+	ships.add(
+	    {movement.location},
+	    {movement.velocity},
+	    {movement.rotation},
+	    {movement.spin},
+	    {size},
+	    {hitPoints},
+	    {bitmapSegment},
+	    {movement.location},
+	    {movement.rotation},
+	    {},
+	    {},
+	    {}
+	);
+}
+
+void Swarm::spawn(
+    size_t count, float size, BitmapSegment bitmapSegment, unsigned int hitPoints, D2D_RECT_F area, Random & random
+) {
+	ships.reserve(ships.size() + count);
+	for (size_t ship = 0; ship < count; ship++) {
+		MovementData movement{};
+		movement.location = {
+		    area.left + (area.right - area.left) * random.nextFloat(),
+		    area.top + (area.bottom - area.top) * random.nextFloat()};
+		movement.rotation = float(random.next(0, 360));
+		add(size, movement, bitmapSegment, hitPoints);
+	}
+}
+
+void Swarm::control(const ControlContext & context, ThreadPool * pool) {
+	if (!controller) {
+		return;
+	}
+	if (!pool) {
+		controller->control(ships, 0, ships.size(), context);
+		return;
+	}
+	pool->parallelFor(ships.size(), MinParallelShipRows, [&](size_t begin, size_t end) {
+		controller->control(ships, begin, end, context);
+	});
+}
+
+void Swarm::move(unsigned int millis, D2D_RECT_F modulo, ThreadPool * pool) {
+	if (!pool) {
+		moveRows(ships, 0, ships.size(), thrusters, millis, modulo);
+		return;
+	}
+	pool->parallelFor(ships.size(), MinParallelShipRows, [&](size_t begin, size_t end) {
+		moveRows(ships, begin, end, thrusters, millis, modulo);
+	});
+}
+
+void Swarm::shoot(unsigned long long timestamp, ProjectilePool & projectiles) {
+	auto locations = ships.column<Location>();
+	auto rotations = ships.column<Rotation>();
+	auto sizes = ships.column<Size>();
+	auto inputs = ships.column<ShipInput>();
+	auto previousShots = ships.column<PreviousShot>();
+	auto shotCounts = ships.column<ShotCount>();
+	for (size_t ship = 0; ship < ships.size(); ship++) {
+		if (!inputs[ship].value.isPressed(Key::Shoot) || timestamp - previousShots[ship].value < gunCooldown) {
+			continue;
+		}
+		previousShots[ship].value = timestamp;
+		MovementData movement = Spaceship::projectileSpawnMovement(
+		    locations[ship].value, rotations[ship].value, sizes[ship].value, gunOffset, ++shotCounts[ship].value
+		);
+		projectiles.add(movement, ProjectileSize, ProjectileDamage, projectileBitmapSegment, ProjectileTimeToLive);
+	}
+}
+
+void Swarm::rebuildGrid(D2D_RECT_F modulo) {
+	grid.rebuild(ships, modulo);
+}
+
+bool Swarm::removeDestroyed() {
+	auto hitPoints = ships.column<HitPoints>();
+	bool removed = false;
+	// Going backwards, every ship moved into a freed row has already been checked.
+	for (size_t ship = ships.size(); ship-- > 0;) {
+		if (hitPoints[ship].value == 0) {
+			ships.remove(ship);
+			removed = true;
+		}
+	}
+	return removed;
+}
+
+ShipArchetype & Swarm::entities() {
+	return ships;
+}
+
+const ShipArchetype & Swarm::entities() const {
+	return ships;
+}
+
+const CollisionGrid & Swarm::getGrid() const {
+	return grid;
+}
+
+size_t Swarm::size() const {
+	return ships.size();
+}
+
+void Swarm::save(SnapshotWriter & writer) const {
+	ships.save(writer);
+}
+
+void Swarm::restore(SnapshotReader & reader) {
+	ships.restore(reader);
+}
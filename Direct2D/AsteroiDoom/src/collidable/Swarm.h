@@ -0,0 +1,93 @@
+#pragma once
+
+#include "../ai/ShipController.h"
+#include "../utils/Random.h"
+#include "../utils/ThreadPool.h"
+#include "CollisionGrid.h"
+#include "Components.h"
+#include "ProjectilePool.h"
+#include "specific/Spaceship.h"
+
+#include <memory>
+
+/**
+ * Ships steered by a controller rather than the keyboard, e.g. hundreds of them to load the simulation.
+ * All ships of a swarm share their thrusters and guns, and are kept in an archetype like asteroids.
+ */
+class Swarm {
+	ShipArchetype ships{};
+	std::shared_ptr<const ShipController> controller{};
+	ThrusterData thrusters{};
+	float gunOffset{};
+	unsigned long long gunCooldown{};
+	BitmapSegment projectileBitmapSegment{};
+
+	// Broadphase over the ships, for projectiles to hit them.
+	CollisionGrid grid{};
+
+public:
+	Swarm();
+
+	Swarm(
+	    std::shared_ptr<const ShipController> controller,
+	    ThrusterData thrusters,
+	    float gunOffset,
+	    unsigned long long gunCooldown,
+	    BitmapSegment projectileBitmapSegment
+	);
+
+	void add(float size, MovementData movement, BitmapSegment bitmapSegment, unsigned int hitPoints);
+
+	/**
+	 * Adds ships at random locations in the given rectangle, facing random directions.
+	 */
+	void spawn(
+	    size_t count, float size, BitmapSegment bitmapSegment, unsigned int hitPoints, D2D_RECT_F area, Random & random
+	);
+
+	/**
+	 * Lets the controller decide the input of every ship, split between the threads of the pool if one is given.
+	 */
+	void control(const ControlContext & context, ThreadPool * pool);
+
+	/**
+	 * Applies the thrusters of every ship according to its input, then moves it, split between the threads of the
+	 * pool if one is given. Every ship is moved by the same operations either way, so the results are identical.
+	 */
+	void move(unsigned int millis, D2D_RECT_F modulo, ThreadPool * pool);
+
+	/**
+	 * Fires the guns of the ships which want to shoot and whose guns have cooled down, in the order of rows.
+	 */
+	void shoot(unsigned long long timestamp, ProjectilePool & projectiles);
+
+	void rebuildGrid(D2D_RECT_F modulo);
+
+	/**
+	 * Removes ships without hit points left.
+	 * @return whether any ship was removed
+	 */
+	bool removeDestroyed();
+
+	/**
+	 * Ships may be modified through the archetype, but not added or removed.
+	 */
+	[[nodiscard]] ShipArchetype & entities();
+
+	[[nodiscard]] const ShipArchetype & entities() const;
+
+	[[nodiscard]] const CollisionGrid & getGrid() const;
+
+	[[nodiscard]] size_t size() const;
+
+	/**
+	 * Writes the ships, but neither the controller nor the guns and thrusters, which stay the same during a game.
+	 */
+	void save(SnapshotWriter & writer) const;
+
+	/**
+	 * Reads back the ships written by save. The grid is outdated until the next rebuild.
+	 * @throws std::runtime_error if the snapshot is malformed
+	 */
+	void restore(SnapshotReader & reader);
+};
@@ -0,0 +1,43 @@
+#include "SweptCollision.h"
+
+#include <cmath>
+
+std::optional<float> timeOfImpact(
+    D2D_POINT_2F firstLocation,
+    D2D_POINT_2F firstTravel,
+    float firstSize,
+    D2D_POINT_2F secondLocation,
+    D2D_POINT_2F secondTravel,
+    float secondSize,
+    D2D_RECT_F modulo
+) {
+	// Relative to the first circle, the second one travels along start + travel * t for t in [0, 1].
+	D2D_POINT_2F travel{secondTravel.x - firstTravel.x, secondTravel.y - firstTravel.y};
+	D2D_POINT_2F halfway = minimumImage(
+	    {secondLocation.x - firstLocation.x - travel.x / 2, secondLocation.y - firstLocation.y - travel.y / 2}, modulo
+	);
+	D2D_POINT_2F start{halfway.x - travel.x / 2, halfway.y - travel.y / 2};
+	float radius = firstSize + secondSize;
+
+	// |start + travel * t|^2 = radius^2
+	float a = travel.x * travel.x + travel.y * travel.y;
+	float b = 2 * (start.x * travel.x + start.y * travel.y);
+	float c = start.x * start.x + start.y * start.y - radius * radius;
+	if (c <= 0) {
+		return 0.f;
+	}
+	float discriminant = b * b - 4 * a * c;
+	if (a == 0 || b >= 0 || discriminant < 0) {
+		return std::nullopt;
+	}
+	float time = (-b - std::sqrt(discriminant)) / (2 * a);
+	if (time > 1) {
+		// Rounding may push the impact of circles which overlap at the end of the step just past it.
+		D2D_POINT_2F end{start.x + travel.x, start.y + travel.y};
+		if (end.x * end.x + end.y * end.y > radius * radius) {
+			return std::nullopt;
+		}
+		time = 1;
+	}
+	return time;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "../utils/Geometry.h"
+
+#include <optional>
+
+/**
+ * @return the value rounded to the nearest integer, ties to even, exactly as std::nearbyint rounds it for values
+ * below 2^22 in magnitude, but without the library call it is compiled to without SSE4.1
+ */
+[[nodiscard]] inline float roundToNearest(float value) {
+	// At 1.5 * 2^23, floats have no fractional bits left, so adding it rounds the fraction away.
+	const float shift = 12582912.f;
+	return value + shift - shift;
+}
+
+/**
+ * @return the shortest vector on a looped rectangle equivalent to the given one, wrapped into
+ * [-width / 2, width / 2] x [-height / 2, height / 2]
+ */
+[[nodiscard]] inline D2D_POINT_2F minimumImage(D2D_POINT_2F offset, D2D_RECT_F modulo) {
+	float width = modulo.right - modulo.left;
+	float height = modulo.bottom - modulo.top;
+	return {offset.x - width * roundToNearest(offset.x / width), offset.y - height * roundToNearest(offset.y / height)};
+}
+
+/**
+ * Tests two circles, each of which travelled in a straight line during the last step and ended at the given location,
+ * e.g. a projectile which would have flown through an asteroid between two steps.
+ *
+ * The circles are taken at the translation which brings them closest halfway through the step, so the travel of
+ * either must be shorter than half of the looped rectangle.
+ *
+ * @return the earliest fraction of the step in [0, 1] at which the circles touched, 0 if they already overlapped
+ * at its start, or nothing if they never touched
+ */
+[[nodiscard]] std::optional<float> timeOfImpact(
+    D2D_POINT_2F firstLocation,
+    D2D_POINT_2F firstTravel,
+    float firstSize,
+    D2D_POINT_2F secondLocation,
+    D2D_POINT_2F secondTravel,
+    float secondSize,
+    D2D_RECT_F modulo
+);
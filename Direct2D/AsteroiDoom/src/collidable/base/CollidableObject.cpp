@@ -1,10 +1,12 @@
 #include "CollidableObject.h"
 
-#include <limits>
+#include <cmath>
 
 namespace {
-	float square(float x) {
-		return x * x;
+	float interpolateWrapped(float value, float previousValue, float alpha, float period) {
+		float difference = value - previousValue;
+		difference -= period * std::round(difference / period);
+		return value - (1 - alpha) * difference;
 	}
 } // namespace
 
@@ -18,62 +20,90 @@ MovementData::MovementData(D2D_POINT_2F location, float rotation, D2D_POINT_2F v
 }
 
 void MovementData::move(unsigned int millis, D2D_RECT_F modulo) {
+	move(location, rotation, velocity, spin, millis, modulo);
+}
+
+void MovementData::move(
+    D2D_POINT_2F & position,
+    float & angle,
+    D2D_POINT_2F linearVelocity,
+    float angularVelocity,
+    unsigned int millis,
+    D2D_RECT_F modulo
+) {
 	float seconds = float(millis) / 1000;
 	float width = modulo.right - modulo.left;
 	float height = modulo.bottom - modulo.top;
-	location.x += velocity.x * seconds;
-	location.y += velocity.y * seconds;
-	rotation += spin * seconds;
-	if (location.x < modulo.left) {
-		location.x += width;
-	} else if (location.x > modulo.right) {
-		location.x -= width;
+	position.x += linearVelocity.x * seconds;
+	position.y += linearVelocity.y * seconds;
+	angle += angularVelocity * seconds;
+	if (position.x < modulo.left) {
+		position.x += width;
+	} else if (position.x > modulo.right) {
+		position.x -= width;
 	}
-	if (location.y < modulo.top) {
-		location.y += height;
-	} else if (location.y > modulo.bottom) {
-		location.y -= height;
+	if (position.y < modulo.top) {
+		position.y += height;
+	} else if (position.y > modulo.bottom) {
+		position.y -= height;
 	}
-	if (rotation < 0) {
-		rotation += 360;
-	} else if (rotation > 360) {
-		rotation -= 360;
+	if (angle < 0) {
+		angle += 360;
+	} else if (angle > 360) {
+		angle -= 360;
 	}
 }
 
+void MovementData::interpolate(
+    D2D_POINT_2F & position,
+    float & angle,
+    D2D_POINT_2F previousPosition,
+    float previousAngle,
+    float alpha,
+    D2D_RECT_F modulo
+) {
+	position.x = interpolateWrapped(position.x, previousPosition.x, alpha, modulo.right - modulo.left);
+	position.y = interpolateWrapped(position.y, previousPosition.y, alpha, modulo.bottom - modulo.top);
+	angle = interpolateWrapped(angle, previousAngle, alpha, 360);
+}
+
 CollidableObject::CollidableObject() = default;
 
 CollidableObject::CollidableObject(float size, MovementData movement, BitmapSegment bitmapSegment) :
     size(size),
     movement(movement),
+    previousMovement(movement),
     bitmapSegment(bitmapSegment) {
 }
 
-float CollidableObject::squareDistanceFrom(const CollidableObject & other, D2D_RECT_F modulo) const {
-	const static float mxFactors[9] = {0, -1, -1, 0, 1, 1, 1, 0, -1};
-	const static float myFactors[9] = {0, 0, -1, -1, -1, 0, 1, 1, 1};
-	float mx = modulo.right - modulo.left;
-	float my = modulo.bottom - modulo.top;
-	auto & [x, y] = movement.location;
-	auto & [ox, oy] = other.movement.location;
+float CollidableObject::getSize() const {
+	return size;
+}
 
-	float result = std::numeric_limits<float>::infinity();
+D2D_POINT_2F CollidableObject::getLocation() const {
+	return movement.location;
+}
 
-	for (int i = 0; i < 9; i++) {
-		result = min(result, square(x + mxFactors[i] * mx - ox) + square(y + myFactors[i] * my - oy));
-	}
+D2D_POINT_2F CollidableObject::getPreviousLocation() const {
+	return previousMovement.location;
+}
 
-	return result;
+MovementData CollidableObject::getMovement() const {
+	return movement;
 }
 
-bool CollidableObject::collidesWith(const CollidableObject & other, D2D_RECT_F modulo) const {
-	return square(size + other.size) >= squareDistanceFrom(other, modulo);
+BitmapSegment CollidableObject::getBitmapSegment() const {
+	return bitmapSegment;
 }
 
 bool CollidableObject::isInside(D2D_RECT_F rectangle) const {
+	return isInside(movement.location, size, rectangle);
+}
+
+bool CollidableObject::isInside(D2D_POINT_2F center, float radius, D2D_RECT_F rectangle) {
 	auto & [left, top, right, bottom] = rectangle;
-	auto & [x, y] = movement.location;
-	return left <= x - size && x + size <= right && top <= y - size && y + size <= bottom;
+	auto & [x, y] = center;
+	return left <= x - radius && x + radius <= right && top <= y - radius && y + radius <= bottom;
 }
 
 void CollidableObject::draw(D2D_POINT_2F translation, float opacity, D2D1_BITMAP_INTERPOLATION_MODE interpolationMode)
@@ -86,6 +116,25 @@ void CollidableObject::draw(D2D_POINT_2F translation, float opacity, D2D1_BITMAP
 	);
 }
 
+MovementData CollidableObject::getInterpolatedMovement(float alpha, D2D_RECT_F modulo) const {
+	MovementData result = movement;
+	MovementData::interpolate(
+	    result.location, result.rotation, previousMovement.location, previousMovement.rotation, alpha, modulo
+	);
+	return result;
+}
+
 void CollidableObject::move(unsigned int millis, D2D_RECT_F modulo) {
+	previousMovement = movement;
 	movement.move(millis, modulo);
 }
+
+void CollidableObject::save(SnapshotWriter & writer) const {
+	writer.write(movement);
+	writer.write(previousMovement);
+}
+
+void CollidableObject::restore(SnapshotReader & reader) {
+	reader.read(movement);
+	reader.read(previousMovement);
+}
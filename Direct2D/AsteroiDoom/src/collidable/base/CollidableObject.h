@@ -1,10 +1,9 @@
 #pragma once
 
-#define WIN32_LEAN_AND_MEAN
-
 #include "../../utils/BitmapUtils.h"
-
-#include <d2d1.h>
+#include "../../utils/Geometry.h"
+#include "../../utils/Snapshot.h"
+#include "../SweptCollision.h"
 
 class MovementData {
 public:
@@ -18,14 +17,47 @@ public:
 	MovementData(D2D_POINT_2F location, float rotation, D2D_POINT_2F velocity, float spin);
 
 	void move(unsigned int millis, D2D_RECT_F modulo);
+
+	/**
+	 * Moves an entity stored outside of MovementData, e.g. in the columns of an archetype.
+	 */
+	static void move(
+	    D2D_POINT_2F & position,
+	    float & angle,
+	    D2D_POINT_2F linearVelocity,
+	    float angularVelocity,
+	    unsigned int millis,
+	    D2D_RECT_F modulo
+	);
+
+	/**
+	 * Interpolates the current state of an entity towards the previous one, taking the shorter way across the edges
+	 * of the looped rectangle.
+	 * @param alpha the fraction of the step from the previous to the current state, 1 keeping the current state
+	 */
+	static void interpolate(
+	    D2D_POINT_2F & position,
+	    float & angle,
+	    D2D_POINT_2F previousPosition,
+	    float previousAngle,
+	    float alpha,
+	    D2D_RECT_F modulo
+	);
 };
 
+/**
+ * The base of every kind of entity. Nothing about it is virtual: entity kinds are final classes composed of
+ * CollidableObject and the damage mixins, so calls on them are resolved statically and can be inlined.
+ */
 class CollidableObject {
 protected:
 	const float size{};
 
 	MovementData movement{};
 
+	// The movement before the last move, used to draw the object between simulation steps.
+	MovementData previousMovement{};
+
 	BitmapSegment bitmapSegment{};
 
 protected:
@@ -34,8 +66,31 @@ protected:
 public:
 	CollidableObject(float size, MovementData movement, BitmapSegment bitmapSegment);
 
+	[[nodiscard]] float getSize() const;
+
+	[[nodiscard]] D2D_POINT_2F getLocation() const;
+
+	/**
+	 * @return the location before the last move
+	 */
+	[[nodiscard]] D2D_POINT_2F getPreviousLocation() const;
+
+	[[nodiscard]] MovementData getMovement() const;
+
+	[[nodiscard]] BitmapSegment getBitmapSegment() const;
+
 	[[nodiscard]] float squareDistanceFrom(const CollidableObject & other, D2D_RECT_F modulo) const;
 
+	/**
+	 * @return the square distance between the closest copies of the points on the looped rectangle, see minimumImage
+	 */
+	[[nodiscard]] static float squareDistance(D2D_POINT_2F first, D2D_POINT_2F second, D2D_RECT_F modulo);
+
+	[[nodiscard]] static bool
+	collide(D2D_POINT_2F first, float firstSize, D2D_POINT_2F second, float secondSize, D2D_RECT_F modulo);
+
+	[[nodiscard]] static bool isInside(D2D_POINT_2F center, float radius, D2D_RECT_F rectangle);
+
 	[[nodiscard]] bool collidesWith(const CollidableObject & other, D2D_RECT_F modulo) const;
 
 	[[nodiscard]] bool isInside(D2D_RECT_F rectangle) const;
@@ -46,5 +101,44 @@ public:
 	    D2D1_BITMAP_INTERPOLATION_MODE interpolationMode = D2D1_BITMAP_INTERPOLATION_MODE_LINEAR
 	) const;
 
-	virtual void move(unsigned int millis, D2D_RECT_F modulo);
+	/**
+	 * @param alpha the fraction of the step elapsed since the last move
+	 * @return the movement between the one before and after the last move
+	 */
+	[[nodiscard]] MovementData getInterpolatedMovement(float alpha, D2D_RECT_F modulo) const;
+
+	void move(unsigned int millis, D2D_RECT_F modulo);
+
+	/**
+	 * Writes the movement, the only state of the object which changes, see Snapshot.h.
+	 */
+	void save(SnapshotWriter & writer) const;
+
+	/**
+	 * Reads back the movement written by save.
+	 * @throws std::runtime_error if the snapshot is malformed
+	 */
+	void restore(SnapshotReader & reader);
 };
+
+// The tests of the hot loops of collision detection, defined here so that they are inlined into them.
+
+inline float CollidableObject::squareDistance(D2D_POINT_2F first, D2D_POINT_2F second, D2D_RECT_F modulo) {
+	D2D_POINT_2F offset = minimumImage({second.x - first.x, second.y - first.y}, modulo);
+	return offset.x * offset.x + offset.y * offset.y;
+}
+
+inline bool CollidableObject::collide(
+    D2D_POINT_2F first, float firstSize, D2D_POINT_2F second, float secondSize, D2D_RECT_F modulo
+) {
+	float reach = firstSize + secondSize;
+	return reach * reach >= squareDistance(first, second, modulo);
+}
+
+inline float CollidableObject::squareDistanceFrom(const CollidableObject & other, D2D_RECT_F modulo) const {
+	return squareDistance(movement.location, other.movement.location, modulo);
+}
+
+inline bool CollidableObject::collidesWith(const CollidableObject & other, D2D_RECT_F modulo) const {
+	return collide(movement.location, size, other.movement.location, other.size, modulo);
+}
@@ -1,18 +1,19 @@
 #include "DamagableObject.h"
 
+#include <algorithm>
+
+using std::min;
+
 DamagableObject::DamagableObject(unsigned int hitPoints) : hitPoints(hitPoints) {
 }
 
-DamagableObject::DamagableObject(
-    float size, MovementData movement, BitmapSegment bitmapSegment, unsigned int hitPoints
-) :
-    CollidableObject(size, movement, bitmapSegment),
-    hitPoints(hitPoints) {
+bool DamagableObject::takeDamage(unsigned int points) {
+	return takeDamage(hitPoints, points);
 }
 
-bool DamagableObject::takeDamage(unsigned int points) {
-	hitPoints -= min(points, hitPoints);
-	return destroyed();
+bool DamagableObject::takeDamage(unsigned int & remainingPoints, unsigned int points) {
+	remainingPoints -= min(points, remainingPoints);
+	return remainingPoints == 0;
 }
 
 unsigned int DamagableObject::getHitPoints() const {
@@ -23,6 +24,14 @@ bool DamagableObject::destroyed() const {
 	return hitPoints == 0;
 }
 
-unsigned int DamagableObject::pointsForDestruction() {
-	return (unsigned int)(size) * (unsigned int)(size) / 25;
+unsigned int DamagableObject::pointsForDestruction(float objectSize) {
+	return (unsigned int)(objectSize) * (unsigned int)(objectSize) / 25;
+}
+
+void DamagableObject::save(SnapshotWriter & writer) const {
+	writer.write(hitPoints);
+}
+
+void DamagableObject::restore(SnapshotReader & reader) {
+	reader.read(hitPoints);
 }
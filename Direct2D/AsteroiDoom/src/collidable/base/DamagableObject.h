@@ -1,21 +1,31 @@
 #pragma once
 
-#include "CollidableObject.h"
+#include "../../utils/Snapshot.h"
 
-class DamagableObject : virtual public CollidableObject {
+/**
+ * The hit points of an entity which can be destroyed, mixed into the entity next to CollidableObject.
+ */
+class DamagableObject {
 	unsigned int hitPoints;
 
-protected:
-	explicit DamagableObject(unsigned int hitPoints);
-
 public:
-	DamagableObject(float size, MovementData movement, BitmapSegment bitmapSegment, unsigned int hitPoints);
+	explicit DamagableObject(unsigned int hitPoints);
 
 	bool takeDamage(unsigned int points);
 
+	/**
+	 * Applies damage to hit points stored outside of a DamagableObject, e.g. in the columns of an archetype.
+	 * @return whether the hit points dropped to zero
+	 */
+	static bool takeDamage(unsigned int & remainingPoints, unsigned int points);
+
 	[[nodiscard]] unsigned int getHitPoints() const;
 
 	[[nodiscard]] bool destroyed() const;
 
-	unsigned int pointsForDestruction();
+	static unsigned int pointsForDestruction(float objectSize);
+
+	void save(SnapshotWriter & writer) const;
+
+	void restore(SnapshotReader & reader);
 };
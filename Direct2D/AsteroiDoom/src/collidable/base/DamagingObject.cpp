@@ -3,13 +3,6 @@
 DamagingObject::DamagingObject(unsigned int damagePoints) : damagePoints(damagePoints) {
 }
 
-DamagingObject::DamagingObject(
-    float size, MovementData movement, BitmapSegment bitmapSegment, unsigned int damagePoints
-) :
-    CollidableObject(size, movement, bitmapSegment),
-    damagePoints(damagePoints) {
-}
-
 unsigned int DamagingObject::getDamagePoints() const {
 	return damagePoints;
 }
@@ -1,16 +1,15 @@
 #pragma once
 
-#include "CollidableObject.h"
 #include "DamagableObject.h"
 
-class DamagingObject : virtual public CollidableObject {
+/**
+ * The damage an entity deals on collision, mixed into the entity next to CollidableObject.
+ */
+class DamagingObject {
 	unsigned int damagePoints;
 
-protected:
-	explicit DamagingObject(unsigned int damagePoints);
-
 public:
-	DamagingObject(float size, MovementData movement, BitmapSegment bitmapSegment, unsigned int damagePoints);
+	explicit DamagingObject(unsigned int damagePoints);
 
 	[[nodiscard]] unsigned int getDamagePoints() const;
 
@@ -1,9 +1,10 @@
 #pragma once
 
+#include "../base/CollidableObject.h"
 #include "../base/DamagableObject.h"
 #include "../base/DamagingObject.h"
 
-class Asteroid final : virtual public DamagableObject, virtual public DamagingObject {
+class Asteroid final : public CollidableObject, public DamagableObject, public DamagingObject {
 public:
 	Asteroid(
 	    float size, MovementData movement, BitmapSegment bitmapSegment, unsigned int hitPoints, unsigned int damagePoints
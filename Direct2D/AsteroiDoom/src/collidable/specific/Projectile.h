@@ -1,8 +1,9 @@
 #pragma once
 
+#include "../base/CollidableObject.h"
 #include "../base/DamagingObject.h"
 
-class Projectile final : virtual public DamagingObject {
+class Projectile final : public CollidableObject, public DamagingObject {
 public:
 	Projectile(float size, MovementData movement, BitmapSegment bitmapSegment, unsigned int damagePoints);
 };
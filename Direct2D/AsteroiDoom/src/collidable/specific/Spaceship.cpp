@@ -44,41 +44,60 @@ Spaceship::Spaceship(
     projectileBitmapSegment(projectileBitmapSegment) {
 }
 
-void Spaceship::move(unsigned int millis, D2D_RECT_F modulo) {
+void Spaceship::setInput(InputState newInput) {
+	input = newInput;
+}
+
+void Spaceship::applyThrusters(
+    D2D_POINT_2F & velocity,
+    float & spin,
+    float rotation,
+    const ThrusterData & thrusters,
+    InputState input,
+    unsigned int millis
+) {
 	float seconds = float(millis) / 1000;
 	float boost = 1;
 
 	// decelerate
 	float decelerationFactor = std::pow(thrusters.deceleration, seconds);
-	movement.velocity.x *= decelerationFactor;
-	movement.velocity.y *= decelerationFactor;
-	movement.spin *= decelerationFactor;
+	velocity.x *= decelerationFactor;
+	velocity.y *= decelerationFactor;
+	spin *= decelerationFactor;
 
 	// accelerate
-	if (GetAsyncKeyState(VK_SHIFT)) {
+	if (input.isPressed(Key::Boost)) {
 		boost *= 2;
 	}
-	if (GetAsyncKeyState('W')) {
-		movement.velocity.x += thrusters.thrust * sin(movement.rotation * RadiansInDegree) * seconds * boost;
-		movement.velocity.y += thrusters.thrust * -cos(movement.rotation * RadiansInDegree) * seconds * boost;
+	if (input.isPressed(Key::Thrust)) {
+		velocity.x += thrusters.thrust * sin(rotation * RadiansInDegree) * seconds * boost;
+		velocity.y += thrusters.thrust * -cos(rotation * RadiansInDegree) * seconds * boost;
 	}
-	if (GetAsyncKeyState('S')) {
-		movement.velocity.x -= thrusters.thrust * sin(movement.rotation * RadiansInDegree) * seconds / 2 * boost;
-		movement.velocity.y -= thrusters.thrust * -cos(movement.rotation * RadiansInDegree) * seconds / 2 * boost;
+	if (input.isPressed(Key::Reverse)) {
+		velocity.x -= thrusters.thrust * sin(rotation * RadiansInDegree) * seconds / 2 * boost;
+		velocity.y -= thrusters.thrust * -cos(rotation * RadiansInDegree) * seconds / 2 * boost;
 	}
-	if (GetAsyncKeyState('D')) {
-		movement.spin += thrusters.torque * seconds * boost;
+	if (input.isPressed(Key::TurnRight)) {
+		spin += thrusters.torque * seconds * boost;
 	}
-	if (GetAsyncKeyState('A')) {
-		movement.spin -= thrusters.torque * seconds * boost;
+	if (input.isPressed(Key::TurnLeft)) {
+		spin -= thrusters.torque * seconds * boost;
 	}
+}
 
+void Spaceship::move(unsigned int millis, D2D_RECT_F modulo) {
+	applyThrusters(movement.velocity, movement.spin, movement.rotation, thrusters, input, millis);
 	CollidableObject::move(millis, modulo);
 }
 
 MovementData Spaceship::getProjectileSpawnMovement() {
-	static Side side{};
-	side = Side((int(side) + 1) % 2);
+	return projectileSpawnMovement(movement.location, movement.rotation, size, gunOffset, ++shotCount);
+}
+
+MovementData Spaceship::projectileSpawnMovement(
+    D2D_POINT_2F location, float rotation, float size, float gunOffset, unsigned long long shot
+) {
+	auto side = Side(shot % 2);
 
 	MovementData result{};
 
@@ -97,21 +116,37 @@ MovementData Spaceship::getProjectileSpawnMovement() {
 	result.location.y = -size - 10;
 
 	// Apply spaceship rotation, then translation
-	rotatePair(result.location.x, result.location.y, movement.rotation);
-	rotatePair(result.velocity.x, result.velocity.y, movement.rotation);
-	result.rotation += movement.rotation;
+	rotatePair(result.location.x, result.location.y, rotation);
+	rotatePair(result.velocity.x, result.velocity.y, rotation);
+	result.rotation += rotation;
 
-	result.location.x += movement.location.x;
-	result.location.y += movement.location.y;
+	result.location.x += location.x;
+	result.location.y += location.y;
 
 	return result;
 }
 
-std::unique_ptr<Projectile> Spaceship::shoot(unsigned long long timestamp) {
+std::optional<Projectile> Spaceship::shoot(unsigned long long timestamp) {
 	if (timestamp - previousShotTimestamp < gunCooldown) {
-		return nullptr;
+		return std::nullopt;
 	}
 	previousShotTimestamp = timestamp;
 	MovementData projectileMovement = getProjectileSpawnMovement();
-	return std::make_unique<Projectile>(5, projectileMovement, projectileBitmapSegment, 25);
+	return Projectile(ProjectileSize, projectileMovement, projectileBitmapSegment, ProjectileDamage);
+}
+
+void Spaceship::save(SnapshotWriter & writer) const {
+	CollidableObject::save(writer);
+	DamagableObject::save(writer);
+	writer.write(previousShotTimestamp);
+	writer.write(shotCount);
+	writer.write(input);
+}
+
+void Spaceship::restore(SnapshotReader & reader) {
+	CollidableObject::restore(reader);
+	DamagableObject::restore(reader);
+	reader.read(previousShotTimestamp);
+	reader.read(shotCount);
+	reader.read(input);
 }
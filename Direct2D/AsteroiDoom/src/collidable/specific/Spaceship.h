@@ -1,9 +1,11 @@
 #pragma once
 
+#include "../../utils/Input.h"
+#include "../base/CollidableObject.h"
 #include "../base/DamagableObject.h"
 #include "Projectile.h"
 
-#include <memory>
+#include <optional>
 
 class ThrusterData {
 public:
@@ -16,16 +18,38 @@ public:
 	ThrusterData(float deceleration, float thrust, float torque);
 };
 
-class Spaceship final : virtual public DamagableObject {
+class Spaceship final : public CollidableObject, public DamagableObject {
 	ThrusterData thrusters{};
 	float gunOffset{};
 	unsigned long long gunCooldown{};
 	unsigned long long previousShotTimestamp{};
+	unsigned long long shotCount{};
 	BitmapSegment projectileBitmapSegment{};
+	InputState input{};
 
 	MovementData getProjectileSpawnMovement();
 
 public:
+	/**
+	 * Applies the thrusters of a ship according to the input for the given time, changing its velocity and spin.
+	 */
+	static void applyThrusters(
+	    D2D_POINT_2F & velocity,
+	    float & spin,
+	    float rotation,
+	    const ThrusterData & thrusters,
+	    InputState input,
+	    unsigned int millis
+	);
+
+	/**
+	 * @param shot the number of the shot, starting from 1, which picks the gun it is fired from
+	 * @return the movement of a projectile fired by a ship, from alternating guns starting with the right one
+	 */
+	static MovementData projectileSpawnMovement(
+	    D2D_POINT_2F location, float rotation, float size, float gunOffset, unsigned long long shot
+	);
+
 	Spaceship(
 	    float size,
 	    MovementData movement,
@@ -37,7 +61,29 @@ public:
 	    BitmapSegment projectileBitmapSegment
 	);
 
-	void move(unsigned int millis, D2D_RECT_F modulo) override;
+	/**
+	 * Sets the keys steering the spaceship during the following moves.
+	 */
+	void setInput(InputState newInput);
+
+	/**
+	 * Applies the thrusters according to the input, then moves like any other object.
+	 */
+	void move(unsigned int millis, D2D_RECT_F modulo);
+
+	/**
+	 * @return the fired projectile, or nothing if the guns are cooling down
+	 */
+	std::optional<Projectile> shoot(unsigned long long timestamp);
+
+	/**
+	 * Writes the movement, hit points, guns and input of the spaceship, see Snapshot.h.
+	 */
+	void save(SnapshotWriter & writer) const;
 
-	std::unique_ptr<Projectile> shoot(unsigned long long timestamp);
+	/**
+	 * Reads back the state written by save.
+	 * @throws std::runtime_error if the snapshot is malformed
+	 */
+	void restore(SnapshotReader & reader);
 };
\ No newline at end of file
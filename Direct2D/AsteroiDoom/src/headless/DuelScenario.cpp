@@ -0,0 +1,193 @@
+#include "DuelScenario.h"
+
+#include "../Game.h"
+#include "../net/DatagramSocket.h"
+#include "../utils/Random.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+	// The second player's keys change while the first one's are held, so that predictions keep failing.
+	const unsigned long long RivalScriptOffset = 120;
+	// The sides give up after 10 seconds without confirming a step.
+	const unsigned long long MaxFramesWithoutProgress = 10'000 / SimulationStepMillis;
+
+	/**
+	 * One direction of the connection, holding datagrams back by the latency and dropping some of them before they
+	 * are sent through the socket.
+	 */
+	class EmulatedLink {
+		struct Pending {
+			double sendTime;
+			std::vector<uint8_t> datagram;
+		};
+
+		DatagramSocket & socket;
+		double latencyMillis{};
+		double jitterMillis{};
+		float lossFraction{};
+		Random random{};
+		std::vector<Pending> pending{};
+
+	public:
+		EmulatedLink(DatagramSocket & socket, const DuelSettings & settings, uint64_t seed) :
+		    socket(socket),
+		    latencyMillis(settings.latencyMillis),
+		    jitterMillis(settings.jitterMillis),
+		    lossFraction(float(settings.lossPercent / 100)),
+		    random(seed) {
+		}
+
+		void send(std::span<const uint8_t> datagram, double now) {
+			if (random.nextFloat() < lossFraction) {
+				return;
+			}
+			double delay = latencyMillis + jitterMillis * double(random.nextFloat());
+			pending.push_back({now + delay, std::vector<uint8_t>(datagram.begin(), datagram.end())});
+		}
+
+		/**
+		 * Sends the datagrams due by now, in the order they fall due, which jitter may make differ from the order
+		 * they were given in.
+		 */
+		void flush(double now) {
+			auto due = std::stable_partition(pending.begin(), pending.end(), [&](const Pending & datagram) {
+				return datagram.sendTime <= now;
+			});
+			std::stable_sort(pending.begin(), due, [](const Pending & a, const Pending & b) {
+				return a.sendTime < b.sendTime;
+			});
+			for (auto datagram = pending.begin(); datagram != due; datagram++) {
+				socket.send(datagram->datagram);
+			}
+			pending.erase(pending.begin(), due);
+		}
+	};
+} // namespace
+
+DuelResult runDuelScenario(const DuelSettings & settings, const InputScript & script) {
+	Game games[2]{Game(GameSprites{}, settings.seed), Game(GameSprites{}, settings.seed)};
+	for (Game & game : games) {
+		game.setDuel(true);
+		game.reset();
+		game.scatterAsteroids(settings.asteroids);
+	}
+	RollbackSession sessions[2]{
+	    RollbackSession(games[0], 0, SimulationStepMillis, settings.rollbackTicks),
+	    RollbackSession(games[1], 1, SimulationStepMillis, settings.rollbackTicks)};
+
+	DatagramSocket sockets[2];
+	sockets[0].connect(sockets[1].getPort());
+	sockets[1].connect(sockets[0].getPort());
+	// Every direction loses its own datagrams.
+	EmulatedLink links[2]{
+	    EmulatedLink(sockets[0], settings, settings.seed * 2 + 1),
+	    EmulatedLink(sockets[1], settings, settings.seed * 2 + 2)};
+
+	DuelResult result{};
+	std::vector<uint8_t> datagram{}, packet{};
+	unsigned long long confirmed = 0, framesWithoutProgress = 0;
+	for (double now = 0;; now += SimulationStepMillis) {
+		for (EmulatedLink & link : links) {
+			link.flush(now);
+		}
+		bool done = true;
+		for (unsigned int player = 0; player < 2; player++) {
+			RollbackSession & session = sessions[player];
+			while (sockets[player].receive(datagram)) {
+				session.receivePacket(datagram);
+			}
+			if (session.getTick() < settings.ticks) {
+				session.advance(script.at(session.getTick() + (player == 0 ? 0 : RivalScriptOffset)));
+			} else {
+				session.synchronize();
+			}
+			session.writePacket(packet);
+			links[player].send(packet, now);
+			done = done && session.getConfirmedTick() == settings.ticks && session.isAcknowledged();
+		}
+		result.frames++;
+		if (done) {
+			break;
+		}
+
+		unsigned long long progress = sessions[0].getConfirmedTick() + sessions[1].getConfirmedTick();
+		framesWithoutProgress = progress > confirmed ? 0 : framesWithoutProgress + 1;
+		confirmed = std::max(confirmed, progress);
+		if (framesWithoutProgress == MaxFramesWithoutProgress) {
+			throw std::runtime_error("The sides of the duel stopped hearing each other.");
+		}
+	}
+
+	std::vector<uint8_t> states[2]{};
+	for (unsigned int player = 0; player < 2; player++) {
+		result.stats[player] = sessions[player].getStats();
+		games[player].save(states[player]);
+	}
+	result.synchronized = states[0] == states[1];
+	result.hitPoints[0] = games[0].getSpaceship().getHitPoints();
+	result.hitPoints[1] = games[0].getRival()->getHitPoints();
+	return result;
+}
+
+void printDuelReport(const DuelSettings & settings, const DuelResult & result) {
+	std::printf(
+	    "duel: %llu ticks, latency %.0f ms + up to %.0f ms, %.1f%% lost, rollback depth %zu steps, %llu frames\n",
+	    settings.ticks,
+	    settings.latencyMillis,
+	    settings.jitterMillis,
+	    settings.lossPercent,
+	    settings.rollbackTicks,
+	    result.frames
+	);
+	std::printf(
+	    "%-8s %8s %10s %12s %8s %10s %10s %14s\n",
+	    "player",
+	    "stalls",
+	    "rollbacks",
+	    "resimulated",
+	    "deepest",
+	    "us/step",
+	    "us/resim",
+	    "resim steps/s"
+	);
+	double slowestResimulationMicros = 0;
+	for (unsigned int player = 0; player < 2; player++) {
+		const RollbackStats & stats = result.stats[player];
+		double stepMicros = stats.ticks ? stats.stepMillis * 1000 / double(stats.ticks) : 0;
+		double resimulationMicros =
+		    stats.resimulatedTicks ? stats.resimulationMillis * 1000 / double(stats.resimulatedTicks) : 0;
+		slowestResimulationMicros = std::max(slowestResimulationMicros, resimulationMicros);
+		std::printf(
+		    "%-8u %8llu %10llu %12llu %8zu %10.2f %10.2f %14.0f\n",
+		    player + 1,
+		    stats.stalls,
+		    stats.rollbacks,
+		    stats.resimulatedTicks,
+		    stats.deepestRollback,
+		    stepMicros,
+		    resimulationMicros,
+		    resimulationMicros > 0 ? 1'000'000 / resimulationMicros : 0
+		);
+	}
+	// A frame simulates the steps which fell due since the last one, and may roll back by the whole depth first.
+	double fullRollbackMillis = slowestResimulationMicros * double(settings.rollbackTicks) / 1000;
+	std::printf(
+	    "duel: a rollback by the whole depth takes %.2f ms, %.0f%% of a %.1f ms frame\n",
+	    fullRollbackMillis,
+	    fullRollbackMillis / FrameBudgetMillis * 100,
+	    FrameBudgetMillis
+	);
+	if (result.synchronized) {
+		std::printf(
+		    "duel: both sides ended in the same state, with %u and %u hit points left\n",
+		    result.hitPoints[0],
+		    result.hitPoints[1]
+		);
+	} else {
+		std::printf("duel: the sides ended in different states\n");
+	}
+}
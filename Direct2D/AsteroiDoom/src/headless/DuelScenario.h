@@ -0,0 +1,40 @@
+#pragma once
+
+#include "../net/RollbackSession.h"
+#include "../utils/AsteroiDoomConstants.h"
+#include "InputScript.h"
+
+#include <cstdint>
+
+struct DuelSettings {
+	unsigned long long ticks{};
+	uint64_t seed{};
+	// The delay of every datagram in either direction, plus a uniformly random part up to the jitter.
+	double latencyMillis{};
+	double jitterMillis{};
+	double lossPercent{};
+	size_t rollbackTicks{RollbackTicks};
+	// Scattered over the arena at the start, to make steps, and so rollbacks, more expensive.
+	size_t asteroids{};
+};
+
+struct DuelResult {
+	RollbackStats stats[2]{};
+	// The number of rounds in which both sides advanced, or tried to, each a step long.
+	unsigned long long frames{};
+	// Whether both sides ended up in exactly the same state.
+	bool synchronized{};
+	unsigned int hitPoints[2]{};
+};
+
+/**
+ * Plays a duel between two rollback sessions on one thread, talking through a pair of UDP sockets on the loopback
+ * interface, with the latency, jitter and loss of the settings injected before sending. The first player follows the
+ * script, the second one the same script 120 steps later.
+ *
+ * Both sides take turns, one step of time apart, until both simulated all ticks with all input received.
+ * @throws std::runtime_error if the sides stop hearing each other, e.g. with all datagrams lost
+ */
+DuelResult runDuelScenario(const DuelSettings & settings, const InputScript & script);
+
+void printDuelReport(const DuelSettings & settings, const DuelResult & result);
@@ -0,0 +1,338 @@
+#include "../Game.h"
+#include "../Hud.h"
+#include "../ai/ShipController.h"
+#include "../utils/AsteroiDoomConstants.h"
+#include "../utils/InputLog.h"
+#include "../utils/Profiler.h"
+#include "../utils/SoftwareRenderer.h"
+#include "DuelScenario.h"
+#include "InputScript.h"
+#include "PlaceholderSprites.h"
+#include "StressScenario.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Runs the simulation without a window, as fast as possible, and reports how fast it went.
+
+namespace {
+	using Clock = std::chrono::steady_clock;
+
+	// Swarm ships fire within 10 degrees of their target, and close in on it up to a third of their range.
+	const Pursuit SwarmPursuit{10, 150, 450};
+
+	struct Options {
+		uint64_t seed{1};
+		unsigned long long ticks{100'000};
+		unsigned int tickMillis{SimulationStepMillis};
+		const char * inputPath{nullptr};
+		const char * recordPath{nullptr};
+		const char * replayPath{nullptr};
+		size_t parallelThreshold{ParallelMoveThreshold};
+		size_t swarmSize{};
+		bool swarmHunts{};
+		bool pixelCollisions{};
+		const char * profilePath{nullptr};
+		const char * screenshotPath{nullptr};
+		std::vector<size_t> stressCounts{};
+		unsigned int stressFrames{300};
+		bool duel{};
+		DuelSettings duelSettings{};
+	};
+
+	void printUsage(const char * program) {
+		std::fprintf(
+		    stderr,
+		    "Usage: %s [--seed N] [--ticks N] [--tick-millis N] [--input SCRIPT] [--record LOG] [--parallel-threshold N]\n"
+		    "          [--swarm N] [--swarm-behaviour dogfight|hunt] [--narrowphase circle|pixel] [--profile CSV]\n"
+		    "          [--screenshot TGA]\n"
+		    "       %s --replay LOG [--record LOG] [--parallel-threshold N] [--swarm N] [--swarm-behaviour ...]\n"
+		    "          [--narrowphase ...]\n"
+		    "       %s --stress N[,N...] [--frames N] [--seed N] [--input SCRIPT] [--parallel-threshold N]\n"
+		    "       %s --duel LATENCY_MS [--jitter MS] [--loss PERCENT] [--rollback-depth STEPS] [--asteroids N]\n"
+		    "          [--seed N] [--ticks N] [--input SCRIPT]\n"
+		    "Simulates AsteroiDoom for the given number of ticks, steered by the input script,\n"
+		    "or replays a recorded input log, taking the seed, ticks and tick length from it.\n"
+		    "With --swarm, every game also has the given number of ships, which fight each other,\n"
+		    "or all hunt the player's spaceship.\n"
+		    "With --narrowphase pixel, objects only collide where the pixels of their placeholder sprites touch.\n"
+		    "With --profile, writes the phase times of the last ticks to a CSV file.\n"
+		    "With --screenshot, renders the last tick on the CPU, with placeholder sprites, to a TGA image.\n"
+		    "With --stress, runs frames of games started with each number of asteroids and reports frame times.\n"
+		    "With --duel, plays two rollback sessions against each other over loopback UDP with the given latency,\n"
+		    "and reports how many steps they re-simulated and how fast.\n",
+		    program,
+		    program,
+		    program,
+		    program
+		);
+	}
+
+	bool parseOptions(int argc, char ** argv, Options & options) {
+		for (int i = 1; i < argc; i++) {
+			std::string_view option = argv[i];
+			if (i + 1 == argc) {
+				return false;
+			}
+			const char * value = argv[++i];
+			if (option == "--seed") {
+				options.seed = std::stoull(value);
+			} else if (option == "--ticks") {
+				options.ticks = std::stoull(value);
+			} else if (option == "--tick-millis") {
+				options.tickMillis = (unsigned int)std::stoul(value);
+			} else if (option == "--input") {
+				options.inputPath = value;
+			} else if (option == "--record") {
+				options.recordPath = value;
+			} else if (option == "--replay") {
+				options.replayPath = value;
+			} else if (option == "--parallel-threshold") {
+				options.parallelThreshold = std::stoull(value);
+			} else if (option == "--stress") {
+				std::string_view counts = value;
+				while (!counts.empty()) {
+					size_t comma = std::min(counts.find(','), counts.size());
+					options.stressCounts.push_back(std::stoull(std::string(counts.substr(0, comma))));
+					counts.remove_prefix(std::min(comma + 1, counts.size()));
+				}
+			} else if (option == "--profile") {
+				options.profilePath = value;
+			} else if (option == "--screenshot") {
+				options.screenshotPath = value;
+			} else if (option == "--duel") {
+				options.duel = true;
+				options.duelSettings.latencyMillis = std::stod(value);
+			} else if (option == "--jitter") {
+				options.duelSettings.jitterMillis = std::stod(value);
+			} else if (option == "--loss") {
+				options.duelSettings.lossPercent = std::stod(value);
+			} else if (option == "--rollback-depth") {
+				options.duelSettings.rollbackTicks = std::stoull(value);
+			} else if (option == "--asteroids") {
+				options.duelSettings.asteroids = std::stoull(value);
+			} else if (option == "--frames") {
+				options.stressFrames = (unsigned int)std::stoul(value);
+			} else if (option == "--swarm") {
+				options.swarmSize = std::stoull(value);
+			} else if (option == "--swarm-behaviour") {
+				if (std::string_view(value) != "dogfight" && std::string_view(value) != "hunt") {
+					return false;
+				}
+				options.swarmHunts = std::string_view(value) == "hunt";
+			} else if (option == "--narrowphase") {
+				if (std::string_view(value) != "circle" && std::string_view(value) != "pixel") {
+					return false;
+				}
+				options.pixelCollisions = std::string_view(value) == "pixel";
+			} else {
+				return false;
+			}
+		}
+		bool stressing = !options.stressCounts.empty();
+		if (stressing &&
+		    (options.replayPath || options.recordPath || options.stressFrames == 0 || options.pixelCollisions)) {
+			return false;
+		}
+		if (options.duel && (stressing || options.replayPath || options.recordPath || options.swarmSize > 0 ||
+		                     options.profilePath || options.screenshotPath || options.pixelCollisions ||
+		                     options.duelSettings.rollbackTicks == 0)) {
+			return false;
+		}
+		return !(options.replayPath && options.inputPath);
+	}
+
+	double millisSince(Clock::time_point start) {
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	/**
+	 * Renders the game as the window would show it, over a black background.
+	 */
+	PixelBuffer renderFrame(const Game & game, const PlaceholderSprites & sprites) {
+		PixelBuffer frame((unsigned int)ArenaWidth, (unsigned int)ArenaHeight);
+		frame.fill(0xFF000000);
+		SoftwareRenderer renderer{};
+		SoftwareDrawBackend backend(renderer, {ArenaWidth / 2, ArenaHeight / 2});
+		sprites.attachTo(backend);
+		game.draw(backend);
+		renderer.render(frame);
+		return frame;
+	}
+} // namespace
+
+int main(int argc, char ** argv) {
+	Options options{};
+	InputScript script{};
+	InputLog replay{};
+	try {
+		if (!parseOptions(argc, argv, options)) {
+			printUsage(argv[0]);
+			return 1;
+		}
+		if (options.replayPath) {
+			std::ifstream file(options.replayPath, std::ios::binary);
+			if (!file) {
+				std::fprintf(stderr, "Failed to open input log '%s'.\n", options.replayPath);
+				return 1;
+			}
+			replay = InputLog(file);
+			options.seed = replay.getSeed();
+			options.ticks = replay.getTickCount();
+			options.tickMillis = replay.getStepMillis();
+		} else if (options.inputPath) {
+			std::ifstream file(options.inputPath);
+			if (!file) {
+				std::fprintf(stderr, "Failed to open input script '%s'.\n", options.inputPath);
+				return 1;
+			}
+			script = InputScript(file);
+		} else {
+			script = InputScript::makeDefault();
+		}
+	} catch (std::exception & e) {
+		std::fprintf(stderr, "%s\n", e.what());
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	if (!options.stressCounts.empty()) {
+		std::vector<StressResult> results{};
+		for (size_t asteroids : options.stressCounts) {
+			results.push_back(
+			    runStressScenario(asteroids, options.stressFrames, script, options.seed, options.parallelThreshold)
+			);
+		}
+		printStressReport(results, options.stressFrames);
+		return 0;
+	}
+
+	if (options.duel) {
+		options.duelSettings.ticks = options.ticks;
+		options.duelSettings.seed = options.seed;
+		DuelResult result{};
+		try {
+			result = runDuelScenario(options.duelSettings, script);
+		} catch (std::exception & e) {
+			std::fprintf(stderr, "%s\n", e.what());
+			return 1;
+		}
+		printDuelReport(options.duelSettings, result);
+		return result.synchronized ? 0 : 1;
+	}
+
+	PlaceholderSprites sprites{};
+	Game game(sprites.getGameSprites(), options.seed);
+	game.setParallelMoveThreshold(options.parallelThreshold);
+	if (options.pixelCollisions) {
+		game.setCollisionMasks(sprites.makeCollisionMasks());
+	}
+	if (options.swarmSize > 0) {
+		std::shared_ptr<const ShipController> controller{};
+		if (options.swarmHunts) {
+			controller = std::make_shared<HunterController>(SwarmPursuit);
+		} else {
+			controller = std::make_shared<DogfightController>(SwarmPursuit);
+		}
+		game.setSwarm(options.swarmSize, controller);
+		game.reset();
+	}
+	InputLog record(options.seed, options.tickMillis);
+	// Updated every tick as if every tick were drawn, to count how often the HUD text would be laid out.
+	Hud hud{};
+
+	// Every tick is a frame of the profiler, which is always compiled into the headless runner.
+	Profiler profiler{};
+	unsigned long long gamesOver = 0, totalScore = 0;
+
+	auto start = Clock::now();
+	for (unsigned long long tick = 0; tick < options.ticks; tick++) {
+		InputState input = options.replayPath ? replay.at(tick) : script.at(tick);
+		record.record(input);
+
+		{
+			ScopedTimer timer(profiler, ProfilePhase::Move);
+			game.move(options.tickMillis, input);
+		}
+		{
+			ScopedTimer timer(profiler, ProfilePhase::Spawn);
+			game.spawn(input);
+		}
+		{
+			ScopedTimer timer(profiler, ProfilePhase::Collisions);
+			game.checkCollisions();
+		}
+		profiler.addCollisionPairs(game.getArena().getCollisionPairCount());
+		profiler.endFrame();
+
+		hud.update(game);
+		if (game.isOver()) {
+			gamesOver++;
+			totalScore += game.getScore();
+			game.reset();
+		}
+	}
+	double totalMillis = millisSince(start);
+
+	if (options.recordPath) {
+		std::ofstream file(options.recordPath, std::ios::binary);
+		record.write(file);
+		if (!file) {
+			std::fprintf(stderr, "Failed to write input log '%s'.\n", options.recordPath);
+			return 1;
+		}
+	}
+	if (options.profilePath) {
+		std::ofstream file(options.profilePath);
+		profiler.writeCsv(file);
+		if (!file) {
+			std::fprintf(stderr, "Failed to write profile '%s'.\n", options.profilePath);
+			return 1;
+		}
+	}
+	if (options.screenshotPath) {
+		std::ofstream file(options.screenshotPath, std::ios::binary);
+		renderFrame(game, sprites).writeTga(file);
+		if (!file) {
+			std::fprintf(stderr, "Failed to write screenshot '%s'.\n", options.screenshotPath);
+			return 1;
+		}
+	}
+
+	std::printf(
+	    "seed %llu: %llu ticks of %u ms in %.1f ms, %.0f ticks/s\n",
+	    (unsigned long long)options.seed,
+	    options.ticks,
+	    options.tickMillis,
+	    totalMillis,
+	    double(options.ticks) / totalMillis * 1000
+	);
+	std::printf("%-12s %12s %12s\n", "phase", "total ms", "us/tick");
+	for (auto phase : {ProfilePhase::Move, ProfilePhase::Spawn, ProfilePhase::Collisions}) {
+		double millis = profiler.getTotals().phaseMillis[size_t(phase)];
+		std::printf("%-12s %12.1f %12.3f\n", Profiler::nameOf(phase), millis, millis / double(options.ticks) * 1000);
+	}
+	std::printf(
+	    "games over: %llu, total score: %llu, asteroids: %zu, projectiles: %zu (at most %zu at once)\n",
+	    gamesOver,
+	    totalScore + game.getScore(),
+	    game.getArena().getAsteroidCount(),
+	    game.getArena().getProjectileCount(),
+	    game.getArena().getProjectileHighWaterMark()
+	);
+	if (options.swarmSize > 0) {
+		std::printf("swarm: %zu of %zu ships left\n", game.getArena().getSwarm().size(), options.swarmSize);
+	}
+	std::printf(
+	    "collisions: %zu pairs detected over %llu ticks\n", profiler.getTotals().collisionPairs, options.ticks
+	);
+	std::printf("hud: %llu texts formatted over %llu ticks\n", hud.getFormatCount(), options.ticks);
+	return 0;
+}
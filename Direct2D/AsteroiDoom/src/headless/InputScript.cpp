@@ -0,0 +1,80 @@
+#include "InputScript.h"
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+	Key parseKey(const std::string & name) {
+		if (name == "W")
+			return Key::Thrust;
+		if (name == "S")
+			return Key::Reverse;
+		if (name == "D")
+			return Key::TurnRight;
+		if (name == "A")
+			return Key::TurnLeft;
+		if (name == "SHIFT")
+			return Key::Boost;
+		if (name == "SPACE")
+			return Key::Shoot;
+		throw std::runtime_error("Unknown key '" + name + "' in input script.");
+	}
+} // namespace
+
+InputScript::InputScript() = default;
+
+InputScript::InputScript(std::istream & script) {
+	std::string line;
+	while (std::getline(script, line)) {
+		std::istringstream words(line);
+		std::string first;
+		if (!(words >> first) || first[0] == '#') {
+			continue;
+		}
+
+		if (first == "loop") {
+			if (!(words >> period) || period == 0) {
+				throw std::runtime_error("Invalid loop period in input script.");
+			}
+			continue;
+		}
+
+		Entry entry{};
+		try {
+			entry.tick = std::stoull(first);
+		} catch (std::exception &) {
+			throw std::runtime_error("Invalid tick '" + first + "' in input script.");
+		}
+		std::string key;
+		while (words >> key) {
+			entry.input.press(parseKey(key));
+		}
+		entries.push_back(entry);
+	}
+
+	std::stable_sort(entries.begin(), entries.end(), [](const Entry & a, const Entry & b) {
+		return a.tick < b.tick;
+	});
+}
+
+InputScript InputScript::makeDefault() {
+	std::istringstream script("0 D SPACE\n"
+	                          "60 W SPACE\n"
+	                          "90 A SPACE\n"
+	                          "150 S SHIFT SPACE\n"
+	                          "210 W D\n"
+	                          "loop 240\n");
+	return InputScript(script);
+}
+
+InputState InputScript::at(unsigned long long tick) const {
+	if (period) {
+		tick %= period;
+	}
+	auto next = std::upper_bound(entries.begin(), entries.end(), tick, [](unsigned long long t, const Entry & entry) {
+		return t < entry.tick;
+	});
+	return next == entries.begin() ? InputState() : std::prev(next)->input;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "../utils/Input.h"
+
+#include <istream>
+#include <vector>
+
+/**
+ * Scripted keyboard input for headless runs.
+ *
+ * Every line of a script reads "<tick> [keys...]" and holds the listed keys from that tick on, where a key is one of
+ * W, S, D, A, SHIFT and SPACE. A line "loop <ticks>" repeats the whole script with the given period.
+ * Empty lines and lines starting with '#' are ignored.
+ */
+class InputScript {
+	struct Entry {
+		unsigned long long tick;
+		InputState input;
+	};
+
+	// Sorted by tick.
+	std::vector<Entry> entries{};
+	unsigned long long period{};
+
+public:
+	InputScript();
+
+	/**
+	 * @throws std::runtime_error if the script is malformed
+	 */
+	explicit InputScript(std::istream & script);
+
+	/**
+	 * A script circling, thrusting and firing, which keeps all parts of the simulation busy.
+	 */
+	static InputScript makeDefault();
+
+	[[nodiscard]] InputState at(unsigned long long tick) const;
+};
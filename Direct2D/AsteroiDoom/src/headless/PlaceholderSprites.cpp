@@ -0,0 +1,83 @@
+#include "PlaceholderSprites.h"
+
+#include <cmath>
+
+namespace {
+	// Samples per pixel along each axis, for antialiased edges.
+	const int Subsamples = 4;
+
+	/**
+	 * Draws a shape of the given colour, covering the points of the square [-size / 2, size / 2]^2 for which
+	 * inside(x, y) holds.
+	 */
+	template <typename Shape>
+	PixelBuffer rasterizeShape(unsigned int size, uint32_t colour, Shape && inside) {
+		PixelBuffer pixels(size, size);
+		float half = float(size) / 2;
+		for (unsigned int y = 0; y < size; y++) {
+			for (unsigned int x = 0; x < size; x++) {
+				int covered = 0;
+				for (int sample = 0; sample < Subsamples * Subsamples; sample++) {
+					float sampleX = float(x) + (float(sample % Subsamples) + 0.5f) / Subsamples - half;
+					float sampleY = float(y) + (float(sample / Subsamples) + 0.5f) / Subsamples - half;
+					covered += inside(sampleX, sampleY);
+				}
+				// Premultiply every channel, including alpha, by the coverage.
+				uint32_t pixel = 0;
+				for (int channel = 0; channel < 4; channel++) {
+					uint32_t value = (colour >> (8 * channel)) & 0xFF;
+					pixel |= (value * uint32_t(covered) / (Subsamples * Subsamples)) << (8 * channel);
+				}
+				pixels.row(y)[x] = pixel;
+			}
+		}
+		return pixels;
+	}
+
+	PixelBuffer asteroid(unsigned int size) {
+		float radius = float(size) / 2;
+		return rasterizeShape(size, 0xFF8C7B6B, [&](float x, float y) {
+			// Lumps show which way the asteroid is turned.
+			float angle = std::atan2(y, x);
+			return std::hypot(x, y) <= radius * (0.85f + 0.1f * std::sin(5 * angle) + 0.05f * std::cos(3 * angle));
+		});
+	}
+} // namespace
+
+PlaceholderSprites::PlaceholderSprites() {
+	spaceshipPixels = rasterizeShape(60, 0xFF66CCFF, [](float x, float y) {
+		// The nose is at the top, where the spaceship shoots.
+		return y <= 25 && std::abs(x) * 2.5f <= y + 25;
+	});
+	projectilePixels = rasterizeShape(10, 0xFFFFE040, [](float x, float y) {
+		return std::hypot(x, y) <= 4;
+	});
+	asteroidPixels[0] = asteroid(40);
+	asteroidPixels[1] = asteroid(60);
+}
+
+GameSprites PlaceholderSprites::getGameSprites() {
+	return {
+	    {&spaceshipBitmap, {0, 0, 60, 60}},
+	    {&projectileBitmap, {0, 0, 10, 10}},
+	    {{&asteroidBitmaps[0], {0, 0, 40, 40}}, {&asteroidBitmaps[1], {0, 0, 60, 60}}}};
+}
+
+void PlaceholderSprites::attachTo(SoftwareDrawBackend & backend) const {
+	backend.setPixels(&spaceshipBitmap, &spaceshipPixels);
+	backend.setPixels(&projectileBitmap, &projectilePixels);
+	for (int type = 0; type < 2; type++) {
+		backend.setPixels(&asteroidBitmaps[type], &asteroidPixels[type]);
+	}
+}
+
+std::shared_ptr<const CollisionMaskSet> PlaceholderSprites::makeCollisionMasks() {
+	GameSprites sprites = getGameSprites();
+	auto masks = std::make_shared<CollisionMaskSet>();
+	masks->add(sprites.spaceship, spaceshipPixels);
+	masks->add(sprites.projectile, projectilePixels);
+	for (int type = 0; type < 2; type++) {
+		masks->add(sprites.asteroids[type], asteroidPixels[type]);
+	}
+	return masks;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "../Game.h"
+#include "../collidable/CollisionMask.h"
+#include "../utils/DrawBackend.h"
+#include "../utils/SoftwareRenderer.h"
+
+/**
+ * Sprites of the sizes the game draws, made of simple shapes, since headless builds cannot decode the PNG assets.
+ * The spaceship is a triangle pointing up, the asteroids lumpy discs and the projectile a dot.
+ */
+class PlaceholderSprites {
+	// Only identities for the segments, see BitmapHelper, so the sprites must not move.
+	BitmapHelper spaceshipBitmap{};
+	BitmapHelper projectileBitmap{};
+	BitmapHelper asteroidBitmaps[2]{};
+
+	PixelBuffer spaceshipPixels{};
+	PixelBuffer projectilePixels{};
+	PixelBuffer asteroidPixels[2]{};
+
+public:
+	PlaceholderSprites();
+
+	PlaceholderSprites(const PlaceholderSprites &) = delete;
+
+	PlaceholderSprites & operator=(const PlaceholderSprites &) = delete;
+
+	[[nodiscard]] GameSprites getGameSprites();
+
+	/**
+	 * Makes the backend draw the sprites of getGameSprites.
+	 */
+	void attachTo(SoftwareDrawBackend & backend) const;
+
+	/**
+	 * @return the collision masks of the sprites of getGameSprites, which must outlive them
+	 */
+	[[nodiscard]] std::shared_ptr<const CollisionMaskSet> makeCollisionMasks();
+};
@@ -0,0 +1,122 @@
+#include "StressScenario.h"
+
+#include "../utils/AsteroiDoomConstants.h"
+#include "../utils/DrawBackend.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+	using Clock = std::chrono::steady_clock;
+
+	double millisSince(Clock::time_point start) {
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	void printPercentiles(const Percentiles & percentiles) {
+		std::printf(" %8.2f %8.2f %8.2f", percentiles.p50, percentiles.p99, percentiles.max);
+	}
+} // namespace
+
+Percentiles Percentiles::of(std::vector<double> millis) {
+	std::sort(millis.begin(), millis.end());
+	auto rank = [&](double fraction) {
+		auto index = size_t(std::ceil(fraction * double(millis.size())));
+		return millis[index == 0 ? 0 : index - 1];
+	};
+	return {rank(0.5), rank(0.99), millis.back()};
+}
+
+StressResult runStressScenario(
+    size_t asteroids, unsigned int frames, const InputScript & script, uint64_t seed, size_t parallelThreshold
+) {
+	Game game(GameSprites{}, seed);
+	game.setParallelMoveThreshold(parallelThreshold);
+	game.scatterAsteroids(asteroids);
+	DrawCommandList commands{};
+	CountingDrawBackend backend{};
+
+	std::vector<double> moveMillis, collisionMillis, drawMillis, submitMillis, frameMillis;
+	for (auto * series : {&moveMillis, &collisionMillis, &drawMillis, &submitMillis, &frameMillis}) {
+		series->reserve(frames);
+	}
+
+	unsigned long long tick = 0;
+	double accumulatedMillis = 0;
+	for (unsigned int frame = 0; frame < frames; frame++) {
+		double move = 0, collisions = 0;
+		auto frameStart = Clock::now();
+		// Steps fall due like in the window, four or five of them per frame.
+		for (accumulatedMillis += FrameBudgetMillis; accumulatedMillis >= SimulationStepMillis;
+		     accumulatedMillis -= SimulationStepMillis) {
+			InputState input = script.at(tick++);
+			auto phaseStart = Clock::now();
+			game.move(SimulationStepMillis, input);
+			game.spawn(input);
+			move += millisSince(phaseStart);
+
+			phaseStart = Clock::now();
+			game.checkCollisions();
+			collisions += millisSince(phaseStart);
+		}
+
+		auto drawStart = Clock::now();
+		commands.clear();
+		game.draw(commands, float(accumulatedMillis / SimulationStepMillis));
+		commands.sortByBitmap();
+		drawMillis.push_back(millisSince(drawStart));
+
+		auto submitStart = Clock::now();
+		commands.replay(backend);
+		submitMillis.push_back(millisSince(submitStart));
+
+		moveMillis.push_back(move);
+		collisionMillis.push_back(collisions);
+		frameMillis.push_back(millisSince(frameStart));
+	}
+
+	return {
+	    asteroids,
+	    Percentiles::of(moveMillis),
+	    Percentiles::of(collisionMillis),
+	    Percentiles::of(drawMillis),
+	    Percentiles::of(submitMillis),
+	    Percentiles::of(frameMillis),
+	    double(backend.getDrawCount()) / frames};
+}
+
+void printStressReport(const std::vector<StressResult> & results, unsigned int frames) {
+	std::printf(
+	    "stress: %u frames per count, budget %.1f ms per frame, p50, p99 and max of each phase in ms, "
+	    "sprites drawn per frame\n",
+	    frames,
+	    FrameBudgetMillis
+	);
+	std::printf("%-10s", "asteroids");
+	for (const char * phase : {"move", "collide", "draw", "submit", "frame"}) {
+		std::printf(" %8s %8s %8s", phase, "p99", "max");
+	}
+	std::printf(" %8s\n", "sprites");
+
+	const StressResult * largestWithinBudget = nullptr;
+	for (const auto & result : results) {
+		std::printf("%-10zu", result.asteroids);
+		for (const auto * percentiles :
+		     {&result.move, &result.collisions, &result.draw, &result.submit, &result.frame}) {
+			printPercentiles(*percentiles);
+		}
+		std::printf(" %8.0f\n", result.drawCommandsPerFrame);
+		if (result.frame.p99 <= FrameBudgetMillis &&
+		    (!largestWithinBudget || result.asteroids > largestWithinBudget->asteroids)) {
+			largestWithinBudget = &result;
+		}
+	}
+
+	if (largestWithinBudget) {
+		std::printf("largest count within budget at p99: %zu\n", largestWithinBudget->asteroids);
+	} else {
+		std::printf("largest count within budget at p99: none\n");
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "../Game.h"
+#include "../utils/AsteroiDoomConstants.h"
+#include "InputScript.h"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * The median, the 99th percentile and the maximum of a series of durations, in milliseconds.
+ */
+struct Percentiles {
+	double p50{};
+	double p99{};
+	double max{};
+
+	/**
+	 * Takes nearest-rank percentiles of the durations, which must not be empty.
+	 */
+	static Percentiles of(std::vector<double> millis);
+};
+
+struct StressResult {
+	size_t asteroids{};
+	// The move phase includes spawning, which is negligible next to it.
+	Percentiles move{};
+	Percentiles collisions{};
+	// Recording the sprites and sorting them by bitmap, then replaying them.
+	Percentiles draw{};
+	Percentiles submit{};
+	Percentiles frame{};
+	double drawCommandsPerFrame{};
+};
+
+/**
+ * Starts a game with the given number of asteroids scattered all over the arena and runs frames of it as the window
+ * would, simulating the steps which fit in a 60 Hz frame and then drawing once, timing every phase of every frame.
+ *
+ * The game is not reset when the spaceship is destroyed, so that the density stays up. Drawing records a
+ * DrawCommandList as the window does, then replays it to a counting backend, so it measures the interpolation,
+ * culling and sorting done on the CPU, but not rasterization.
+ */
+StressResult runStressScenario(
+    size_t asteroids, unsigned int frames, const InputScript & script, uint64_t seed, size_t parallelThreshold
+);
+
+/**
+ * Prints a table of the results, followed by the largest asteroid count whose 99th percentile frame fits the budget.
+ */
+void printStressReport(const std::vector<StressResult> & results, unsigned int frames);
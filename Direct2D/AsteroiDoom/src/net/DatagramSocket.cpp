@@ -0,0 +1,166 @@
+#include "DatagramSocket.h"
+
+#include <stdexcept>
+#include <string>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+	// Larger than any packet of the game, and than the payload of an Ethernet frame.
+	const size_t MaxDatagramBytes = 2048;
+
+#if defined(_WIN32)
+	using Length = int;
+
+	const uintptr_t InvalidHandle = INVALID_SOCKET;
+
+	int lastError() {
+		return WSAGetLastError();
+	}
+
+	/**
+	 * @return whether the error only means that nothing could be sent or received right now
+	 */
+	bool isTransient(int error) {
+		// A datagram sent to a port nobody listens on resets the socket on Windows.
+		return error == WSAEWOULDBLOCK || error == WSAECONNRESET;
+	}
+
+	void startSockets() {
+		static const bool started = [] {
+			WSADATA data{};
+			if (WSAStartup(MAKEWORD(2, 2), &data) != 0) {
+				throw std::runtime_error("Failed to start Winsock.");
+			}
+			return true;
+		}();
+		(void)started;
+	}
+
+	void closeHandle(uintptr_t handle) {
+		closesocket(SOCKET(handle));
+	}
+
+	void makeNonBlocking(uintptr_t handle) {
+		u_long nonBlocking = 1;
+		if (ioctlsocket(SOCKET(handle), FIONBIO, &nonBlocking) != 0) {
+			throw std::runtime_error("Failed to make a socket non-blocking.");
+		}
+	}
+#else
+	using Length = socklen_t;
+
+	const int InvalidHandle = -1;
+
+	int lastError() {
+		return errno;
+	}
+
+	/**
+	 * @return whether the error only means that nothing could be sent or received right now
+	 */
+	bool isTransient(int error) {
+		// A datagram sent to a port nobody listens on is refused with the next call.
+		return error == EAGAIN || error == EWOULDBLOCK || error == ECONNREFUSED;
+	}
+
+	void startSockets() {
+	}
+
+	void closeHandle(int handle) {
+		close(handle);
+	}
+
+	void makeNonBlocking(int handle) {
+		int flags = fcntl(handle, F_GETFL, 0);
+		if (flags == -1 || fcntl(handle, F_SETFL, flags | O_NONBLOCK) == -1) {
+			throw std::runtime_error("Failed to make a socket non-blocking.");
+		}
+	}
+#endif
+
+	sockaddr_in loopback(uint16_t port) {
+		sockaddr_in address{};
+		address.sin_family = AF_INET;
+		address.sin_port = htons(port);
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		return address;
+	}
+
+	std::runtime_error socketError(const char * what) {
+		return std::runtime_error(std::string(what) + " (error " + std::to_string(lastError()) + ").");
+	}
+} // namespace
+
+DatagramSocket::DatagramSocket(uint16_t port) {
+	startSockets();
+	handle = Handle(socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP));
+	if (handle == InvalidHandle) {
+		throw socketError("Failed to open a socket");
+	}
+	sockaddr_in address = loopback(port);
+	if (bind(handle, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) {
+		auto error = socketError("Failed to bind a socket");
+		closeHandle(handle);
+		throw error;
+	}
+	try {
+		makeNonBlocking(handle);
+	} catch (...) {
+		closeHandle(handle);
+		throw;
+	}
+}
+
+DatagramSocket::~DatagramSocket() {
+	closeHandle(handle);
+}
+
+uint16_t DatagramSocket::getPort() const {
+	sockaddr_in address{};
+	auto length = Length(sizeof(address));
+	if (getsockname(handle, reinterpret_cast<sockaddr *>(&address), &length) != 0) {
+		return 0;
+	}
+	return ntohs(address.sin_port);
+}
+
+void DatagramSocket::connect(uint16_t port) {
+	sockaddr_in address = loopback(port);
+	if (::connect(handle, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) {
+		throw socketError("Failed to connect a socket");
+	}
+}
+
+void DatagramSocket::send(std::span<const uint8_t> datagram) {
+	auto data = reinterpret_cast<const char *>(datagram.data());
+	if (::send(handle, data, Length(datagram.size()), 0) < 0 && !isTransient(lastError())) {
+		throw socketError("Failed to send a datagram");
+	}
+}
+
+bool DatagramSocket::receive(std::vector<uint8_t> & datagram) {
+	datagram.resize(MaxDatagramBytes);
+	auto received = recv(handle, reinterpret_cast<char *>(datagram.data()), Length(datagram.size()), 0);
+	if (received < 0) {
+		datagram.clear();
+		if (isTransient(lastError())) {
+			return false;
+		}
+		throw socketError("Failed to receive a datagram");
+	}
+	datagram.resize(size_t(received));
+	return true;
+}
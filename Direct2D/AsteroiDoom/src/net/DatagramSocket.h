@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * A non-blocking UDP socket on the loopback interface, e.g. for both sides of a duel played on one machine.
+ */
+class DatagramSocket {
+#if defined(_WIN32)
+	using Handle = uintptr_t;
+#else
+	using Handle = int;
+#endif
+
+	Handle handle{};
+
+public:
+	/**
+	 * Binds a socket to the given port of 127.0.0.1.
+	 * @param port the port, or 0 for any free one
+	 * @throws std::runtime_error if the socket cannot be opened or bound
+	 */
+	explicit DatagramSocket(uint16_t port = 0);
+
+	~DatagramSocket();
+
+	DatagramSocket(const DatagramSocket &) = delete;
+
+	DatagramSocket & operator=(const DatagramSocket &) = delete;
+
+	/**
+	 * @return the port the socket is bound to
+	 */
+	[[nodiscard]] uint16_t getPort() const;
+
+	/**
+	 * Sends to and receives from only the given port of 127.0.0.1 from now on.
+	 * @throws std::runtime_error if the socket cannot be connected
+	 */
+	void connect(uint16_t port);
+
+	/**
+	 * Sends a datagram, which may be lost like any other. Datagrams nobody listens to yet are dropped.
+	 * @throws std::runtime_error on errors other than the datagram being dropped
+	 */
+	void send(std::span<const uint8_t> datagram);
+
+	/**
+	 * Takes the next datagram received, reusing the memory of the bytes.
+	 * @return false if no datagram is waiting
+	 * @throws std::runtime_error on errors other than no datagram waiting
+	 */
+	bool receive(std::vector<uint8_t> & datagram);
+};
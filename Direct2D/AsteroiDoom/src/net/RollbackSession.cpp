@@ -0,0 +1,141 @@
+#include "RollbackSession.h"
+
+#include "../utils/Snapshot.h"
+
+#include <chrono>
+#include <stdexcept>
+
+namespace {
+	using Clock = std::chrono::steady_clock;
+
+	// Keeps packets well below the size of a datagram, even if the remote side stops acknowledging for a while.
+	const size_t MaxInputsPerPacket = 256;
+
+	double millisSince(Clock::time_point start) {
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+} // namespace
+
+RollbackSession::RollbackSession(Game & game, unsigned int player, unsigned int stepMillis, size_t rollbackTicks) :
+    game(game),
+    player(player),
+    stepMillis(stepMillis),
+    snapshots(rollbackTicks),
+    simulatedRemoteInputs(rollbackTicks) {
+	if (player > 1) {
+		throw std::runtime_error("A duel only has players 0 and 1.");
+	}
+	if (rollbackTicks == 0) {
+		throw std::runtime_error("The rollback depth must be at least a step.");
+	}
+}
+
+InputState RollbackSession::remoteInputAt(unsigned long long step) const {
+	if (step < remoteInputs.size()) {
+		return remoteInputs[step];
+	}
+	return remoteInputs.empty() ? InputState() : remoteInputs.back();
+}
+
+void RollbackSession::simulate() {
+	size_t slot = tick % snapshots.size();
+	game.save(snapshots[slot]);
+	InputState local = localInputs[tick], remote = remoteInputAt(tick);
+	simulatedRemoteInputs[slot] = remote;
+	if (player == 0) {
+		game.step(stepMillis, local, remote);
+	} else {
+		game.step(stepMillis, remote, local);
+	}
+	tick++;
+}
+
+bool RollbackSession::advance(InputState input) {
+	synchronize();
+	if (tick >= remoteInputs.size() + snapshots.size()) {
+		stats.stalls++;
+		return false;
+	}
+	auto start = Clock::now();
+	localInputs.push_back(input);
+	simulate();
+	stats.ticks++;
+	stats.stepMillis += millisSince(start);
+	return true;
+}
+
+void RollbackSession::synchronize() {
+	if (!rollbackPending) {
+		return;
+	}
+	rollbackPending = false;
+	auto start = Clock::now();
+	unsigned long long end = tick;
+	game.restore(snapshots[rollbackTick % snapshots.size()]);
+	for (tick = rollbackTick; tick < end;) {
+		simulate();
+	}
+	auto depth = size_t(end - rollbackTick);
+	stats.rollbacks++;
+	stats.resimulatedTicks += depth;
+	stats.deepestRollback = depth > stats.deepestRollback ? depth : stats.deepestRollback;
+	stats.resimulationMillis += millisSince(start);
+}
+
+void RollbackSession::writePacket(std::vector<uint8_t> & packet) const {
+	SnapshotWriter writer(packet);
+	size_t unacknowledged = localInputs.size() - size_t(acknowledged);
+	size_t count = unacknowledged < MaxInputsPerPacket ? unacknowledged : MaxInputsPerPacket;
+	// The inputs from the first one not acknowledged on, then how many remote inputs were received.
+	writer.write(uint64_t(acknowledged));
+	writer.writeAll(std::span<const InputState>(localInputs).subspan(size_t(acknowledged), count));
+	writer.write(uint64_t(remoteInputs.size()));
+}
+
+void RollbackSession::receivePacket(std::span<const uint8_t> packet) {
+	SnapshotReader reader(packet);
+	uint64_t firstTick{}, received{};
+	reader.read(firstTick);
+	reader.readAll(packetInputs);
+	reader.read(received);
+	if (!reader.atEnd() || received > localInputs.size()) {
+		throw std::runtime_error("Malformed duel packet.");
+	}
+	stats.packetsReceived++;
+	acknowledged = received > acknowledged ? received : acknowledged;
+
+	for (size_t index = 0; index < packetInputs.size(); index++) {
+		uint64_t step = firstTick + index;
+		if (step < remoteInputs.size()) {
+			continue;
+		}
+		if (step > remoteInputs.size()) {
+			// An earlier packet was lost or is late, and the following ones repeat these inputs.
+			break;
+		}
+		InputState input = packetInputs[index];
+		remoteInputs.push_back(input);
+		bool mispredicted = step < tick && input.getBits() != simulatedRemoteInputs[step % snapshots.size()].getBits();
+		if (mispredicted && (!rollbackPending || step < rollbackTick)) {
+			rollbackTick = step;
+			rollbackPending = true;
+		}
+	}
+}
+
+unsigned long long RollbackSession::getTick() const {
+	return tick;
+}
+
+unsigned long long RollbackSession::getConfirmedTick() const {
+	unsigned long long confirmed = tick < remoteInputs.size() ? tick : remoteInputs.size();
+	return rollbackPending && rollbackTick < confirmed ? rollbackTick : confirmed;
+}
+
+bool RollbackSession::isAcknowledged() const {
+	return acknowledged == localInputs.size();
+}
+
+const RollbackStats & RollbackSession::getStats() const {
+	return stats;
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "../Game.h"
+#include "../utils/Input.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * What a rollback session has done so far, to tell what re-simulating late input costs.
+ */
+struct RollbackStats {
+	unsigned long long ticks{};
+	// Advances refused because the remote input lagged behind by the whole rollback depth.
+	unsigned long long stalls{};
+	// Each rollback returns to the earliest mispredicted step and re-simulates every step since.
+	unsigned long long rollbacks{};
+	unsigned long long resimulatedTicks{};
+	size_t deepestRollback{};
+	unsigned long long packetsReceived{};
+	// Time spent in steps simulated for the first time and in re-simulated ones, snapshots included.
+	double stepMillis{};
+	double resimulationMillis{};
+};
+
+/**
+ * One side of a duel played over a network, keeping its game in step with the other side's without waiting for it.
+ *
+ * Every step is simulated as soon as the local input is known, predicting that the remote player still holds the
+ * keys of their last input received. When a remote input arrives which differs from the prediction, the game is
+ * restored to its snapshot from before that step, and all steps since are simulated again. Both sides thus end up
+ * with exactly the same game once all input arrived, however late. The local side may run ahead of the remote input
+ * by at most the rollback depth, which bounds the snapshots kept and the steps re-simulated at once.
+ *
+ * The sides exchange packets carrying every local input not yet acknowledged, so that lost packets need no
+ * retransmission of their own. Packets are written like snapshots, so both sides must run the same build.
+ */
+class RollbackSession {
+	Game & game;
+	// 0 steers the game's spaceship, 1 its rival.
+	unsigned int player{};
+	unsigned int stepMillis{};
+
+	// The number of steps simulated.
+	unsigned long long tick{};
+	std::vector<InputState> localInputs{};
+	// The remote input of every step received so far, without gaps.
+	std::vector<InputState> remoteInputs{};
+	// The number of local inputs the remote side received.
+	unsigned long long acknowledged{};
+
+	// Rings indexed by step, over the steps which may still be rolled back: the snapshot from before every step,
+	// and the remote input it was simulated with.
+	std::vector<std::vector<uint8_t>> snapshots{};
+	std::vector<InputState> simulatedRemoteInputs{};
+
+	// The earliest step simulated with a mispredicted remote input.
+	unsigned long long rollbackTick{};
+	bool rollbackPending{};
+
+	// The inputs of the last packet read, kept to reuse the memory.
+	std::vector<InputState> packetInputs{};
+
+	RollbackStats stats{};
+
+	/**
+	 * @return the remote input of the step, if received, or its prediction
+	 */
+	[[nodiscard]] InputState remoteInputAt(unsigned long long step) const;
+
+	/**
+	 * Saves a snapshot and simulates the next step.
+	 */
+	void simulate();
+
+public:
+	/**
+	 * @param game a duel, already reset, the same on both sides
+	 * @param player 0 for the side steering the spaceship, 1 for the side steering the rival
+	 * @param rollbackTicks the most steps the local side may run ahead of the remote input
+	 * @throws std::runtime_error if the player is neither 0 nor 1, or the rollback depth is 0
+	 */
+	RollbackSession(Game & game, unsigned int player, unsigned int stepMillis, size_t rollbackTicks);
+
+	/**
+	 * Rolls back if needed, then simulates the next step with the given local input.
+	 * @return false if the remote input lags behind too far, in which case the step waits for it
+	 */
+	bool advance(InputState input);
+
+	/**
+	 * Re-simulates the steps since the earliest mispredicted one, if any, so that the game reflects all input
+	 * received. Called by advance, and once more after the last step to settle the game.
+	 */
+	void synchronize();
+
+	/**
+	 * Writes the packet to send to the remote side next, reusing the memory of the bytes.
+	 */
+	void writePacket(std::vector<uint8_t> & packet) const;
+
+	/**
+	 * Takes the remote input from a packet of the other side. Packets may come late, twice or out of order.
+	 * @throws std::runtime_error if the packet is malformed
+	 */
+	void receivePacket(std::span<const uint8_t> packet);
+
+	[[nodiscard]] unsigned long long getTick() const;
+
+	/**
+	 * @return the number of steps simulated with the remote input received, which will not be rolled back
+	 */
+	[[nodiscard]] unsigned long long getConfirmedTick() const;
+
+	/**
+	 * @return whether the remote side received every local input
+	 */
+	[[nodiscard]] bool isAcknowledged() const;
+
+	[[nodiscard]] const RollbackStats & getStats() const;
+};
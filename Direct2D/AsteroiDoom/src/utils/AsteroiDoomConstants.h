@@ -1,21 +1,53 @@
 #pragma once
 
-#define WIN32_LEAN_AND_MEAN
+#include "Geometry.h"
 
-#include <d2d1.h>
+#include <cstddef>
 #include <numbers>
 
 // ----------------------------- UTILS -----------------------------
 
 const float RadiansInDegree = std::numbers::pi_v<float> / 180;
 
+// ----------------------------- SIMULATION -----------------------------
+
+// The simulation runs in fixed steps of 4 ms (250 Hz), independently of the frame rate.
+const unsigned int SimulationStepMillis = 4;
+// At most 100 ms are simulated per frame, the rest is dropped.
+const unsigned int MaxSimulationStepsPerFrame = 25;
+// Below this many entities, moving them on other threads costs more than it saves.
+const size_t ParallelMoveThreshold = 16384;
+// The rows a task of a parallel loop takes at least, as fewer are not worth handing to another thread: entities
+// moved, ships steered and moved, and rows queried for collision pairs.
+const size_t MinParallelMoveRows = 2048;
+const size_t MinParallelShipRows = 256;
+const size_t MinParallelDetectRows = 256;
+// A frame of a 60 Hz display.
+const double FrameBudgetMillis = 1000.0 / 60;
+// The game keeps a snapshot of every frame to rewind, with a keyframe every half a second, for the last 10 seconds.
+const size_t RewindDeltasPerKeyframe = 29;
+const size_t RewindKeyframes = 20;
+// In a networked duel, the remote player's input may arrive up to 32 steps (128 ms) late, re-simulating the steps
+// since. Beyond that, the game waits for it.
+const size_t RollbackTicks = 32;
+
 // ----------------------------- ARENA -----------------------------
 
+#if defined(ASTEROIDOOM_HEADLESS)
+
+// There is no screen to fill, so headless runs simulate a Full HD one.
+const float ArenaWidth = 1920;
+const float ArenaHeight = 1080;
+
+#else
+
 const float ArenaWidth = float(GetSystemMetrics(SM_CXSCREEN));
 const float ArenaHeight = float(GetSystemMetrics(SM_CYSCREEN));
 
 const D2D_MATRIX_3X2_F ArenaTranslation = D2D1::Matrix3x2F::Translation(ArenaWidth / 2, ArenaHeight / 2);
 
+#endif
+
 const float SpawnAreaMargin = 200;
 
 const float SpaceshipHitPoints = 100;
@@ -25,13 +57,28 @@ const float SpaceshipTorque = 400;
 const float SpaceshipGunOffset = 20;
 const float SpaceshipGunCooldown = 250;
 const float ProjectileSpeed = 600;
+const float ProjectileSize = 5;
+const unsigned int ProjectileDamage = 25;
+// Projectiles expire after flying for about two thirds of the width of a Full HD arena.
+const unsigned int ProjectileTimeToLive = 2000;
+const size_t ProjectilePoolCapacity = 1024;
 
 const unsigned int AsteroidSpawnDelay = 3000;
 
+// Particles only show what happens, and any emitted while this many are alive are dropped.
+const size_t ParticleCapacity = 131072;
+
 // ----------------------------- MEDIA -----------------------------
 
 const float SpaceshipSize = 25;
+
+#if !defined(ASTEROIDOOM_HEADLESS)
+
 const LPCWSTR SpaceshipPath = L"../assets/Spaceship.png";
 const LPCWSTR ProjectilePath = L"../assets/Projectile.png";
 const LPCWSTR Asteroid20Path = L"../assets/Asteroid20.png";
 const LPCWSTR Asteroid30Path = L"../assets/Asteroid30.png";
+// Where the profiled frames are written on exit, when built with ASTEROIDOOM_PROFILER.
+const LPCWSTR ProfilePath = L"AsteroiDoomProfile.csv";
+
+#endif
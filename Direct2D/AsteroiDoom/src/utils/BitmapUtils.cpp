@@ -1,7 +1,10 @@
 #include "BitmapUtils.h"
 
+#include <cmath>
 #include <stdexcept>
 
+#if !defined(ASTEROIDOOM_HEADLESS)
+
 BitmapHelper::BitmapHelper() = default;
 
 BitmapHelper::BitmapHelper(IWICImagingFactory * WICFactory, ID2D1HwndRenderTarget * renderTarget, LPCWSTR path) :
@@ -43,7 +46,7 @@ void BitmapHelper::reloadBitmap(ID2D1HwndRenderTarget * renderTarget) {
 	}
 }
 
-ID2D1Bitmap * BitmapHelper::getBitmap() {
+ID2D1Bitmap * BitmapHelper::getBitmap() const {
 	return bitmap;
 }
 
@@ -51,6 +54,23 @@ ID2D1HwndRenderTarget * BitmapHelper::getTarget() {
 	return target;
 }
 
+PixelBuffer BitmapHelper::copyPixels() const {
+	UINT width = 0, height = 0;
+	if (converter->GetSize(&width, &height) != S_OK) {
+		throw std::runtime_error("Failed to get the size of a bitmap.");
+	}
+	// The converter decodes to 32bppPBGRA, whose bytes read as 0xAARRGGBB, like the pixels of a PixelBuffer.
+	PixelBuffer pixels(width, height);
+	UINT stride = width * 4;
+	if (height > 0 &&
+	    converter->CopyPixels(nullptr, stride, stride * height, reinterpret_cast<BYTE *>(pixels.row(0))) != S_OK) {
+		throw std::runtime_error("Failed to copy the pixels of a bitmap.");
+	}
+	return pixels;
+}
+
+#endif
+
 BitmapSegment::BitmapSegment() = default;
 
 BitmapSegment::BitmapSegment(BitmapHelper * bitmapHelper, D2D_RECT_F segmentRect) :
@@ -64,6 +84,28 @@ D2D_RECT_F BitmapSegment::getCenteredRect() const {
 	return {-halfWidth, -halfHeight, halfWidth, halfHeight};
 }
 
+float BitmapSegment::getBoundingRadius() const {
+	return std::hypot(segment.right - segment.left, segment.bottom - segment.top) / 2;
+}
+
+const BitmapHelper * BitmapSegment::getBitmap() const {
+	return bitmap;
+}
+
+D2D_RECT_F BitmapSegment::getSegment() const {
+	return segment;
+}
+
+#if defined(ASTEROIDOOM_HEADLESS)
+
+void BitmapSegment::draw(D2D_POINT_2F, float, float, D2D1_BITMAP_INTERPOLATION_MODE) const {
+}
+
+void BitmapSegment::drawCentered(float, D2D1_BITMAP_INTERPOLATION_MODE) const {
+}
+
+#else
+
 void BitmapSegment::draw(
     D2D_POINT_2F translation, float rotation, float opacity, D2D1_BITMAP_INTERPOLATION_MODE interpolationMode
 ) const {
@@ -78,3 +120,9 @@ void BitmapSegment::draw(
 	bitmap->getTarget()->DrawBitmap(bitmap->getBitmap(), getCenteredRect(), opacity, interpolationMode, segment);
 	bitmap->getTarget()->SetTransform(oldTransform);
 }
+
+void BitmapSegment::drawCentered(float opacity, D2D1_BITMAP_INTERPOLATION_MODE interpolationMode) const {
+	bitmap->getTarget()->DrawBitmap(bitmap->getBitmap(), getCenteredRect(), opacity, interpolationMode, segment);
+}
+
+#endif
@@ -1,6 +1,16 @@
 #pragma once
 
-#define WIN32_LEAN_AND_MEAN
+#include "Geometry.h"
+#include "SoftwareRenderer.h"
+
+#if defined(ASTEROIDOOM_HEADLESS)
+
+/**
+ * Headless builds neither load nor draw bitmaps, so a bitmap is only an identity for the segments referring to it.
+ */
+class BitmapHelper {};
+
+#else
 
 #include <d2d1_3.h>
 #include <wincodec.h>
@@ -24,26 +34,56 @@ public:
 
 	void reloadBitmap(ID2D1HwndRenderTarget * target);
 
-	ID2D1Bitmap * getBitmap();
+	ID2D1Bitmap * getBitmap() const;
 
 	ID2D1HwndRenderTarget * getTarget();
+
+	/**
+	 * @return the decoded pixels, premultiplied like the ones drawn, e.g. to build collision masks from
+	 * @throws std::runtime_error if the pixels cannot be copied
+	 */
+	[[nodiscard]] PixelBuffer copyPixels() const;
 };
 
+#endif
+
 class BitmapSegment {
 	BitmapHelper * bitmap{nullptr};
 	D2D_RECT_F segment{};
 
-	[[nodiscard]] D2D_RECT_F getCenteredRect() const;
-
 public:
 	BitmapSegment();
 
 	BitmapSegment(BitmapHelper * bitmapHelper, D2D_RECT_F segmentRect);
 
+	/**
+	 * @return the radius of the smallest circle around the center of the segment containing it in any rotation
+	 */
+	[[nodiscard]] float getBoundingRadius() const;
+
+	/**
+	 * @return where the segment is drawn, centered at the origin of the transform it is drawn with
+	 */
+	[[nodiscard]] D2D_RECT_F getCenteredRect() const;
+
+	[[nodiscard]] const BitmapHelper * getBitmap() const;
+
+	/**
+	 * @return the part of the bitmap drawn, in its pixels
+	 */
+	[[nodiscard]] D2D_RECT_F getSegment() const;
+
 	void draw(
 	    D2D_POINT_2F translation,
 	    float rotation,
 	    float opacity = 1.f,
 	    D2D1_BITMAP_INTERPOLATION_MODE interpolationMode = D2D1_BITMAP_INTERPOLATION_MODE_LINEAR
 	) const;
+
+	/**
+	 * Draws the segment centered at the origin of the current transform of the target, leaving the transform be.
+	 */
+	void drawCentered(
+	    float opacity = 1.f, D2D1_BITMAP_INTERPOLATION_MODE interpolationMode = D2D1_BITMAP_INTERPOLATION_MODE_LINEAR
+	) const;
 };
@@ -0,0 +1,204 @@
+#include "DrawBackend.h"
+
+#include <stdexcept>
+
+DrawBackend::~DrawBackend() = default;
+
+void CountingDrawBackend::drawSprite(const BitmapSegment &, D2D_POINT_2F, float) {
+	drawCount++;
+}
+
+size_t CountingDrawBackend::getDrawCount() const {
+	return drawCount;
+}
+
+void CountingDrawBackend::reset() {
+	drawCount = 0;
+}
+
+SoftwareDrawBackend::SoftwareDrawBackend(SoftwareRenderer & renderer, D2D_POINT_2F offset) :
+    renderer(renderer),
+    offset(offset) {
+}
+
+void SoftwareDrawBackend::setPixels(const BitmapHelper * bitmap, const PixelBuffer * pixels) {
+	for (size_t index = 0; index < bitmaps.size(); index++) {
+		if (bitmaps[index] == bitmap) {
+			bitmapPixels[index] = pixels;
+			return;
+		}
+	}
+	bitmaps.push_back(bitmap);
+	bitmapPixels.push_back(pixels);
+}
+
+void SoftwareDrawBackend::drawSprite(const BitmapSegment & sprite, D2D_POINT_2F location, float rotation) {
+	// There are only a few bitmaps, so looking them up one by one is as fast as hashing.
+	for (size_t index = 0; index < bitmaps.size(); index++) {
+		if (bitmaps[index] == sprite.getBitmap()) {
+			renderer.draw(
+			    {bitmapPixels[index], sprite.getSegment(), {location.x + offset.x, location.y + offset.y}, rotation}
+			);
+			return;
+		}
+	}
+}
+
+void DrawCommandList::drawSprite(const BitmapSegment & sprite, D2D_POINT_2F location, float rotation) {
+	commands.push_back({sprite, location, rotation, 1});
+}
+
+void DrawCommandList::clear() {
+	commands.clear();
+	batches.clear();
+}
+
+void DrawCommandList::sortByBitmap() {
+	// A frame draws from a handful of bitmaps, mostly many sprites in a row from the same one, so looking the
+	// bitmaps up one by one beats hashing.
+	batches.clear();
+	ranks.resize(commands.size());
+	size_t rank = 0;
+	for (size_t index = 0; index < commands.size(); index++) {
+		const BitmapHelper * bitmap = commands[index].sprite.getBitmap();
+		if (batches.empty() || batches[rank].bitmap != bitmap) {
+			rank = 0;
+			while (rank < batches.size() && batches[rank].bitmap != bitmap) {
+				rank++;
+			}
+			if (rank == batches.size()) {
+				batches.push_back({bitmap, 0, 0});
+			}
+		}
+		batches[rank].count++;
+		ranks[index] = uint32_t(rank);
+	}
+
+	// A counting sort: every command goes after the ones recorded before it from the same bitmap.
+	size_t first = 0;
+	for (DrawBatch & batch : batches) {
+		batch.first = first;
+		first += batch.count;
+		batch.count = 0;
+	}
+	sorted.resize(commands.size());
+	for (size_t index = 0; index < commands.size(); index++) {
+		DrawBatch & batch = batches[ranks[index]];
+		sorted[batch.first + batch.count++] = commands[index];
+	}
+	commands.swap(sorted);
+}
+
+size_t DrawCommandList::size() const {
+	return commands.size();
+}
+
+const std::vector<DrawCommand> & DrawCommandList::getCommands() const {
+	return commands;
+}
+
+const std::vector<DrawBatch> & DrawCommandList::getBatches() const {
+	return batches;
+}
+
+void DrawCommandList::replay(DrawBackend & backend) const {
+	for (const DrawCommand & command : commands) {
+		backend.drawSprite(command.sprite, command.location, command.rotation);
+	}
+}
+
+#if !defined(ASTEROIDOOM_HEADLESS)
+
+TargetDrawSubmitter::TargetDrawSubmitter() = default;
+
+TargetDrawSubmitter::~TargetDrawSubmitter() {
+	release();
+}
+
+void TargetDrawSubmitter::release() {
+	if (spriteBatch) {
+		spriteBatch->Release();
+		spriteBatch = nullptr;
+	}
+	if (context) {
+		context->Release();
+		context = nullptr;
+	}
+}
+
+void TargetDrawSubmitter::reloadTarget(ID2D1RenderTarget * renderTarget) {
+	release();
+	target = renderTarget;
+	// Without a device context new enough for sprite batches, the sprites are drawn one by one.
+	if (target->QueryInterface(IID_PPV_ARGS(&context)) != S_OK || context->CreateSpriteBatch(&spriteBatch) != S_OK) {
+		release();
+	}
+}
+
+void TargetDrawSubmitter::setSpriteBatchEnabled(bool enabled) {
+	spriteBatchEnabled = enabled;
+}
+
+bool TargetDrawSubmitter::usesSpriteBatch() const {
+	return spriteBatch != nullptr && spriteBatchEnabled;
+}
+
+void TargetDrawSubmitter::submit(const DrawCommandList & commands) {
+	D2D1::Matrix3x2F baseTransform{};
+	target->GetTransform(&baseTransform);
+	if (usesSpriteBatch()) {
+		submitSpriteBatch(commands);
+	} else {
+		submitOneByOne(commands, baseTransform);
+	}
+	target->SetTransform(baseTransform);
+}
+
+void TargetDrawSubmitter::submitSpriteBatch(const DrawCommandList & commands) {
+	using D2D1::Matrix3x2F;
+
+	const std::vector<DrawCommand> & list = commands.getCommands();
+	destinations.clear();
+	sources.clear();
+	colors.clear();
+	transforms.clear();
+	for (const DrawCommand & command : list) {
+		D2D_RECT_F segment = command.sprite.getSegment();
+		destinations.push_back(command.sprite.getCenteredRect());
+		sources.push_back({UINT32(segment.left), UINT32(segment.top), UINT32(segment.right), UINT32(segment.bottom)});
+		colors.push_back({1, 1, 1, command.opacity});
+		// Applied before the transform of the target, like the transform every sprite sets when drawn one by one.
+		transforms.push_back(
+		    Matrix3x2F::Rotation(command.rotation) * Matrix3x2F::Translation(command.location.x, command.location.y)
+		);
+	}
+	spriteBatch->Clear();
+	if (!list.empty() &&
+	    spriteBatch->AddSprites(
+	        UINT32(list.size()), destinations.data(), sources.data(), colors.data(), transforms.data()
+	    ) != S_OK) {
+		throw std::runtime_error("Failed to add the sprites to the sprite batch.");
+	}
+
+	// Sprite batches are only drawn aliased, which the transparent edges of the sprites hardly show.
+	D2D1_ANTIALIAS_MODE antialiasMode = context->GetAntialiasMode();
+	context->SetAntialiasMode(D2D1_ANTIALIAS_MODE_ALIASED);
+	for (const DrawBatch & batch : commands.getBatches()) {
+		context->DrawSpriteBatch(spriteBatch, UINT32(batch.first), UINT32(batch.count), batch.bitmap->getBitmap());
+	}
+	context->SetAntialiasMode(antialiasMode);
+}
+
+void TargetDrawSubmitter::submitOneByOne(const DrawCommandList & commands, const D2D1::Matrix3x2F & baseTransform) {
+	using D2D1::Matrix3x2F;
+
+	for (const DrawCommand & command : commands.getCommands()) {
+		target->SetTransform(
+		    Matrix3x2F::Rotation(command.rotation) * Matrix3x2F::Translation(command.location.x, command.location.y) *
+		    baseTransform
+		);
+		command.sprite.drawCentered(command.opacity);
+	}
+}
+
+#endif
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "BitmapUtils.h"
+#include "Geometry.h"
+#include "SoftwareRenderer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Receives the sprites drawn in a frame, so that the arena does not depend on how, or whether, they are rendered.
+ */
+class DrawBackend {
+public:
+	virtual ~DrawBackend();
+
+	virtual void drawSprite(const BitmapSegment & sprite, D2D_POINT_2F location, float rotation) = 0;
+};
+
+/**
+ * Renders nothing and counts the sprites instead, e.g. to check how many draws a frame submits.
+ */
+class CountingDrawBackend final : public DrawBackend {
+	size_t drawCount{};
+
+public:
+	void drawSprite(const BitmapSegment & sprite, D2D_POINT_2F location, float rotation) override;
+
+	[[nodiscard]] size_t getDrawCount() const;
+
+	void reset();
+};
+
+/**
+ * Queues sprites on a SoftwareRenderer, e.g. to render frames without a window, translated by an offset like the
+ * arena is on the screen. Every bitmap drawn needs its pixels set first; sprites of other bitmaps are skipped.
+ */
+class SoftwareDrawBackend final : public DrawBackend {
+	SoftwareRenderer & renderer;
+	D2D_POINT_2F offset{};
+	std::vector<const BitmapHelper *> bitmaps{};
+	std::vector<const PixelBuffer *> bitmapPixels{};
+
+public:
+	SoftwareDrawBackend(SoftwareRenderer & renderer, D2D_POINT_2F offset);
+
+	/**
+	 * Draws the segments of the bitmap from the given pixels, which must outlive the backend.
+	 */
+	void setPixels(const BitmapHelper * bitmap, const PixelBuffer * pixels);
+
+	void drawSprite(const BitmapSegment & sprite, D2D_POINT_2F location, float rotation) override;
+};
+
+/**
+ * A sprite recorded for a frame, drawn centered at the location and rotated by the rotation, in degrees clockwise.
+ */
+struct DrawCommand {
+	BitmapSegment sprite{};
+	D2D_POINT_2F location{};
+	float rotation{};
+	float opacity{1};
+};
+
+/**
+ * The commands of a sorted list drawing from one bitmap, which can be submitted together.
+ */
+struct DrawBatch {
+	const BitmapHelper * bitmap{};
+	size_t first{};
+	size_t count{};
+};
+
+/**
+ * Records the sprites of a frame into a flat list instead of drawing them, so that they can be sorted by bitmap and
+ * submitted a batch per bitmap, or replayed to another backend.
+ *
+ * Sorting keeps the bitmaps in the order they first appear in the frame, and the commands of a bitmap in the order
+ * they were recorded, so only sprites of different bitmaps may change places. The arena draws every kind of object
+ * at once, so those are mostly asteroids of the two sizes, which rarely overlap.
+ */
+class DrawCommandList final : public DrawBackend {
+	std::vector<DrawCommand> commands{};
+	// Kept between frames to reuse the memory.
+	std::vector<DrawCommand> sorted{};
+	std::vector<uint32_t> ranks{};
+	std::vector<DrawBatch> batches{};
+
+public:
+	void drawSprite(const BitmapSegment & sprite, D2D_POINT_2F location, float rotation) override;
+
+	/**
+	 * Empties the list for the next frame, keeping its memory.
+	 */
+	void clear();
+
+	/**
+	 * Orders the commands by bitmap, stably, and groups them into batches.
+	 */
+	void sortByBitmap();
+
+	[[nodiscard]] size_t size() const;
+
+	[[nodiscard]] const std::vector<DrawCommand> & getCommands() const;
+
+	/**
+	 * @return the batches of the last sort, empty if the list was not sorted since it was cleared
+	 */
+	[[nodiscard]] const std::vector<DrawBatch> & getBatches() const;
+
+	/**
+	 * Draws the commands in their current order on another backend, e.g. a SoftwareDrawBackend or a
+	 * CountingDrawBackend. Backends without opacity draw every sprite opaque.
+	 */
+	void replay(DrawBackend & backend) const;
+};
+
+#if !defined(ASTEROIDOOM_HEADLESS)
+
+/**
+ * Submits sorted command lists to a render target. Where the target is a device context supporting sprite batches
+ * (Windows 10 and later), every batch is a single DrawSpriteBatch call with the transforms of its sprites; otherwise
+ * every sprite sets its own transform, without restoring it in between. The transform of the target is restored
+ * after every submission.
+ */
+class TargetDrawSubmitter {
+	ID2D1RenderTarget * target{};
+	ID2D1DeviceContext3 * context{};
+	ID2D1SpriteBatch * spriteBatch{};
+	bool spriteBatchEnabled{true};
+	// The sprites of a frame as DrawSpriteBatch takes them, kept between frames to reuse the memory.
+	std::vector<D2D1_RECT_F> destinations{};
+	std::vector<D2D1_RECT_U> sources{};
+	std::vector<D2D1_COLOR_F> colors{};
+	std::vector<D2D1_MATRIX_3X2_F> transforms{};
+
+	void release();
+
+	void submitSpriteBatch(const DrawCommandList & commands);
+
+	void submitOneByOne(const DrawCommandList & commands, const D2D1::Matrix3x2F & baseTransform);
+
+public:
+	TargetDrawSubmitter();
+
+	~TargetDrawSubmitter();
+
+	TargetDrawSubmitter(const TargetDrawSubmitter &) = delete;
+
+	TargetDrawSubmitter & operator=(const TargetDrawSubmitter &) = delete;
+
+	/**
+	 * Submits to the given target from now on, e.g. after it was recreated, with a sprite batch if it supports them.
+	 */
+	void reloadTarget(ID2D1RenderTarget * renderTarget);
+
+	/**
+	 * Draws the sprites one by one even where the target supports sprite batches, e.g. to compare both ways.
+	 */
+	void setSpriteBatchEnabled(bool enabled);
+
+	[[nodiscard]] bool usesSpriteBatch() const;
+
+	/**
+	 * Draws the commands a batch at a time, in the order of the batches.
+	 * @param commands sorted by sortByBitmap since they were last recorded
+	 * @throws std::runtime_error if the sprites cannot be added to the sprite batch
+	 */
+	void submit(const DrawCommandList & commands);
+};
+
+#endif
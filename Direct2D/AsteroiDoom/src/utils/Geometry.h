@@ -0,0 +1,33 @@
+#pragma once
+
+// Geometry types shared by the simulation. Headless builds define them without any Windows headers,
+// with the same layout as their Direct2D counterparts.
+
+#if defined(ASTEROIDOOM_HEADLESS)
+
+struct D2D_POINT_2F {
+	float x;
+	float y;
+};
+
+struct D2D_RECT_F {
+	float left;
+	float top;
+	float right;
+	float bottom;
+};
+
+using D2D1_RECT_F = D2D_RECT_F;
+
+enum D2D1_BITMAP_INTERPOLATION_MODE {
+	D2D1_BITMAP_INTERPOLATION_MODE_NEAREST_NEIGHBOR = 0,
+	D2D1_BITMAP_INTERPOLATION_MODE_LINEAR = 1
+};
+
+#else
+
+#define WIN32_LEAN_AND_MEAN
+
+#include <d2d1.h>
+
+#endif
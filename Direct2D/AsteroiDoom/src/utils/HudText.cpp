@@ -0,0 +1,33 @@
+#include "HudText.h"
+
+#include <cwchar>
+
+HudText::HudText() = default;
+
+HudText::HudText(const wchar_t * format) : format(format) {
+}
+
+bool HudText::update(unsigned long long first, unsigned long long second) {
+	if (formatCount != 0 && values[0] == first && values[1] == second) {
+		return false;
+	}
+	values[0] = first;
+	values[1] = second;
+	// Formats which take a single value ignore the second one.
+	int written = std::swprintf(text, Capacity, format, first, second);
+	length = written < 0 ? 0 : (unsigned int)written;
+	formatCount++;
+	return true;
+}
+
+const wchar_t * HudText::getText() const {
+	return text;
+}
+
+unsigned int HudText::getLength() const {
+	return length;
+}
+
+unsigned long long HudText::getFormatCount() const {
+	return formatCount;
+}
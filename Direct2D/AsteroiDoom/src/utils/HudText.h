@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * A line of the HUD, formatted from up to two numbers into a fixed buffer.
+ *
+ * The text is formatted again only when the numbers change, and every change bumps the format count, so that whatever
+ * is built from the text, e.g. a text layout, can be cached until the count moves on.
+ */
+class HudText {
+	static const size_t Capacity = 64;
+
+	const wchar_t * format{};
+	unsigned long long values[2]{};
+
+	wchar_t text[Capacity]{};
+	unsigned int length{};
+	unsigned long long formatCount{};
+
+public:
+	HudText();
+
+	/**
+	 * @param format a swprintf format taking up to two unsigned long long values, e.g. L"SCORE: %llu"
+	 */
+	explicit HudText(const wchar_t * format);
+
+	/**
+	 * Formats the text again if the values differ from the last ones.
+	 * @return whether the text changed
+	 */
+	bool update(unsigned long long first, unsigned long long second = 0);
+
+	[[nodiscard]] const wchar_t * getText() const;
+
+	[[nodiscard]] unsigned int getLength() const;
+
+	/**
+	 * @return how many times the text has been formatted, which identifies its current version
+	 */
+	[[nodiscard]] unsigned long long getFormatCount() const;
+};
@@ -0,0 +1,51 @@
+#include "Input.h"
+
+#if !defined(ASTEROIDOOM_HEADLESS)
+#define WIN32_LEAN_AND_MEAN
+
+#include <windows.h>
+#endif
+
+InputState::InputState() = default;
+
+InputState::InputState(uint8_t bits) : bits(bits) {
+}
+
+bool InputState::isPressed(Key key) const {
+	return bits & uint8_t(key);
+}
+
+void InputState::press(Key key) {
+	bits |= uint8_t(key);
+}
+
+uint8_t InputState::getBits() const {
+	return bits;
+}
+
+#if !defined(ASTEROIDOOM_HEADLESS)
+
+InputState InputState::poll() {
+	InputState input{};
+	if (GetAsyncKeyState('W')) {
+		input.press(Key::Thrust);
+	}
+	if (GetAsyncKeyState('S')) {
+		input.press(Key::Reverse);
+	}
+	if (GetAsyncKeyState('D')) {
+		input.press(Key::TurnRight);
+	}
+	if (GetAsyncKeyState('A')) {
+		input.press(Key::TurnLeft);
+	}
+	if (GetAsyncKeyState(VK_SHIFT)) {
+		input.press(Key::Boost);
+	}
+	if (GetAsyncKeyState(VK_SPACE)) {
+		input.press(Key::Shoot);
+	}
+	return input;
+}
+
+#endif
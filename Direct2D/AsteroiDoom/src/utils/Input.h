@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+
+enum class Key : uint8_t {
+	Thrust = 1 << 0,
+	Reverse = 1 << 1,
+	TurnRight = 1 << 2,
+	TurnLeft = 1 << 3,
+	Boost = 1 << 4,
+	Shoot = 1 << 5
+};
+
+/**
+ * The set of keys held during a frame, packed into a bitfield.
+ */
+class InputState {
+	uint8_t bits{};
+
+public:
+	InputState();
+
+	explicit InputState(uint8_t bits);
+
+	[[nodiscard]] bool isPressed(Key key) const;
+
+	void press(Key key);
+
+	[[nodiscard]] uint8_t getBits() const;
+
+#if !defined(ASTEROIDOOM_HEADLESS)
+	/**
+	 * Reads the keyboard: W, S, D, A, Shift and Space.
+	 */
+	static InputState poll();
+#endif
+};
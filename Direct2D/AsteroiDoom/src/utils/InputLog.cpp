@@ -0,0 +1,129 @@
+#include "InputLog.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+
+namespace {
+	const char Magic[4] = {'A', 'D', 'I', 'L'};
+	const uint8_t Version = 1;
+
+	void writeByte(std::ostream & log, uint8_t byte) {
+		log.put(char(byte));
+	}
+
+	uint8_t readByte(std::istream & log) {
+		char byte{};
+		if (!log.get(byte)) {
+			throw std::runtime_error("Unexpected end of input log.");
+		}
+		return uint8_t(byte);
+	}
+
+	// Unsigned integers are written 7 bits at a time, lowest first, with the high bit marking that more follow.
+	void writeNumber(std::ostream & log, unsigned long long number) {
+		while (number >= 0x80) {
+			writeByte(log, uint8_t(number | 0x80));
+			number >>= 7;
+		}
+		writeByte(log, uint8_t(number));
+	}
+
+	unsigned long long readNumber(std::istream & log) {
+		unsigned long long number = 0;
+		for (int shift = 0; shift < 64; shift += 7) {
+			uint8_t byte = readByte(log);
+			number |= (unsigned long long)(byte & 0x7f) << shift;
+			if (!(byte & 0x80)) {
+				return number;
+			}
+		}
+		throw std::runtime_error("Invalid number in input log.");
+	}
+} // namespace
+
+InputLog::InputLog() = default;
+
+InputLog::InputLog(uint64_t seed, unsigned int stepMillis) : seed(seed), stepMillis(stepMillis) {
+}
+
+InputLog::InputLog(std::istream & log) {
+	for (char expected : Magic) {
+		if (char(readByte(log)) != expected) {
+			throw std::runtime_error("Not an input log.");
+		}
+	}
+	if (readByte(log) != Version) {
+		throw std::runtime_error("Unsupported input log version.");
+	}
+	seed = readNumber(log);
+	stepMillis = (unsigned int)readNumber(log);
+	if (stepMillis == 0) {
+		throw std::runtime_error("Invalid step length in input log.");
+	}
+
+	size_t runCount = readNumber(log);
+	for (size_t run = 0; run < runCount; run++) {
+		unsigned long long length = readNumber(log);
+		InputState input(readByte(log));
+		if (length == 0) {
+			throw std::runtime_error("Empty run in input log.");
+		}
+		entries.push_back({tickCount, input});
+		tickCount += length;
+	}
+}
+
+void InputLog::record(InputState input) {
+	if (entries.empty() || entries.back().input.getBits() != input.getBits()) {
+		entries.push_back({tickCount, input});
+	}
+	tickCount++;
+}
+
+void InputLog::truncate(unsigned long long ticks) {
+	if (ticks >= tickCount) {
+		return;
+	}
+	while (!entries.empty() && entries.back().tick >= ticks) {
+		entries.pop_back();
+	}
+	tickCount = ticks;
+}
+
+void InputLog::write(std::ostream & log) const {
+	log.write(Magic, sizeof(Magic));
+	writeByte(log, Version);
+	writeNumber(log, seed);
+	writeNumber(log, stepMillis);
+
+	writeNumber(log, entries.size());
+	for (size_t entry = 0; entry < entries.size(); entry++) {
+		unsigned long long end = entry + 1 < entries.size() ? entries[entry + 1].tick : tickCount;
+		writeNumber(log, end - entries[entry].tick);
+		writeByte(log, entries[entry].input.getBits());
+	}
+}
+
+uint64_t InputLog::getSeed() const {
+	return seed;
+}
+
+unsigned int InputLog::getStepMillis() const {
+	return stepMillis;
+}
+
+unsigned long long InputLog::getTickCount() const {
+	return tickCount;
+}
+
+InputState InputLog::at(unsigned long long tick) const {
+	if (tick >= tickCount) {
+		return {};
+	}
+	auto next = std::upper_bound(entries.begin(), entries.end(), tick, [](unsigned long long value, const Entry & entry) {
+		return value < entry.tick;
+	});
+	return std::prev(next)->input;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Input.h"
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+/**
+ * The input of every simulation step of a session, together with the seed of the game and the length of a step,
+ * which is everything needed to play the session again exactly.
+ *
+ * The game is assumed to be reset whenever it is over, both when recording and when replaying.
+ * In the binary form, the input is stored as runs of steps with the same keys held.
+ */
+class InputLog {
+	struct Entry {
+		unsigned long long tick;
+		InputState input;
+	};
+
+	uint64_t seed{};
+	unsigned int stepMillis{};
+	unsigned long long tickCount{};
+
+	// Sorted by tick, each entry holding its input until the next one.
+	std::vector<Entry> entries{};
+
+public:
+	InputLog();
+
+	InputLog(uint64_t seed, unsigned int stepMillis);
+
+	/**
+	 * Reads a log written by write.
+	 * @throws std::runtime_error if the log is malformed
+	 */
+	explicit InputLog(std::istream & log);
+
+	/**
+	 * Appends the input of the next step.
+	 */
+	void record(InputState input);
+
+	/**
+	 * Forgets the steps from the given one on, e.g. when the game is rewound, so that the log holds the input of the
+	 * session as it finally went.
+	 */
+	void truncate(unsigned long long ticks);
+
+	void write(std::ostream & log) const;
+
+	[[nodiscard]] uint64_t getSeed() const;
+
+	[[nodiscard]] unsigned int getStepMillis() const;
+
+	[[nodiscard]] unsigned long long getTickCount() const;
+
+	/**
+	 * @return the input of the given step, or no keys past the end of the log
+	 */
+	[[nodiscard]] InputState at(unsigned long long tick) const;
+};
@@ -0,0 +1,158 @@
+#include "Profiler.h"
+
+#include "AsteroiDoomConstants.h"
+
+#include <cwchar>
+
+namespace {
+	// Eighths of a block, from the lowest to the full one.
+	const wchar_t GraphLevels[] = L"\u2581\u2582\u2583\u2584\u2585\u2586\u2587\u2588";
+	const size_t GraphLevelCount = 8;
+	const size_t GraphWidth = 60;
+
+	double millisBetween(Profiler::Clock::time_point start, Profiler::Clock::time_point end) {
+		return std::chrono::duration<double, std::milli>(end - start).count();
+	}
+} // namespace
+
+Profiler::Profiler() = default;
+
+void Profiler::add(ProfilePhase phase, double millis) {
+	current.phaseMillis[size_t(phase)] += millis;
+}
+
+void Profiler::addCollisionPairs(size_t count) {
+	current.collisionPairs += count;
+}
+
+void Profiler::addDrawCommands(size_t count) {
+	current.drawCommands += count;
+}
+
+void Profiler::endFrame() {
+	auto now = Clock::now();
+	current.totalMillis = millisBetween(frameStart, now);
+	frameStart = now;
+
+	for (size_t phase = 0; phase < ProfilePhaseCount; phase++) {
+		totals.phaseMillis[phase] += current.phaseMillis[phase];
+	}
+	totals.totalMillis += current.totalMillis;
+	totals.collisionPairs += current.collisionPairs;
+	totals.drawCommands += current.drawCommands;
+
+	unsigned long long frame = frameCount.load(std::memory_order_relaxed);
+	frames[frame % Capacity] = current;
+	frameCount.store(frame + 1, std::memory_order_release);
+	current = FrameProfile();
+}
+
+unsigned long long Profiler::getFrameCount() const {
+	return frameCount.load(std::memory_order_acquire);
+}
+
+const FrameProfile & Profiler::getTotals() const {
+	return totals;
+}
+
+FrameProfile Profiler::average(size_t count) const {
+	FrameProfile result{};
+	size_t visited = 0;
+	forEachRecent(count, [&](const FrameProfile & frame) {
+		for (size_t phase = 0; phase < ProfilePhaseCount; phase++) {
+			result.phaseMillis[phase] += frame.phaseMillis[phase];
+		}
+		result.totalMillis += frame.totalMillis;
+		result.collisionPairs += frame.collisionPairs;
+		result.drawCommands += frame.drawCommands;
+		visited++;
+	});
+	if (visited > 0) {
+		for (double & millis : result.phaseMillis) {
+			millis /= double(visited);
+		}
+		result.totalMillis /= double(visited);
+		result.collisionPairs /= visited;
+		result.drawCommands /= visited;
+	}
+	return result;
+}
+
+void Profiler::writeCsv(std::ostream & csv) const {
+	csv << "frame";
+	for (size_t phase = 0; phase < ProfilePhaseCount; phase++) {
+		csv << ',' << nameOf(ProfilePhase(phase));
+	}
+	csv << ",total,pairs,commands\n";
+
+	unsigned long long published = getFrameCount();
+	unsigned long long frame = published < Capacity ? 0 : published - Capacity;
+	forEachRecent(Capacity, [&](const FrameProfile & profile) {
+		csv << frame++;
+		for (double millis : profile.phaseMillis) {
+			csv << ',' << millis;
+		}
+		csv << ',' << profile.totalMillis << ',' << profile.collisionPairs << ',' << profile.drawCommands << '\n';
+	});
+}
+
+const char * Profiler::nameOf(ProfilePhase phase) {
+	switch (phase) {
+	case ProfilePhase::Move:
+		return "move";
+	case ProfilePhase::Spawn:
+		return "spawn";
+	case ProfilePhase::Collisions:
+		return "collisions";
+	case ProfilePhase::Draw:
+		return "draw";
+	case ProfilePhase::Submit:
+		return "submit";
+	case ProfilePhase::Text:
+		return "text";
+	case ProfilePhase::Present:
+		return "present";
+	}
+	return "";
+}
+
+ScopedTimer::ScopedTimer(Profiler & profiler, ProfilePhase phase) : profiler(profiler), phase(phase) {
+}
+
+ScopedTimer::~ScopedTimer() {
+	profiler.add(phase, millisBetween(start, Profiler::Clock::now()));
+}
+
+size_t formatProfilerOverlay(const Profiler & profiler, size_t frames, wchar_t * buffer, size_t capacity) {
+	FrameProfile average = profiler.average(frames);
+	int written = std::swprintf(
+	    buffer,
+	    capacity,
+	    L"FRAME %6.2f ms\nMOVE %6.2f  SPAWN %6.2f  COLLISIONS %6.2f (%zu PAIRS)\n"
+	    L"DRAW %6.2f (%zu SPRITES)  SUBMIT %6.2f  TEXT %6.2f  PRESENT %6.2f\n",
+	    average.totalMillis,
+	    average.phaseMillis[size_t(ProfilePhase::Move)],
+	    average.phaseMillis[size_t(ProfilePhase::Spawn)],
+	    average.phaseMillis[size_t(ProfilePhase::Collisions)],
+	    average.collisionPairs,
+	    average.phaseMillis[size_t(ProfilePhase::Draw)],
+	    average.drawCommands,
+	    average.phaseMillis[size_t(ProfilePhase::Submit)],
+	    average.phaseMillis[size_t(ProfilePhase::Text)],
+	    average.phaseMillis[size_t(ProfilePhase::Present)]
+	);
+	if (written < 0) {
+		return 0;
+	}
+
+	auto length = size_t(written);
+	profiler.forEachRecent(GraphWidth, [&](const FrameProfile & frame) {
+		if (length + 1 >= capacity) {
+			return;
+		}
+		auto level = size_t(frame.totalMillis / (2 * FrameBudgetMillis) * GraphLevelCount);
+		buffer[length++] = GraphLevels[level < GraphLevelCount ? level : GraphLevelCount - 1];
+	});
+	buffer[length] = L'\0';
+	return length;
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+enum class ProfilePhase : uint8_t {
+	Move,
+	Spawn,
+	Collisions,
+	Draw,
+	Submit,
+	Text,
+	Present
+};
+
+const size_t ProfilePhaseCount = 7;
+
+/**
+ * How long each phase of a frame took, in milliseconds, and how much work the collisions and the drawing had.
+ */
+struct FrameProfile {
+	double phaseMillis[ProfilePhaseCount]{};
+	double totalMillis{};
+	// Summed over the steps of the frame, see Arena::getCollisionPairCount.
+	size_t collisionPairs{};
+	// The sprites submitted, see DrawCommandList.
+	size_t drawCommands{};
+};
+
+/**
+ * Times the phases of frames, keeping the most recent ones in a ring buffer and the totals of all of them.
+ *
+ * Frames are written by a single thread. Every finished frame is published with a release store of the frame count,
+ * so that the recent frames can be read without locks, by another thread as long as it keeps well behind the writer.
+ * The profiler is compiled in only with ASTEROIDOOM_PROFILER, see ASTEROIDOOM_PROFILE.
+ */
+class Profiler {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	static const size_t Capacity = 4096;
+
+private:
+	// Allocated up front, so that profiling never allocates.
+	std::vector<FrameProfile> frames = std::vector<FrameProfile>(Capacity);
+	std::atomic<unsigned long long> frameCount{};
+
+	FrameProfile current{};
+	FrameProfile totals{};
+	Clock::time_point frameStart{Clock::now()};
+
+public:
+	Profiler();
+
+	/**
+	 * Adds the time to the phase of the current frame, which may run several times a frame, e.g. for every step.
+	 */
+	void add(ProfilePhase phase, double millis);
+
+	void addCollisionPairs(size_t count);
+
+	void addDrawCommands(size_t count);
+
+	/**
+	 * Ends the current frame, timed from the end of the previous one, and publishes it.
+	 */
+	void endFrame();
+
+	[[nodiscard]] unsigned long long getFrameCount() const;
+
+	/**
+	 * @return the sum of every phase and of the whole frames over all frames so far
+	 */
+	[[nodiscard]] const FrameProfile & getTotals() const;
+
+	/**
+	 * Calls visit(const FrameProfile &) for at most the given number of the most recent frames, oldest first.
+	 */
+	template <typename Visitor>
+	void forEachRecent(size_t count, Visitor && visit) const;
+
+	/**
+	 * @return the average of at most the given number of the most recent frames
+	 */
+	[[nodiscard]] FrameProfile average(size_t count) const;
+
+	/**
+	 * Writes the recent frames as CSV, a frame per line, with the times of every phase and of the whole frame, the
+	 * number of collision pairs and the number of draw commands.
+	 */
+	void writeCsv(std::ostream & csv) const;
+
+	[[nodiscard]] static const char * nameOf(ProfilePhase phase);
+};
+
+template <typename Visitor>
+void Profiler::forEachRecent(size_t count, Visitor && visit) const {
+	unsigned long long published = frameCount.load(std::memory_order_acquire);
+	unsigned long long available = published < Capacity ? published : Capacity;
+	unsigned long long first = published - (count < available ? count : available);
+	for (unsigned long long frame = first; frame < published; frame++) {
+		visit(frames[frame % Capacity]);
+	}
+}
+
+/**
+ * Adds the time from its construction to its destruction to a phase of the current frame.
+ */
+class ScopedTimer {
+	Profiler & profiler;
+	ProfilePhase phase;
+	Profiler::Clock::time_point start{Profiler::Clock::now()};
+
+public:
+	ScopedTimer(Profiler & profiler, ProfilePhase phase);
+
+	ScopedTimer(const ScopedTimer &) = delete;
+
+	ScopedTimer & operator=(const ScopedTimer &) = delete;
+
+	~ScopedTimer();
+};
+
+/**
+ * Formats the averages of the phases over the recent frames, followed by a graph of their frame times scaled to two
+ * frame budgets, for an overlay drawn over the game.
+ * @return the length of the text written to the buffer
+ */
+size_t formatProfilerOverlay(const Profiler & profiler, size_t frames, wchar_t * buffer, size_t capacity);
+
+#if defined(ASTEROIDOOM_PROFILER)
+
+#define ASTEROIDOOM_PROFILE_CONCAT_INNER(first, second) first##second
+#define ASTEROIDOOM_PROFILE_CONCAT(first, second) ASTEROIDOOM_PROFILE_CONCAT_INNER(first, second)
+
+/**
+ * Times the rest of the enclosing scope as the given phase.
+ */
+#define ASTEROIDOOM_PROFILE(profiler, phase) \
+	ScopedTimer ASTEROIDOOM_PROFILE_CONCAT(profileTimer, __LINE__)((profiler), (phase))
+
+#define ASTEROIDOOM_PROFILE_COLLISION_PAIRS(profiler, count) (profiler).addCollisionPairs(count)
+
+#define ASTEROIDOOM_PROFILE_DRAW_COMMANDS(profiler, count) (profiler).addDrawCommands(count)
+
+#define ASTEROIDOOM_PROFILE_END_FRAME(profiler) (profiler).endFrame()
+
+#else
+
+// Without the profiler, the arguments are not even evaluated.
+#define ASTEROIDOOM_PROFILE(profiler, phase)
+#define ASTEROIDOOM_PROFILE_COLLISION_PAIRS(profiler, count)
+#define ASTEROIDOOM_PROFILE_DRAW_COMMANDS(profiler, count)
+#define ASTEROIDOOM_PROFILE_END_FRAME(profiler)
+
+#endif
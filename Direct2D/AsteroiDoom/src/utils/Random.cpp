@@ -1,9 +1,110 @@
 #include "Random.h"
 
-std::random_device Random::randomDevice{};
+#include <algorithm>
+#include <cmath>
+#include <random>
 
-std::mt19937 Random::rng{randomDevice()};
+namespace {
+	uint32_t rotateLeft(uint32_t value, int bits) {
+		return (value << bits) | (value >> (32 - bits));
+	}
+
+	uint64_t splitMix(uint64_t & value) {
+		uint64_t result = (value += 0x9e3779b97f4a7c15);
+		result = (result ^ (result >> 30)) * 0xbf58476d1ce4e5b9;
+		result = (result ^ (result >> 27)) * 0x94d049bb133111eb;
+		return result ^ (result >> 31);
+	}
+
+	// 24 bits, as many as fit exactly in the significand of a float.
+	const float FloatUnit = 1.f / float(1 << 24);
+} // namespace
+
+Random::Random() : Random(0) {
+}
+
+Random::Random(uint64_t seed) {
+	this->seed(seed);
+}
+
+void Random::seed(uint64_t value) {
+	// SplitMix64 spreads even similar seeds over the whole state, which is never all zeros.
+	for (int word = 0; word < 4; word += 2) {
+		uint64_t bits = splitMix(value);
+		state[word] = uint32_t(bits);
+		state[word + 1] = uint32_t(bits >> 32);
+	}
+}
+
+uint64_t Random::randomSeed() {
+	std::random_device randomDevice{};
+	return (uint64_t(randomDevice()) << 32) | randomDevice();
+}
+
+uint32_t Random::next() {
+	uint32_t result = rotateLeft(state[1] * 5, 7) * 9;
+	uint32_t shifted = state[1] << 9;
+	state[2] ^= state[0];
+	state[3] ^= state[1];
+	state[1] ^= state[2];
+	state[0] ^= state[3];
+	state[2] ^= shifted;
+	state[3] = rotateLeft(state[3], 11);
+	return result;
+}
 
 unsigned int Random::next(unsigned int a, unsigned int b) {
-	return rng() % (b - a) + a;
+	uint32_t range = b - a;
+	uint64_t product = uint64_t(next()) * range;
+	auto low = uint32_t(product);
+	if (low < range) {
+		// Rejects the 2^32 % range lowest products, which would favour some results.
+		uint32_t threshold = (0 - range) % range;
+		while (low < threshold) {
+			product = uint64_t(next()) * range;
+			low = uint32_t(product);
+		}
+	}
+	return uint32_t(product >> 32) + a;
+}
+
+float Random::nextFloat() {
+	return float(next() >> 8) * FloatUnit;
+}
+
+void Random::fill(float * values, size_t count, float low, float high) {
+	// A local copy of the state stays in registers for the whole loop.
+	Random local = *this;
+	float scale = (high - low) * FloatUnit;
+	// Adding low can round the largest values up to high itself, e.g. 1 + (1 - 2^-24) to 2.
+	float highest = std::nextafter(high, low);
+	for (size_t i = 0; i < count; i++) {
+		values[i] = std::min<float>(float(local.next() >> 8) * scale + low, highest);
+	}
+	*this = local;
+}
+
+void Random::jump() {
+	static const uint32_t Jump[] = {0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b};
+
+	uint32_t jumped[4]{};
+	for (uint32_t word : Jump) {
+		for (int bit = 0; bit < 32; bit++) {
+			if (word & (uint32_t(1) << bit)) {
+				for (int i = 0; i < 4; i++) {
+					jumped[i] ^= state[i];
+				}
+			}
+			next();
+		}
+	}
+	for (int i = 0; i < 4; i++) {
+		state[i] = jumped[i];
+	}
+}
+
+Random Random::split() {
+	Random stream = *this;
+	jump();
+	return stream;
 }
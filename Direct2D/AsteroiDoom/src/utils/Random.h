@@ -1,11 +1,66 @@
 #pragma once
 
-#include <random>
+#include <cstddef>
+#include <cstdint>
 
+/**
+ * A xoshiro128** generator: small, fast and fully reproducible from its seed on every platform, unlike the
+ * distributions of the standard library.
+ *
+ * Every simulation owns its generator, so that simulations running side by side stay deterministic.
+ * A generator can also be split into independent streams, e.g. one for every thread.
+ */
 class Random {
-	static std::random_device randomDevice;
-	static std::mt19937 rng;
+	uint32_t state[4]{};
 
 public:
-	static unsigned int next(unsigned int a, unsigned int b);
+	/**
+	 * Creates a generator seeded with 0.
+	 */
+	Random();
+
+	explicit Random(uint64_t seed);
+
+	/**
+	 * Restarts the generator, so that the following numbers can be reproduced.
+	 */
+	void seed(uint64_t value);
+
+	/**
+	 * @return a seed drawn from the random device, for sessions which should not be reproducible unless recorded
+	 */
+	[[nodiscard]] static uint64_t randomSeed();
+
+	/**
+	 * @return 32 uniformly distributed bits
+	 */
+	uint32_t next();
+
+	/**
+	 * Draws without bias, using Lemire's multiply-shift rejection, which almost never needs a division.
+	 * @return a uniformly distributed integer in [a, b), where a < b
+	 */
+	unsigned int next(unsigned int a, unsigned int b);
+
+	/**
+	 * @return a uniformly distributed float in [0, 1)
+	 */
+	float nextFloat();
+
+	/**
+	 * Fills the given array with uniformly distributed floats in [low, high), where low < high, cheaper than drawing
+	 * them one by one.
+	 */
+	void fill(float * values, size_t count, float low, float high);
+
+	/**
+	 * Advances the generator by 2^64 numbers.
+	 */
+	void jump();
+
+	/**
+	 * Splits off a stream which does not overlap with the following 2^64 numbers of this generator.
+	 * @return a generator continuing from the current state, while this one jumps ahead
+	 */
+	Random split();
 };
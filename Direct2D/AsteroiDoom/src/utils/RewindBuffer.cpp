@@ -0,0 +1,112 @@
+#include "RewindBuffer.h"
+
+#include "Snapshot.h"
+
+size_t RewindBuffer::Group::size() const {
+	return 1 + deltaEnds.size();
+}
+
+RewindBuffer::RewindBuffer() = default;
+
+RewindBuffer::RewindBuffer(size_t groupCount, size_t deltasPerKeyframe) :
+    deltasPerKeyframe(deltasPerKeyframe),
+    groups(groupCount) {
+}
+
+RewindBuffer::Group & RewindBuffer::group(size_t index) {
+	return groups[(firstGroup + index) % groups.size()];
+}
+
+const RewindBuffer::Group & RewindBuffer::group(size_t index) const {
+	return groups[(firstGroup + index) % groups.size()];
+}
+
+void RewindBuffer::push(std::span<const uint8_t> snapshot) {
+	if (groups.empty()) {
+		return;
+	}
+	if (groupCount == 0 || group(groupCount - 1).deltaEnds.size() == deltasPerKeyframe) {
+		if (groupCount == groups.size()) {
+			// Every index shifts by a group.
+			firstGroup = (firstGroup + 1) % groups.size();
+			groupCount--;
+			decodedValid = false;
+		}
+		Group & started = group(groupCount++);
+		started.keyframe.assign(snapshot.begin(), snapshot.end());
+		started.deltas.clear();
+		started.deltaEnds.clear();
+	} else {
+		Group & last = group(groupCount - 1);
+		encodeDelta(newest, snapshot, last.deltas);
+		last.deltaEnds.push_back(last.deltas.size());
+	}
+	newest.assign(snapshot.begin(), snapshot.end());
+}
+
+std::span<const uint8_t> RewindBuffer::at(size_t index) {
+	size_t groupSize = 1 + deltasPerKeyframe;
+	size_t groupIndex = index / groupSize, position = index % groupSize;
+	const Group & found = group(groupIndex);
+
+	// Carry on from the last snapshot read if it comes earlier in the same group, or start from the keyframe.
+	size_t applied = 0;
+	if (decodedValid && decodedIndex / groupSize == groupIndex && decodedIndex <= index) {
+		applied = decodedIndex % groupSize;
+	} else {
+		decoded.assign(found.keyframe.begin(), found.keyframe.end());
+	}
+	for (; applied < position; applied++) {
+		size_t begin = applied == 0 ? 0 : found.deltaEnds[applied - 1];
+		applyDelta(decoded, std::span(found.deltas).subspan(begin, found.deltaEnds[applied] - begin));
+	}
+	decodedIndex = index;
+	decodedValid = true;
+	return decoded;
+}
+
+void RewindBuffer::truncate(size_t count) {
+	if (count >= size()) {
+		return;
+	}
+	if (count == 0) {
+		clear();
+		return;
+	}
+	size_t groupSize = 1 + deltasPerKeyframe;
+	size_t lastIndex = count - 1;
+	groupCount = lastIndex / groupSize + 1;
+	Group & last = group(groupCount - 1);
+	size_t deltas = lastIndex % groupSize;
+	last.deltaEnds.resize(deltas);
+	last.deltas.resize(deltas == 0 ? 0 : last.deltaEnds.back());
+
+	std::span<const uint8_t> kept = at(lastIndex);
+	newest.assign(kept.begin(), kept.end());
+}
+
+void RewindBuffer::clear() {
+	firstGroup = 0;
+	groupCount = 0;
+	newest.clear();
+	decodedValid = false;
+}
+
+size_t RewindBuffer::size() const {
+	if (groupCount == 0) {
+		return 0;
+	}
+	return (groupCount - 1) * (1 + deltasPerKeyframe) + group(groupCount - 1).size();
+}
+
+bool RewindBuffer::empty() const {
+	return groupCount == 0;
+}
+
+size_t RewindBuffer::getStoredBytes() const {
+	size_t bytes = 0;
+	for (size_t index = 0; index < groupCount; index++) {
+		bytes += group(index).keyframe.size() + group(index).deltas.size();
+	}
+	return bytes;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * The most recent snapshots of a game, e.g. one per frame for the last few seconds, to rewind and scrub through.
+ *
+ * Snapshots are kept in groups: a whole keyframe followed by deltas, each from the snapshot before it, see
+ * encodeDelta. The groups form a ring, so once it is full, every new group replaces the oldest one, and the memory
+ * stays bounded by the number of groups, while the memory of replaced groups is reused.
+ *
+ * Reading a snapshot applies the deltas from its keyframe on, at most one group's worth. The last snapshot read
+ * is kept, so that reading the next one, e.g. when scrubbing forwards, applies a single delta.
+ */
+class RewindBuffer {
+	struct Group {
+		std::vector<uint8_t> keyframe{};
+		// The deltas one after another, with the offset where each one ends.
+		std::vector<uint8_t> deltas{};
+		std::vector<size_t> deltaEnds{};
+
+		[[nodiscard]] size_t size() const;
+	};
+
+	size_t deltasPerKeyframe{};
+	std::vector<Group> groups{};
+	size_t firstGroup{};
+	size_t groupCount{};
+
+	// The newest snapshot, which the next delta is taken from.
+	std::vector<uint8_t> newest{};
+
+	// The snapshot last returned by at, identified by its index.
+	std::vector<uint8_t> decoded{};
+	size_t decodedIndex{};
+	bool decodedValid{};
+
+	[[nodiscard]] Group & group(size_t index);
+
+	[[nodiscard]] const Group & group(size_t index) const;
+
+public:
+	/**
+	 * Creates a buffer which keeps nothing.
+	 */
+	RewindBuffer();
+
+	/**
+	 * @param groupCount the number of keyframes kept
+	 * @param deltasPerKeyframe the number of snapshots kept as deltas after every keyframe
+	 */
+	RewindBuffer(size_t groupCount, size_t deltasPerKeyframe);
+
+	/**
+	 * Adds the newest snapshot, dropping the oldest group of snapshots if the buffer is full.
+	 */
+	void push(std::span<const uint8_t> snapshot);
+
+	/**
+	 * @param index the index of the snapshot, the oldest one kept being 0
+	 * @return the snapshot, valid until the buffer is modified or read again
+	 */
+	[[nodiscard]] std::span<const uint8_t> at(size_t index);
+
+	/**
+	 * Drops the snapshots newer than the given one, e.g. to carry on from a rewound state.
+	 */
+	void truncate(size_t count);
+
+	void clear();
+
+	/**
+	 * @return the number of snapshots kept
+	 */
+	[[nodiscard]] size_t size() const;
+
+	[[nodiscard]] bool empty() const;
+
+	/**
+	 * @return the bytes taken by the keyframes and deltas
+	 */
+	[[nodiscard]] size_t getStoredBytes() const;
+};
@@ -0,0 +1,127 @@
+#include "Snapshot.h"
+
+namespace {
+	// Shorter runs of unchanged bytes are cheaper to store among the changed ones than as a run of their own.
+	const size_t MinUnchangedRun = 4;
+
+	void writeVarint(uint64_t value, std::vector<uint8_t> & bytes) {
+		while (value >= 0x80) {
+			bytes.push_back(uint8_t(value | 0x80));
+			value >>= 7;
+		}
+		bytes.push_back(uint8_t(value));
+	}
+
+	uint64_t readVarint(std::span<const uint8_t> bytes, size_t & offset) {
+		uint64_t value = 0;
+		for (unsigned int shift = 0; shift < 64; shift += 7) {
+			if (offset == bytes.size()) {
+				break;
+			}
+			uint8_t byte = bytes[offset++];
+			value |= uint64_t(byte & 0x7F) << shift;
+			if (byte < 0x80) {
+				return value;
+			}
+		}
+		throw std::runtime_error("Malformed snapshot delta.");
+	}
+
+	/**
+	 * Counts the bytes from the given position on which are the same in both snapshots, comparing whole words while
+	 * possible. Bytes past the end of the previous snapshot are compared with zero.
+	 */
+	size_t unchangedFrom(std::span<const uint8_t> previous, std::span<const uint8_t> current, size_t position) {
+		size_t start = position;
+		size_t common = previous.size() < current.size() ? previous.size() : current.size();
+		while (position + sizeof(uint64_t) <= common) {
+			uint64_t before, after;
+			std::memcpy(&before, previous.data() + position, sizeof(uint64_t));
+			std::memcpy(&after, current.data() + position, sizeof(uint64_t));
+			if (before != after) {
+				break;
+			}
+			position += sizeof(uint64_t);
+		}
+		for (; position < current.size(); position++) {
+			uint8_t before = position < previous.size() ? previous[position] : 0;
+			if (before != current[position]) {
+				break;
+			}
+		}
+		return position - start;
+	}
+} // namespace
+
+SnapshotWriter::SnapshotWriter(std::vector<uint8_t> & bytes) : bytes(bytes) {
+	bytes.clear();
+}
+
+SnapshotReader::SnapshotReader(std::span<const uint8_t> bytes) : bytes(bytes) {
+}
+
+void SnapshotReader::readBytes(void * destination, size_t count) {
+	if (count > bytes.size() - offset) {
+		throw std::runtime_error("The snapshot ended unexpectedly.");
+	}
+	if (count > 0) {
+		std::memcpy(destination, bytes.data() + offset, count);
+	}
+	offset += count;
+}
+
+bool SnapshotReader::atEnd() const {
+	return offset == bytes.size();
+}
+
+void encodeDelta(std::span<const uint8_t> previous, std::span<const uint8_t> current, std::vector<uint8_t> & delta) {
+	writeVarint(current.size(), delta);
+	size_t position = 0;
+	while (position < current.size()) {
+		size_t unchanged = unchangedFrom(previous, current, position);
+		position += unchanged;
+
+		// The changed bytes run until enough unchanged ones follow them, or to the end.
+		size_t changedStart = position;
+		while (position < current.size()) {
+			if (current[position] != (position < previous.size() ? previous[position] : 0)) {
+				position++;
+				continue;
+			}
+			size_t following = unchangedFrom(previous, current, position);
+			if (following >= MinUnchangedRun || position + following == current.size()) {
+				break;
+			}
+			position += following + 1;
+		}
+
+		writeVarint(unchanged, delta);
+		writeVarint(position - changedStart, delta);
+		for (size_t changed = changedStart; changed < position; changed++) {
+			delta.push_back(current[changed] ^ (changed < previous.size() ? previous[changed] : 0));
+		}
+	}
+}
+
+void applyDelta(std::vector<uint8_t> & snapshot, std::span<const uint8_t> delta) {
+	size_t offset = 0;
+	uint64_t size = readVarint(delta, offset);
+	// Bytes past the end of the previous snapshot were encoded against zero.
+	snapshot.resize(size_t(size));
+	size_t position = 0;
+	while (position < snapshot.size()) {
+		uint64_t unchanged = readVarint(delta, offset);
+		uint64_t changed = readVarint(delta, offset);
+		if (unchanged > snapshot.size() - position || changed > snapshot.size() - position - unchanged ||
+		    changed > delta.size() - offset) {
+			throw std::runtime_error("Malformed snapshot delta.");
+		}
+		position += size_t(unchanged);
+		for (size_t byte = 0; byte < changed; byte++) {
+			snapshot[position++] ^= delta[offset++];
+		}
+	}
+	if (offset != delta.size()) {
+		throw std::runtime_error("Malformed snapshot delta.");
+	}
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+// A snapshot is the state of a game flattened into plain bytes, so that it can be copied, compared and
+// delta-compressed as a whole. It refers to bitmaps by address, so it is only valid in the process which took it.
+
+/**
+ * Writes the state of objects into the bytes of a snapshot, each value as its object representation.
+ */
+class SnapshotWriter {
+	std::vector<uint8_t> & bytes;
+
+public:
+	/**
+	 * Empties the bytes, keeping their memory, and writes from their start.
+	 */
+	explicit SnapshotWriter(std::vector<uint8_t> & bytes);
+
+	template <typename Value>
+	void write(const Value & value);
+
+	/**
+	 * Writes the number of values followed by all of them.
+	 */
+	template <typename Value>
+	void writeAll(std::span<const Value> values);
+};
+
+/**
+ * Reads back the values written by a SnapshotWriter, in the same order.
+ */
+class SnapshotReader {
+	std::span<const uint8_t> bytes;
+	size_t offset{};
+
+	void readBytes(void * destination, size_t count);
+
+public:
+	explicit SnapshotReader(std::span<const uint8_t> bytes);
+
+	/**
+	 * @throws std::runtime_error if the snapshot ends before the value
+	 */
+	template <typename Value>
+	void read(Value & value);
+
+	/**
+	 * Replaces the contents of the vector with values written by writeAll, reusing its memory if it has room.
+	 * @throws std::runtime_error if the snapshot ends before the values
+	 */
+	template <typename Value>
+	void readAll(std::vector<Value> & values);
+
+	[[nodiscard]] bool atEnd() const;
+};
+
+/**
+ * Appends the difference between two snapshots to the delta: the length of the current one, then runs of unchanged
+ * bytes and of changed ones XORed with the previous snapshot, with their lengths as varints.
+ * Snapshots of consecutive steps differ in few bytes, as most components, e.g. sizes and hit points, rarely change.
+ */
+void encodeDelta(std::span<const uint8_t> previous, std::span<const uint8_t> current, std::vector<uint8_t> & delta);
+
+/**
+ * Turns the previous snapshot into the current one, given the delta between them from encodeDelta.
+ * @throws std::runtime_error if the delta is malformed
+ */
+void applyDelta(std::vector<uint8_t> & snapshot, std::span<const uint8_t> delta);
+
+template <typename Value>
+void SnapshotWriter::write(const Value & value) {
+	static_assert(std::is_trivially_copyable_v<Value>, "Only trivially copyable values can be written to snapshots.");
+	auto first = reinterpret_cast<const uint8_t *>(&value);
+	bytes.insert(bytes.end(), first, first + sizeof(Value));
+}
+
+template <typename Value>
+void SnapshotWriter::writeAll(std::span<const Value> values) {
+	static_assert(std::is_trivially_copyable_v<Value>, "Only trivially copyable values can be written to snapshots.");
+	write(uint64_t(values.size()));
+	auto first = reinterpret_cast<const uint8_t *>(values.data());
+	bytes.insert(bytes.end(), first, first + values.size_bytes());
+}
+
+template <typename Value>
+void SnapshotReader::read(Value & value) {
+	static_assert(std::is_trivially_copyable_v<Value>, "Only trivially copyable values can be read from snapshots.");
+	readBytes(&value, sizeof(Value));
+}
+
+template <typename Value>
+void SnapshotReader::readAll(std::vector<Value> & values) {
+	static_assert(std::is_trivially_copyable_v<Value>, "Only trivially copyable values can be read from snapshots.");
+	uint64_t count{};
+	read(count);
+	if (count > (bytes.size() - offset) / sizeof(Value)) {
+		throw std::runtime_error("The snapshot ended unexpectedly.");
+	}
+	values.resize(size_t(count));
+	readBytes(values.data(), size_t(count) * sizeof(Value));
+}
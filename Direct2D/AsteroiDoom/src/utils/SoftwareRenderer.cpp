@@ -0,0 +1,307 @@
+#include "SoftwareRenderer.h"
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ASTEROIDOOM_SSE2
+#endif
+
+namespace {
+	// Small enough for the pixels of a tile to stay in the cache while its sprites are blended.
+	const int TileSize = 64;
+
+	// Below this many sprites, rasterizing them on other threads costs more than it saves.
+	const size_t ParallelSpriteThreshold = 256;
+
+	const float Inverse255 = 1.f / 255;
+
+	/**
+	 * The four pixels around a sampled point, zero outside the segment, and the point's offsets from the first one.
+	 */
+	struct Sample {
+		uint32_t texels[4];
+		float weightX;
+		float weightY;
+	};
+
+	/**
+	 * Narrows [first, last] to cover the x for which low < start + x * step < high, give or take a pixel at both ends.
+	 * Leaves first > last if there are none.
+	 */
+	void clipSpan(float start, float step, float low, float high, int & first, int & last) {
+		if (step == 0) {
+			if (start <= low || high <= start) {
+				last = first - 1;
+			}
+			return;
+		}
+		float from = (low - start) / step, to = (high - start) / step;
+		if (step < 0) {
+			std::swap(from, to);
+		}
+		// Clamped before converting, as a nearly zero step puts the bounds far out of the range of int.
+		from = std::max<float>(from, float(first) - 1);
+		to = std::min<float>(to, float(last) + 1);
+		first = std::max<int>(first, int(std::floor(from)));
+		last = std::min<int>(last, int(std::ceil(to)));
+	}
+
+	float channel(uint32_t pixel, int index) {
+		return float((pixel >> (8 * index)) & 0xFF);
+	}
+
+	/**
+	 * Blends the bilinearly sampled source over the destination, one channel at a time.
+	 */
+	uint32_t blendScalar(uint32_t destination, const Sample & sample, float opacity) {
+		float inverseX = 1 - sample.weightX, inverseY = 1 - sample.weightY;
+		float source[4];
+		for (int index = 0; index < 4; index++) {
+			float top = channel(sample.texels[0], index) * inverseX + channel(sample.texels[1], index) * sample.weightX;
+			float bottom =
+			    channel(sample.texels[2], index) * inverseX + channel(sample.texels[3], index) * sample.weightX;
+			source[index] = (top * inverseY + bottom * sample.weightY) * opacity;
+		}
+		float remaining = 1 - source[3] * Inverse255;
+		uint32_t result = 0;
+		for (int index = 0; index < 4; index++) {
+			long value = std::lrint(channel(destination, index) * remaining + source[index]);
+			result |= uint32_t(std::clamp(value, 0L, 255L)) << (8 * index);
+		}
+		return result;
+	}
+
+#if defined(ASTEROIDOOM_SSE2)
+	// The channels of a pixel in the lanes of a vector, blue first.
+	__m128 unpack(uint32_t pixel) {
+		const __m128i zero = _mm_setzero_si128();
+		__m128i bytes = _mm_cvtsi32_si128(int(pixel));
+		return _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(bytes, zero), zero));
+	}
+
+	/**
+	 * Same as blendScalar, with all four channels at once, in the same order of operations.
+	 */
+	uint32_t blendVectorized(uint32_t destination, const Sample & sample, float opacity) {
+		const __m128 one = _mm_set1_ps(1);
+		__m128 weightX = _mm_set1_ps(sample.weightX), weightY = _mm_set1_ps(sample.weightY);
+		__m128 inverseX = _mm_sub_ps(one, weightX), inverseY = _mm_sub_ps(one, weightY);
+
+		__m128 top = _mm_add_ps(
+		    _mm_mul_ps(unpack(sample.texels[0]), inverseX), _mm_mul_ps(unpack(sample.texels[1]), weightX)
+		);
+		__m128 bottom = _mm_add_ps(
+		    _mm_mul_ps(unpack(sample.texels[2]), inverseX), _mm_mul_ps(unpack(sample.texels[3]), weightX)
+		);
+		__m128 source =
+		    _mm_mul_ps(_mm_add_ps(_mm_mul_ps(top, inverseY), _mm_mul_ps(bottom, weightY)), _mm_set1_ps(opacity));
+
+		__m128 alpha = _mm_shuffle_ps(source, source, _MM_SHUFFLE(3, 3, 3, 3));
+		__m128 remaining = _mm_sub_ps(one, _mm_mul_ps(alpha, _mm_set1_ps(Inverse255)));
+		__m128i result = _mm_cvtps_epi32(_mm_add_ps(_mm_mul_ps(unpack(destination), remaining), source));
+		result = _mm_packs_epi32(result, result);
+		return uint32_t(_mm_cvtsi128_si32(_mm_packus_epi16(result, result)));
+	}
+#else
+	uint32_t blendVectorized(uint32_t destination, const Sample & sample, float opacity) {
+		return blendScalar(destination, sample, opacity);
+	}
+#endif
+} // namespace
+
+PixelBuffer::PixelBuffer() = default;
+
+PixelBuffer::PixelBuffer(unsigned int width, unsigned int height) :
+    width(width),
+    height(height),
+    pixels(size_t(width) * height) {
+}
+
+unsigned int PixelBuffer::getWidth() const {
+	return width;
+}
+
+unsigned int PixelBuffer::getHeight() const {
+	return height;
+}
+
+uint32_t * PixelBuffer::row(unsigned int y) {
+	return pixels.data() + size_t(y) * width;
+}
+
+const uint32_t * PixelBuffer::row(unsigned int y) const {
+	return pixels.data() + size_t(y) * width;
+}
+
+void PixelBuffer::fill(uint32_t pixel) {
+	std::fill(pixels.begin(), pixels.end(), pixel);
+}
+
+void PixelBuffer::writeTga(std::ostream & file) const {
+	if (width > 0xFFFF || height > 0xFFFF) {
+		throw std::runtime_error("The image is too large for TGA.");
+	}
+	// An uncompressed true colour image with 8 bits of alpha, stored from the top row down.
+	const char header[18]{
+	    0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	    char(width & 0xFF), char(width >> 8), char(height & 0xFF), char(height >> 8), 32, 0x28};
+	file.write(header, sizeof(header));
+	for (uint32_t pixel : pixels) {
+		const char bytes[4]{char(pixel & 0xFF), char((pixel >> 8) & 0xFF), char((pixel >> 16) & 0xFF), char(pixel >> 24)};
+		file.write(bytes, sizeof(bytes));
+	}
+}
+
+SoftwareRenderer::SoftwareRenderer() : parallelThreshold(ParallelSpriteThreshold) {
+}
+
+void SoftwareRenderer::draw(const Sprite & sprite) {
+	if (!sprite.pixels) {
+		return;
+	}
+	Placement placement{};
+	placement.pixels = sprite.pixels;
+	placement.segmentLeft = int(std::lround(sprite.segment.left));
+	placement.segmentTop = int(std::lround(sprite.segment.top));
+	placement.segmentWidth = int(std::lround(sprite.segment.right)) - placement.segmentLeft;
+	placement.segmentHeight = int(std::lround(sprite.segment.bottom)) - placement.segmentTop;
+	if (placement.segmentLeft < 0 || placement.segmentTop < 0 ||
+	    placement.segmentLeft + placement.segmentWidth > int(sprite.pixels->getWidth()) ||
+	    placement.segmentTop + placement.segmentHeight > int(sprite.pixels->getHeight())) {
+		throw std::runtime_error("The sprite segment lies outside its pixels.");
+	}
+
+	float radians = sprite.rotation * std::numbers::pi_v<float> / 180;
+	placement.center = sprite.location;
+	placement.cosine = std::cos(radians);
+	placement.sine = std::sin(radians);
+	placement.opacity = sprite.opacity;
+
+	// Bilinear sampling reaches half a pixel beyond the segment.
+	float radius = std::hypot(float(placement.segmentWidth), float(placement.segmentHeight)) / 2 + 1;
+	placement.left = int(std::floor(sprite.location.x - radius));
+	placement.top = int(std::floor(sprite.location.y - radius));
+	placement.right = int(std::ceil(sprite.location.x + radius));
+	placement.bottom = int(std::ceil(sprite.location.y + radius));
+	queue.push_back(placement);
+}
+
+void SoftwareRenderer::rasterizeTile(PixelBuffer & target, size_t tile, unsigned int tileColumns) const {
+	int tileLeft = int(tile % tileColumns) * TileSize;
+	int tileTop = int(tile / tileColumns) * TileSize;
+	int tileRight = std::min<int>(tileLeft + TileSize, int(target.getWidth())) - 1;
+	int tileBottom = std::min<int>(tileTop + TileSize, int(target.getHeight())) - 1;
+
+	for (uint32_t index : tileSprites[tile]) {
+		const Placement & sprite = queue[index];
+		// Copied, so that writing the pixels does not make the compiler read them again for every pixel.
+		const int segmentWidth = sprite.segmentWidth, segmentHeight = sprite.segmentHeight;
+		const float width = float(segmentWidth), height = float(segmentHeight), opacity = sprite.opacity;
+		const size_t stride = sprite.pixels->getWidth();
+		const uint32_t * segment = sprite.pixels->row(unsigned(sprite.segmentTop)) + sprite.segmentLeft;
+		const int left = std::max<int>(sprite.left, tileLeft);
+		const int right = std::min<int>(sprite.right, tileRight);
+		const int bottom = std::min<int>(sprite.bottom, tileBottom);
+
+		for (int y = std::max<int>(sprite.top, tileTop); y <= bottom; y++) {
+			// Rotating the center of pixel left + i back into the segment gives the point (uStart + i * uStep,
+			// vStart + i * vStep), relative to the center of the first texel.
+			float dx = float(left) + 0.5f - sprite.center.x, dy = float(y) + 0.5f - sprite.center.y;
+			float uStart = dx * sprite.cosine + dy * sprite.sine + width / 2 - 0.5f, uStep = sprite.cosine;
+			float vStart = dy * sprite.cosine - dx * sprite.sine + height / 2 - 0.5f, vStep = -sprite.sine;
+
+			// Only visit the pixels which sample the segment.
+			int first = 0, last = right - left;
+			clipSpan(uStart, uStep, -1, width, first, last);
+			clipSpan(vStart, vStep, -1, height, first, last);
+
+			uint32_t * row = target.row(unsigned(y)) + left;
+			for (int i = first; i <= last; i++) {
+				float u = uStart + float(i) * uStep, v = vStart + float(i) * vStep;
+				if (u <= -1 || v <= -1 || u >= width || v >= height) {
+					continue;
+				}
+
+				// Both are above -1, so truncating rounds down.
+				int column = int(u + 1) - 1, line = int(v + 1) - 1;
+				Sample sample{{}, u - float(column), v - float(line)};
+				if (column >= 0 && line >= 0 && column + 1 < segmentWidth && line + 1 < segmentHeight) {
+					const uint32_t * above = segment + size_t(line) * stride + column;
+					sample.texels[0] = above[0];
+					sample.texels[1] = above[1];
+					sample.texels[2] = above[stride];
+					sample.texels[3] = above[stride + 1];
+				} else {
+					// On the edge of the segment, where the texels outside it are transparent.
+					for (int texel = 0; texel < 4; texel++) {
+						int texelX = column + texel % 2, texelY = line + texel / 2;
+						if (0 <= texelX && texelX < segmentWidth && 0 <= texelY && texelY < segmentHeight) {
+							sample.texels[texel] = segment[size_t(texelY) * stride + size_t(texelX)];
+						}
+					}
+				}
+				if ((sample.texels[0] | sample.texels[1] | sample.texels[2] | sample.texels[3]) == 0) {
+					continue;
+				}
+				row[i] = vectorized ? blendVectorized(row[i], sample, opacity) : blendScalar(row[i], sample, opacity);
+			}
+		}
+	}
+}
+
+void SoftwareRenderer::render(PixelBuffer & target) {
+	int width = int(target.getWidth()), height = int(target.getHeight());
+	unsigned int tileColumns = unsigned(width + TileSize - 1) / TileSize;
+	unsigned int tileRows = unsigned(height + TileSize - 1) / TileSize;
+	size_t tiles = size_t(tileColumns) * tileRows;
+	if (tileSprites.size() < tiles) {
+		tileSprites.resize(tiles);
+	}
+	for (size_t tile = 0; tile < tiles; tile++) {
+		tileSprites[tile].clear();
+	}
+
+	for (size_t index = 0; index < queue.size(); index++) {
+		const Placement & sprite = queue[index];
+		int left = std::max<int>(sprite.left, 0), top = std::max<int>(sprite.top, 0);
+		int right = std::min<int>(sprite.right, width - 1), bottom = std::min<int>(sprite.bottom, height - 1);
+		if (left > right || top > bottom) {
+			continue;
+		}
+		for (int tileRow = top / TileSize; tileRow <= bottom / TileSize; tileRow++) {
+			for (int tileColumn = left / TileSize; tileColumn <= right / TileSize; tileColumn++) {
+				tileSprites[size_t(tileRow) * tileColumns + size_t(tileColumn)].push_back(uint32_t(index));
+			}
+		}
+	}
+
+	auto rasterize = [&](size_t begin, size_t end) {
+		for (size_t tile = begin; tile < end; tile++) {
+			rasterizeTile(target, tile, tileColumns);
+		}
+	};
+	if (queue.size() >= parallelThreshold) {
+		ThreadPool::shared().parallelFor(tiles, 1, rasterize);
+	} else {
+		rasterize(0, tiles);
+	}
+	queue.clear();
+}
+
+size_t SoftwareRenderer::getQueuedCount() const {
+	return queue.size();
+}
+
+void SoftwareRenderer::setParallelThreshold(size_t spriteCount) {
+	parallelThreshold = spriteCount;
+}
+
+void SoftwareRenderer::setVectorized(bool enabled) {
+	vectorized = enabled;
+}
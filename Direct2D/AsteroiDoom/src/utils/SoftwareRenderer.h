@@ -0,0 +1,113 @@
+#pragma once
+
+#include "Geometry.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+/**
+ * An image in memory, made of premultiplied BGRA pixels stored row by row, each one read as 0xAARRGGBB.
+ */
+class PixelBuffer {
+	unsigned int width{};
+	unsigned int height{};
+	std::vector<uint32_t> pixels{};
+
+public:
+	PixelBuffer();
+
+	PixelBuffer(unsigned int width, unsigned int height);
+
+	[[nodiscard]] unsigned int getWidth() const;
+
+	[[nodiscard]] unsigned int getHeight() const;
+
+	[[nodiscard]] uint32_t * row(unsigned int y);
+
+	[[nodiscard]] const uint32_t * row(unsigned int y) const;
+
+	void fill(uint32_t pixel);
+
+	/**
+	 * Writes the image as an uncompressed 32-bit TGA, e.g. to look at a frame rendered headless.
+	 * TGA expects straight alpha, which is the same as premultiplied alpha for opaque images such as whole frames.
+	 */
+	void writeTga(std::ostream & file) const;
+};
+
+/**
+ * Draws rotated and translated sprites into a PixelBuffer on the CPU, sampling them bilinearly, like the render
+ * target of the window does, and blending them over what was drawn before.
+ *
+ * Sprites are queued and rasterized all at once by render, which splits the target into tiles, collects the sprites
+ * overlapping each one, and rasterizes the tiles in parallel. Every pixel still blends its sprites in the order they
+ * were queued, so the result does not depend on the number of threads.
+ */
+class SoftwareRenderer {
+public:
+	struct Sprite {
+		const PixelBuffer * pixels{};
+		// The part of the pixels drawn, centered at the location.
+		D2D_RECT_F segment{};
+		D2D_POINT_2F location{};
+		// In degrees, clockwise, like Direct2D rotations.
+		float rotation{};
+		float opacity{1};
+	};
+
+private:
+	// A queued sprite, with what rasterizing it needs computed once.
+	struct Placement {
+		const PixelBuffer * pixels;
+		int segmentLeft;
+		int segmentTop;
+		int segmentWidth;
+		int segmentHeight;
+		D2D_POINT_2F center;
+		float cosine;
+		float sine;
+		float opacity;
+		// The pixels of the target the sprite may cover, including the right and bottom ones.
+		int left;
+		int top;
+		int right;
+		int bottom;
+	};
+
+	std::vector<Placement> queue{};
+
+	// The indices of the queued sprites overlapping each tile, kept between frames to reuse the memory.
+	std::vector<std::vector<uint32_t>> tileSprites{};
+
+	size_t parallelThreshold{};
+	bool vectorized{true};
+
+	void rasterizeTile(PixelBuffer & target, size_t tile, unsigned int tileColumns) const;
+
+public:
+	SoftwareRenderer();
+
+	/**
+	 * Queues the sprite, to be drawn on the next render. Sprites without pixels are skipped.
+	 */
+	void draw(const Sprite & sprite);
+
+	/**
+	 * Rasterizes the queued sprites over what the target already holds, then empties the queue.
+	 */
+	void render(PixelBuffer & target);
+
+	[[nodiscard]] size_t getQueuedCount() const;
+
+	/**
+	 * Sets the number of queued sprites from which tiles are split between the threads of ThreadPool::shared.
+	 */
+	void setParallelThreshold(size_t spriteCount);
+
+	/**
+	 * Chooses between blending with SIMD, when compiled with SSE2, and one channel at a time, with identical results.
+	 */
+	void setVectorized(bool enabled);
+};
@@ -41,14 +41,44 @@ TextHelper::TextHelper(
 
 void TextHelper::reloadBrush(ID2D1HwndRenderTarget * newTarget) {
 	target = newTarget;
-	if (target->CreateSolidColorBrush(D2D1::ColorF(D2D1::ColorF::White), &brush) != S_OK) {
+	if (target->CreateSolidColorBrush(brushColour, &brush) != S_OK) {
 		throw std::runtime_error("Failed to create solid colour brush.");
 	}
 }
 
+void TextHelper::setColour(D2D1_COLOR_F colour) {
+	// The brush belongs to this helper, so it keeps whatever colour was drawn with last.
+	if (colour.r != brushColour.r || colour.g != brushColour.g || colour.b != brushColour.b ||
+	    colour.a != brushColour.a) {
+		brush->SetColor(colour);
+		brushColour = colour;
+	}
+}
+
 void TextHelper::draw(const wchar_t * text, unsigned int length, D2D1_COLOR_F colour) {
-	D2D1_COLOR_F oldColour = brush->GetColor();
-	brush->SetColor(colour);
+	setColour(colour);
 	target->DrawTextW(text, length, text_format, rect, brush);
-	brush->SetColor(oldColour);
+}
+
+void TextHelper::draw(const HudText & text, D2D1_COLOR_F colour) {
+	if (!layout || layoutText != &text || layoutFormatCount != text.getFormatCount()) {
+		if (layout) {
+			layout->Release();
+			layout = nullptr;
+		}
+		if (write_factory->CreateTextLayout(
+		        text.getText(), text.getLength(), text_format, rect.right - rect.left, rect.bottom - rect.top, &layout
+		    ) != S_OK) {
+			throw std::runtime_error("Failed to create text layout.");
+		}
+		layoutText = &text;
+		layoutFormatCount = text.getFormatCount();
+		layoutCount++;
+	}
+	setColour(colour);
+	target->DrawTextLayout({rect.left, rect.top}, layout, brush);
+}
+
+unsigned long long TextHelper::getLayoutCount() const {
+	return layoutCount;
 }
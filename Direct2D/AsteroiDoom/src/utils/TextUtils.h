@@ -1,5 +1,7 @@
 #pragma once
 
+#include "HudText.h"
+
 #include <d2d1.h>
 #include <dwrite_3.h>
 
@@ -9,9 +11,18 @@ class TextHelper {
 
 	ID2D1HwndRenderTarget * target{};
 	ID2D1SolidColorBrush * brush{};
+	D2D1_COLOR_F brushColour{D2D1::ColorF(D2D1::ColorF::White)};
 
 	D2D1_RECT_F rect{};
 
+	// The layout of the last HUD text drawn, kept until the text changes.
+	IDWriteTextLayout * layout{};
+	const HudText * layoutText{};
+	unsigned long long layoutFormatCount{};
+	unsigned long long layoutCount{};
+
+	void setColour(D2D1_COLOR_F colour);
+
 public:
 	TextHelper();
 
@@ -27,9 +38,22 @@ public:
 
 	void reloadBrush(ID2D1HwndRenderTarget * newTarget);
 
+	/**
+	 * Lays out and draws the text, which is worth it only for text which changes every frame.
+	 */
 	void draw(
 	    const wchar_t * text,
 	    unsigned int length,
 	    D2D1_COLOR_F colour = D2D1::ColorF(D2D1::ColorF::White)
 	);
+
+	/**
+	 * Draws the text with the layout cached for it, which is rebuilt only when the text changes.
+	 */
+	void draw(const HudText & text, D2D1_COLOR_F colour = D2D1::ColorF(D2D1::ColorF::White));
+
+	/**
+	 * @return how many times a layout has been built for a HUD text
+	 */
+	[[nodiscard]] unsigned long long getLayoutCount() const;
 };
@@ -0,0 +1,102 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+	unsigned int sharedThreadCount = 0;
+	bool sharedStarted = false;
+} // namespace
+
+ThreadPool::ThreadPool(unsigned int workerCount) {
+	workers.reserve(workerCount);
+	for (unsigned int worker = 0; worker < workerCount; worker++) {
+		workers.emplace_back(&ThreadPool::work, this);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (auto & worker : workers) {
+		worker.join();
+	}
+}
+
+size_t ThreadPool::getThreadCount() const {
+	return workers.size() + 1;
+}
+
+void ThreadPool::work() {
+	unsigned long long seenGeneration = 0;
+	while (true) {
+		{
+			std::unique_lock lock(mutex);
+			wake.wait(lock, [&] {
+				return stopping || generation != seenGeneration;
+			});
+			if (stopping) {
+				return;
+			}
+			seenGeneration = generation;
+		}
+		runChunks();
+	}
+}
+
+void ThreadPool::runChunks() {
+	while (true) {
+		size_t chunk{};
+		{
+			std::lock_guard lock(mutex);
+			if (nextChunk == chunkCount) {
+				return;
+			}
+			chunk = nextChunk++;
+		}
+		invoke(context, chunk);
+		{
+			std::lock_guard lock(mutex);
+			if (--unfinishedChunks == 0) {
+				done.notify_all();
+			}
+		}
+	}
+}
+
+void ThreadPool::run(size_t chunks, Invoke function, void * functionContext) {
+	{
+		std::lock_guard lock(mutex);
+		invoke = function;
+		context = functionContext;
+		chunkCount = chunks;
+		nextChunk = 0;
+		unfinishedChunks = chunks;
+		generation++;
+	}
+	wake.notify_all();
+
+	runChunks();
+
+	std::unique_lock lock(mutex);
+	done.wait(lock, [&] {
+		return unfinishedChunks == 0;
+	});
+}
+
+ThreadPool & ThreadPool::shared() {
+	sharedStarted = true;
+	unsigned int threadCount = sharedThreadCount ? sharedThreadCount : std::thread::hardware_concurrency();
+	static ThreadPool pool(std::max<unsigned int>(threadCount, 1) - 1);
+	return pool;
+}
+
+void ThreadPool::setSharedThreadCount(unsigned int threadCount) {
+	if (sharedStarted) {
+		throw std::runtime_error("The shared thread pool is already running.");
+	}
+	sharedThreadCount = threadCount;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * A fixed set of worker threads splitting loops between themselves and the calling thread.
+ * Only one loop runs at a time, and it is only ever started from one thread.
+ */
+class ThreadPool {
+	using Invoke = void (*)(void * context, size_t chunk);
+
+	std::vector<std::thread> workers{};
+
+	std::mutex mutex{};
+	std::condition_variable wake{};
+	std::condition_variable done{};
+
+	// The loop being run, split into chunks which are handed out in order.
+	Invoke invoke{};
+	void * context{};
+	size_t chunkCount{};
+	size_t nextChunk{};
+	size_t unfinishedChunks{};
+	unsigned long long generation{};
+	bool stopping{};
+
+	void work();
+
+	void runChunks();
+
+	void run(size_t chunks, Invoke function, void * functionContext);
+
+public:
+	/**
+	 * @param workerCount the number of threads started besides the calling one
+	 */
+	explicit ThreadPool(unsigned int workerCount);
+
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool &) = delete;
+
+	ThreadPool & operator=(const ThreadPool &) = delete;
+
+	/**
+	 * @return the number of threads running loops, including the calling one
+	 */
+	[[nodiscard]] size_t getThreadCount() const;
+
+	/**
+	 * Calls body(begin, end) for consecutive ranges covering [0, count), in parallel, and waits for all of them.
+	 * @param minRange the smallest range worth handing to another thread
+	 */
+	template <typename Body>
+	void parallelFor(size_t count, size_t minRange, Body && body);
+
+	/**
+	 * @return a pool with a thread for every hardware thread, or as many as set, started on first use
+	 */
+	static ThreadPool & shared();
+
+	/**
+	 * Sets the number of threads of the shared pool, including the calling one, before its first use.
+	 * @param threadCount the number of threads, or 0 for a thread for every hardware thread
+	 * @throws std::runtime_error if the shared pool is already running
+	 */
+	static void setSharedThreadCount(unsigned int threadCount);
+};
+
+template <typename Body>
+void ThreadPool::parallelFor(size_t count, size_t minRange, Body && body) {
+	// A few chunks per thread even out threads which get less time.
+	size_t range = std::max<size_t>(minRange, 1);
+	size_t chunks = std::min<size_t>(getThreadCount() * 4, (count + range - 1) / range);
+	if (chunks <= 1) {
+		body(size_t(0), count);
+		return;
+	}
+
+	struct Loop {
+		Body & body;
+		size_t count;
+		size_t chunks;
+	} loop{body, count, chunks};
+	run(
+	    chunks,
+	    [](void * loopContext, size_t chunk) {
+		    auto & [loopBody, loopCount, loopChunks] = *static_cast<Loop *>(loopContext);
+		    loopBody(loopCount * chunk / loopChunks, loopCount * (chunk + 1) / loopChunks);
+	    },
+	    &loop
+	);
+}